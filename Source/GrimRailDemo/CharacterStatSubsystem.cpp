@@ -0,0 +1,372 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CharacterStatSubsystem.h"
+#include "GrimRailTickScheduler.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+void UCharacterStatSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// run as a tick scheduler job instead of ticking on our own
+	if (UGrimRailTickScheduler* Scheduler = Collection.InitializeDependency<UGrimRailTickScheduler>())
+	{
+		JobID = Scheduler->RegisterJob(TEXT("CharacterStats"), this, this, EGrimRailJobData::None, EGrimRailJobData::Stamina);
+	}
+}
+
+void UCharacterStatSubsystem::Deinitialize()
+{
+	if (UGrimRailTickScheduler* Scheduler = GetWorld()->GetSubsystem<UGrimRailTickScheduler>())
+	{
+		Scheduler->UnregisterJob(JobID);
+	}
+
+	JobID = INDEX_NONE;
+
+	Super::Deinitialize();
+}
+
+bool UCharacterStatSubsystem::GatherJob(float DeltaTime)
+{
+	JobEntries.Reset();
+
+	if (StaminaStates.Num() == 0)
+	{
+		return false;
+	}
+
+	JobDeltaTime = DeltaTime;
+	JobEntries.Reserve(StaminaStates.Num());
+
+	for (int32 Index = 0; Index < StaminaStates.Num(); ++Index)
+	{
+		FStaminaJobEntry& Entry = JobEntries.AddDefaulted_GetRef();
+		Entry.ID = StaminaOwners[Index].ID;
+		Entry.State = StaminaStates[Index];
+
+		// only sprinting characters need their velocity checked
+		if (Entry.State.bWantsToSprint && !Entry.State.bRecovering)
+		{
+			const UCharacterMovementComponent* Movement = StaminaOwners[Index].Movement.Get();
+			Entry.bDraining = Movement && Movement->Velocity.SizeSquared() > Entry.State.WalkSpeedSquared;
+		}
+	}
+
+	return true;
+}
+
+void UCharacterStatSubsystem::PrepareJob()
+{
+	for (FStaminaJobEntry& Entry : JobEntries)
+	{
+		FStaminaState& State = Entry.State;
+
+		if (Entry.bDraining)
+		{
+			// burn stamina
+			State.Stamina = FMath::Max(State.Stamina - JobDeltaTime, 0.0f);
+
+			// have we run out? Characters without a meter sprint freely
+			if (State.Stamina <= 0.0f && State.MaxStamina > 0.0f)
+			{
+				State.bRecovering = true;
+				Entry.bStartedRecovering = true;
+			}
+
+		} else {
+
+			// recover stamina
+			State.Stamina = FMath::Min(State.Stamina + JobDeltaTime * State.RecoveryRate, State.MaxStamina);
+
+			// have we just finished recovering?
+			if (State.bRecovering && State.Stamina >= State.MaxStamina)
+			{
+				State.bRecovering = false;
+				Entry.bFinishedRecovering = true;
+			}
+		}
+
+		// report the meter when it moved by a visible amount, or reached either end
+		const float Percent = State.MaxStamina > 0.0f ? State.Stamina / State.MaxStamina : 1.0f;
+
+		if (Percent != State.LastReportedPercent
+			&& (FMath::Abs(Percent - State.LastReportedPercent) >= MeterResolution || Percent <= 0.0f || Percent >= 1.0f))
+		{
+			State.LastReportedPercent = Percent;
+			Entry.bMeterChanged = true;
+		}
+	}
+}
+
+void UCharacterStatSubsystem::CommitJob()
+{
+	for (const FStaminaJobEntry& Entry : JobEntries)
+	{
+		// characters may have been unregistered since the gather
+		const int32* Index = StaminaIndexByID.Find(Entry.ID);
+
+		if (!Index)
+		{
+			continue;
+		}
+
+		// only write back what the job owns, sprint input may have changed in the meantime
+		FStaminaState& State = StaminaStates[*Index];
+		State.Stamina = Entry.State.Stamina;
+		State.bRecovering = Entry.State.bRecovering;
+		State.LastReportedPercent = Entry.State.LastReportedPercent;
+
+		if (Entry.bStartedRecovering)
+		{
+			SetSpeedMode(*Index, ESpeedMode::Recovering);
+
+		} else if (Entry.bFinishedRecovering) {
+
+			SetSpeedMode(*Index, State.bWantsToSprint ? ESpeedMode::Sprint : ESpeedMode::Walk);
+		}
+
+		if (Entry.bMeterChanged)
+		{
+			PendingEvents.Add({ Entry.ID, false, State.LastReportedPercent });
+		}
+	}
+
+	JobEntries.Reset();
+
+	DispatchPendingEvents();
+}
+
+bool UCharacterStatSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UCharacterStatSubsystem::RegisterStamina(ACharacter* Character, const FStaminaSettings& Settings)
+{
+	if (!Character || !Character->GetCharacterMovement())
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 ID = NextID++;
+
+	FStaminaState& State = StaminaStates.AddDefaulted_GetRef();
+	State.Stamina = Settings.MaxStamina;
+	State.MaxStamina = Settings.MaxStamina;
+	State.RecoveryRate = Settings.RecoveryTime > 0.0f ? Settings.MaxStamina / Settings.RecoveryTime : 1.0f;
+	State.WalkSpeedSquared = FMath::Square(Settings.WalkSpeed);
+
+	FStaminaOwner& Owner = StaminaOwners.AddDefaulted_GetRef();
+	Owner.ID = ID;
+	Owner.Movement = Character->GetCharacterMovement();
+	Owner.Settings = Settings;
+
+	StaminaIndexByID.Add(ID, StaminaStates.Num() - 1);
+
+	// start out walking
+	Character->GetCharacterMovement()->MaxWalkSpeed = Settings.WalkSpeed;
+
+	return ID;
+}
+
+void UCharacterStatSubsystem::UnregisterStamina(int32 StaminaID)
+{
+	int32 Index = INDEX_NONE;
+
+	if (!StaminaIndexByID.RemoveAndCopyValue(StaminaID, Index))
+	{
+		return;
+	}
+
+	// swap the last entry into the hole and fix up its index
+	StaminaStates.RemoveAtSwap(Index, EAllowShrinking::No);
+	StaminaOwners.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	if (StaminaOwners.IsValidIndex(Index))
+	{
+		StaminaIndexByID.Add(StaminaOwners[Index].ID, Index);
+	}
+}
+
+void UCharacterStatSubsystem::SetWantsToSprint(int32 StaminaID, bool bWantsToSprint)
+{
+	const int32* Index = StaminaIndexByID.Find(StaminaID);
+
+	if (!Index)
+	{
+		return;
+	}
+
+	FStaminaState& State = StaminaStates[*Index];
+	State.bWantsToSprint = bWantsToSprint;
+
+	// recovery keeps its own speed until the meter is full again
+	if (!State.bRecovering)
+	{
+		SetSpeedMode(*Index, bWantsToSprint ? ESpeedMode::Sprint : ESpeedMode::Walk);
+		DispatchPendingEvents();
+	}
+}
+
+float UCharacterStatSubsystem::GetStaminaPercent(int32 StaminaID) const
+{
+	if (const int32* Index = StaminaIndexByID.Find(StaminaID))
+	{
+		const FStaminaState& State = StaminaStates[*Index];
+		return State.MaxStamina > 0.0f ? State.Stamina / State.MaxStamina : 1.0f;
+	}
+
+	return 0.0f;
+}
+
+bool UCharacterStatSubsystem::IsRecovering(int32 StaminaID) const
+{
+	const int32* Index = StaminaIndexByID.Find(StaminaID);
+	return Index && StaminaStates[*Index].bRecovering;
+}
+
+int32 UCharacterStatSubsystem::RegisterHealth(float MaxHealth, float StartHealth)
+{
+	const int32 ID = NextID++;
+
+	FHealthState& State = HealthStates.AddDefaulted_GetRef();
+	State.ID = ID;
+	State.Health = StartHealth;
+	State.MaxHealth = MaxHealth;
+
+	HealthIndexByID.Add(ID, HealthStates.Num() - 1);
+
+	return ID;
+}
+
+void UCharacterStatSubsystem::UnregisterHealth(int32 HealthID)
+{
+	int32 Index = INDEX_NONE;
+
+	if (!HealthIndexByID.RemoveAndCopyValue(HealthID, Index))
+	{
+		return;
+	}
+
+	// swap the last entry into the hole and fix up its index
+	HealthStates.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	if (HealthStates.IsValidIndex(Index))
+	{
+		HealthIndexByID.Add(HealthStates[Index].ID, Index);
+	}
+}
+
+float UCharacterStatSubsystem::ApplyDamage(int32 HealthID, float Damage)
+{
+	if (const int32* Index = HealthIndexByID.Find(HealthID))
+	{
+		FHealthState& State = HealthStates[*Index];
+		State.Health -= Damage;
+
+		return State.Health;
+	}
+
+	return 0.0f;
+}
+
+void UCharacterStatSubsystem::SetHealth(int32 HealthID, float NewHealth)
+{
+	if (const int32* Index = HealthIndexByID.Find(HealthID))
+	{
+		HealthStates[*Index].Health = NewHealth;
+	}
+}
+
+float UCharacterStatSubsystem::GetHealth(int32 HealthID) const
+{
+	const int32* Index = HealthIndexByID.Find(HealthID);
+	return Index ? HealthStates[*Index].Health : 0.0f;
+}
+
+float UCharacterStatSubsystem::GetHealthPercent(int32 HealthID) const
+{
+	if (const int32* Index = HealthIndexByID.Find(HealthID))
+	{
+		const FHealthState& State = HealthStates[*Index];
+		return State.MaxHealth > 0.0f ? FMath::Clamp(State.Health / State.MaxHealth, 0.0f, 1.0f) : 0.0f;
+	}
+
+	return 0.0f;
+}
+
+void UCharacterStatSubsystem::SetSpeedMode(int32 Index, ESpeedMode NewMode)
+{
+	FStaminaState& State = StaminaStates[Index];
+
+	if (State.SpeedMode == NewMode)
+	{
+		return;
+	}
+
+	const bool bWasSprinting = State.SpeedMode == ESpeedMode::Sprint;
+	State.SpeedMode = NewMode;
+
+	// this is the only place the movement component is touched
+	const FStaminaOwner& Owner = StaminaOwners[Index];
+
+	if (UCharacterMovementComponent* Movement = Owner.Movement.Get())
+	{
+		switch (NewMode)
+		{
+		case ESpeedMode::Walk:
+			Movement->MaxWalkSpeed = Owner.Settings.WalkSpeed;
+			break;
+
+		case ESpeedMode::Sprint:
+			Movement->MaxWalkSpeed = Owner.Settings.SprintSpeed;
+			break;
+
+		case ESpeedMode::Recovering:
+			Movement->MaxWalkSpeed = Owner.Settings.RecoveringWalkSpeed;
+			break;
+		}
+	}
+
+	const bool bSprinting = NewMode == ESpeedMode::Sprint;
+
+	if (bSprinting != bWasSprinting)
+	{
+		PendingEvents.Add({ Owner.ID, true, 0.0f });
+	}
+}
+
+void UCharacterStatSubsystem::DispatchPendingEvents()
+{
+	if (PendingEvents.Num() == 0)
+	{
+		return;
+	}
+
+	// callbacks may register or unregister characters, so look each one up again
+	TArray<FPendingStaminaEvent> Events = MoveTemp(PendingEvents);
+	PendingEvents.Reset();
+
+	for (const FPendingStaminaEvent& Event : Events)
+	{
+		const int32* Index = StaminaIndexByID.Find(Event.ID);
+
+		if (!Index)
+		{
+			continue;
+		}
+
+		const FStaminaSettings& Settings = StaminaOwners[*Index].Settings;
+
+		if (Event.bSprintState)
+		{
+			Settings.OnSprintStateChanged.ExecuteIfBound(StaminaStates[*Index].SpeedMode == ESpeedMode::Sprint);
+
+		} else {
+
+			Settings.OnMeterChanged.ExecuteIfBound(Event.Value);
+		}
+	}
+}
@@ -0,0 +1,208 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GrimRailTickScheduler.h"
+#include "CharacterStatSubsystem.generated.h"
+
+class ACharacter;
+class UCharacterMovementComponent;
+
+DECLARE_DELEGATE_OneParam(FStaminaMeterChangedDelegate, float /*Percent*/);
+DECLARE_DELEGATE_OneParam(FStaminaSprintStateChangedDelegate, bool /*bSprinting*/);
+
+/** Stamina tuning and callbacks for a character registered with the stat subsystem */
+struct FStaminaSettings
+{
+	/** How long the character can sprint for, in seconds */
+	float MaxStamina = 3.0f;
+
+	/** Time to refill an empty meter. Zero recovers one second of stamina per second */
+	float RecoveryTime = 0.0f;
+
+	/** Max walk speed when not sprinting or recovering */
+	float WalkSpeed = 250.0f;
+
+	/** Max walk speed while sprinting */
+	float SprintSpeed = 600.0f;
+
+	/** Max walk speed while recovering */
+	float RecoveringWalkSpeed = 150.0f;
+
+	/** Called when the meter changes by a visible amount */
+	FStaminaMeterChangedDelegate OnMeterChanged;
+
+	/** Called when the character starts or stops sprinting */
+	FStaminaSprintStateChangedDelegate OnSprintStateChanged;
+};
+
+/**
+ *  Updates character stats for every registered pawn in a single tick
+ *  Stamina lives in packed arrays and is updated as a tick scheduler job: a copy is drained and recovered on a
+ *  worker thread, then written back on the game thread. Movement speeds are only written when a character crosses from walking
+ *  to sprinting or recovering and back, and callbacks only fire for actual changes.
+ *  Also holds health, which only changes through damage and doesn't tick
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UCharacterStatSubsystem : public UWorldSubsystem, public IGrimRailJob
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Smallest stamina meter change, as a fraction of the meter, that is reported to listeners */
+	UPROPERTY(Config, EditAnywhere, Category="Stamina", meta = (ClampMin = 0, ClampMax = 1))
+	float MeterResolution = 0.01f;
+
+	/** Movement speed a character is currently set to */
+	enum class ESpeedMode : uint8
+	{
+		Walk,
+		Sprint,
+		Recovering
+	};
+
+	/** Stamina values read and written every tick */
+	struct FStaminaState
+	{
+		float Stamina = 0.0f;
+		float MaxStamina = 0.0f;
+		float RecoveryRate = 1.0f;
+		float WalkSpeedSquared = 0.0f;
+		float LastReportedPercent = -1.0f;
+		ESpeedMode SpeedMode = ESpeedMode::Walk;
+		bool bWantsToSprint = false;
+		bool bRecovering = false;
+	};
+
+	/** Stamina values only needed on state changes */
+	struct FStaminaOwner
+	{
+		int32 ID = INDEX_NONE;
+		TWeakObjectPtr<UCharacterMovementComponent> Movement;
+		FStaminaSettings Settings;
+	};
+
+	/** Health of a registered character */
+	struct FHealthState
+	{
+		int32 ID = INDEX_NONE;
+		float Health = 0.0f;
+		float MaxHealth = 0.0f;
+	};
+
+	/** Callback raised during the stamina update, dispatched once the update is done */
+	struct FPendingStaminaEvent
+	{
+		int32 ID;
+		bool bSprintState;
+		float Value;
+	};
+
+	/** Hot and cold stamina data, kept in the same order */
+	TArray<FStaminaState> StaminaStates;
+	TArray<FStaminaOwner> StaminaOwners;
+
+	/** Registered health values */
+	TArray<FHealthState> HealthStates;
+
+	/** Array index by registration ID */
+	TMap<int32, int32> StaminaIndexByID;
+	TMap<int32, int32> HealthIndexByID;
+
+	/** Copy of a character's stamina updated by the job, and what changed */
+	struct FStaminaJobEntry
+	{
+		int32 ID = INDEX_NONE;
+		FStaminaState State;
+		bool bDraining = false;
+		bool bStartedRecovering = false;
+		bool bFinishedRecovering = false;
+		bool bMeterChanged = false;
+	};
+
+	/** Events collected during the current update */
+	TArray<FPendingStaminaEvent> PendingEvents;
+
+	/** Stamina copied out for the job this frame */
+	TArray<FStaminaJobEntry> JobEntries;
+
+	/** Frame time the job runs with */
+	float JobDeltaTime = 0.0f;
+
+	/** Next registration ID */
+	int32 NextID = 0;
+
+	/** Tick scheduler job running the stamina update */
+	int32 JobID = INDEX_NONE;
+
+public:
+
+	//~Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem Interface
+
+	//~Begin IGrimRailJob Interface
+	virtual bool GatherJob(float DeltaTime) override;
+	virtual void PrepareJob() override;
+	virtual void CommitJob() override;
+	//~End IGrimRailJob Interface
+
+	/**
+	 * Registers a character for stamina updates. The meter starts full
+	 * @param Character Character whose movement speed is driven by its stamina
+	 * @param Settings Tuning and callbacks
+	 * @return ID used to refer to the character's stamina, or INDEX_NONE if the character can't be registered
+	 */
+	int32 RegisterStamina(ACharacter* Character, const FStaminaSettings& Settings);
+
+	/** Stops updating a character's stamina */
+	void UnregisterStamina(int32 StaminaID);
+
+	/** Sets whether the character wants to sprint. Takes effect right away unless the character is recovering */
+	void SetWantsToSprint(int32 StaminaID, bool bWantsToSprint);
+
+	/** Returns the stamina meter, from 0 to 1 */
+	float GetStaminaPercent(int32 StaminaID) const;
+
+	/** Returns true while the character is recovering from running out of stamina */
+	bool IsRecovering(int32 StaminaID) const;
+
+	/** Registers a health value. Returns the ID used to refer to it */
+	int32 RegisterHealth(float MaxHealth, float StartHealth);
+
+	/** Forgets a health value */
+	void UnregisterHealth(int32 HealthID);
+
+	/**
+	 * Applies damage to a health value
+	 * @param HealthID ID returned by RegisterHealth
+	 * @param Damage Amount of health to remove
+	 * @return The remaining health, which may be negative
+	 */
+	float ApplyDamage(int32 HealthID, float Damage);
+
+	/** Overrides a health value, e.g. when it's replicated from the server or a character respawns */
+	void SetHealth(int32 HealthID, float NewHealth);
+
+	/** Returns the current health */
+	float GetHealth(int32 HealthID) const;
+
+	/** Returns the current health as a fraction of the max health, from 0 to 1 */
+	float GetHealthPercent(int32 HealthID) const;
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem Interface
+
+	/** Moves the character to a new speed mode and writes its max walk speed */
+	void SetSpeedMode(int32 Index, ESpeedMode NewMode);
+
+	/** Calls the callbacks for the events collected during the update */
+	void DispatchPendingEvents();
+};
@@ -0,0 +1,179 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ClueGraph.h"
+#include "GrimRailDemo.h"
+
+void FClueGraph::Build(const UClueGraphAsset* Asset)
+{
+	Objectives.Reset();
+	Nodes.Reset();
+	NodeIndexByID.Reset();
+
+	if (!Asset)
+	{
+		return;
+	}
+
+	Objectives = Asset->Objectives;
+
+	// objective nodes first, so requirements can tell objectives from entries
+	for (int32 ObjectiveIndex = 0; ObjectiveIndex < Objectives.Num(); ++ObjectiveIndex)
+	{
+		const FName ObjectiveID = Objectives[ObjectiveIndex].ObjectiveID;
+
+		if (ObjectiveID.IsNone() || NodeIndexByID.Contains(ObjectiveID))
+		{
+			UE_LOG(LogGrimRailDemo, Warning, TEXT("ClueGraph: '%s' has a missing or duplicate objective ID '%s'"), *Asset->GetName(), *ObjectiveID.ToString());
+			continue;
+		}
+
+		const int32 Node = Nodes.AddDefaulted();
+		Nodes[Node].ObjectiveIndex = ObjectiveIndex;
+		NodeIndexByID.Add(ObjectiveID, Node);
+	}
+
+	// link every requirement to the objective that depends on it
+	for (int32 ObjectiveIndex = 0; ObjectiveIndex < Objectives.Num(); ++ObjectiveIndex)
+	{
+		const FClueObjective& Objective = Objectives[ObjectiveIndex];
+		const int32* Node = NodeIndexByID.Find(Objective.ObjectiveID);
+
+		if (!Node || Nodes[*Node].ObjectiveIndex != ObjectiveIndex)
+		{
+			continue;
+		}
+
+		for (const FName& Requirement : Objective.Requirements)
+		{
+			const int32 RequirementNode = FindOrAddNode(Requirement);
+			Nodes[RequirementNode].Dependents.Add(*Node);
+		}
+
+		// Any only needs one requirement, and an objective with no requirements unlocks right away
+		Nodes[*Node].NumRequired = Objective.Mode == EClueConditionMode::All ? Objective.Requirements.Num() : FMath::Min(1, Objective.Requirements.Num());
+	}
+
+	WarnAboutCycles();
+}
+
+void FClueGraph::Reset(TArray<const FClueObjective*>& OutUnlocked)
+{
+	for (FNode& Node : Nodes)
+	{
+		Node.NumSatisfied = 0;
+		Node.bSatisfied = false;
+	}
+
+	for (int32 Node = 0; Node < Nodes.Num(); ++Node)
+	{
+		if (Nodes[Node].ObjectiveIndex != INDEX_NONE && Nodes[Node].NumRequired == 0 && !Nodes[Node].bSatisfied)
+		{
+			Propagate(Node, OutUnlocked);
+		}
+	}
+}
+
+void FClueGraph::SatisfyEntry(FName EntryID, TArray<const FClueObjective*>& OutUnlocked)
+{
+	const int32* Node = NodeIndexByID.Find(EntryID);
+
+	// entries nothing depends on aren't in the graph
+	if (!Node || Nodes[*Node].ObjectiveIndex != INDEX_NONE || Nodes[*Node].bSatisfied)
+	{
+		return;
+	}
+
+	Propagate(*Node, OutUnlocked);
+}
+
+bool FClueGraph::IsObjectiveUnlocked(FName ObjectiveID) const
+{
+	const int32* Node = NodeIndexByID.Find(ObjectiveID);
+	return Node && Nodes[*Node].ObjectiveIndex != INDEX_NONE && Nodes[*Node].bSatisfied;
+}
+
+int32 FClueGraph::FindOrAddNode(FName ID)
+{
+	if (const int32* Node = NodeIndexByID.Find(ID))
+	{
+		return *Node;
+	}
+
+	const int32 Node = Nodes.AddDefaulted();
+	NodeIndexByID.Add(ID, Node);
+	return Node;
+}
+
+void FClueGraph::Propagate(int32 StartNode, TArray<const FClueObjective*>& OutUnlocked)
+{
+	// breadth first, so objectives unlock after everything they depend on
+	TArray<int32, TInlineAllocator<16>> Queue;
+	Nodes[StartNode].bSatisfied = true;
+	Queue.Add(StartNode);
+
+	for (int32 QueueIndex = 0; QueueIndex < Queue.Num(); ++QueueIndex)
+	{
+		const FNode& Node = Nodes[Queue[QueueIndex]];
+
+		if (Node.ObjectiveIndex != INDEX_NONE)
+		{
+			OutUnlocked.Add(&Objectives[Node.ObjectiveIndex]);
+		}
+
+		// only the dependents of a newly satisfied node can change
+		for (const int32 Dependent : Node.Dependents)
+		{
+			FNode& DependentNode = Nodes[Dependent];
+
+			if (!DependentNode.bSatisfied && ++DependentNode.NumSatisfied >= DependentNode.NumRequired)
+			{
+				DependentNode.bSatisfied = true;
+				Queue.Add(Dependent);
+			}
+		}
+	}
+}
+
+void FClueGraph::WarnAboutCycles() const
+{
+	// peel off nodes with no unresolved requirements. Objectives left over are in or behind a cycle
+	TArray<int32> RemainingRequirements;
+	RemainingRequirements.SetNumZeroed(Nodes.Num());
+
+	for (const FNode& Node : Nodes)
+	{
+		for (const int32 Dependent : Node.Dependents)
+		{
+			++RemainingRequirements[Dependent];
+		}
+	}
+
+	TArray<int32> Queue;
+	for (int32 Node = 0; Node < Nodes.Num(); ++Node)
+	{
+		if (RemainingRequirements[Node] == 0)
+		{
+			Queue.Add(Node);
+		}
+	}
+
+	for (int32 QueueIndex = 0; QueueIndex < Queue.Num(); ++QueueIndex)
+	{
+		for (const int32 Dependent : Nodes[Queue[QueueIndex]].Dependents)
+		{
+			if (--RemainingRequirements[Dependent] == 0)
+			{
+				Queue.Add(Dependent);
+			}
+		}
+	}
+
+	// an All objective in a cycle can never unlock, an Any objective needs a requirement from outside the cycle
+	for (int32 Node = 0; Node < Nodes.Num(); ++Node)
+	{
+		if (RemainingRequirements[Node] > 0)
+		{
+			UE_LOG(LogGrimRailDemo, Warning, TEXT("ClueGraph: Objective '%s' is part of or depends on a requirement cycle"), *Objectives[Nodes[Node].ObjectiveIndex].ObjectiveID.ToString());
+		}
+	}
+}
@@ -0,0 +1,121 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ClueGraph.generated.h"
+
+/** How an objective combines its requirements */
+UENUM(BlueprintType)
+enum class EClueConditionMode : uint8
+{
+	All				UMETA(DisplayName = "All Of"),
+	Any				UMETA(DisplayName = "Any Of")
+};
+
+/** An objective unlocked by a combination of notebook entries and other objectives */
+USTRUCT(BlueprintType)
+struct FClueObjective
+{
+	GENERATED_BODY()
+
+	/** Unique identifier for this objective. Must not clash with a notebook entry ID */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Clues")
+	FName ObjectiveID;
+
+	/** Notebook entry or objective IDs this objective depends on */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Clues")
+	TArray<FName> Requirements;
+
+	/** Whether all requirements or any one of them must be met. Nest objectives to build mixed expressions */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Clues")
+	EClueConditionMode Mode = EClueConditionMode::All;
+
+	/** Optional notebook registry entry added when the objective unlocks */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Clues")
+	FName GrantedEntryID;
+};
+
+/**
+ * Designer authored set of clue objectives
+ */
+UCLASS(BlueprintType)
+class GRIMRAILDEMO_API UClueGraphAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** All objectives in this graph */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Clues")
+	TArray<FClueObjective> Objectives;
+};
+
+/**
+ * Runtime form of a clue graph
+ * Every node keeps a count of its satisfied requirements, so satisfying a node only visits the nodes that depend on it.
+ * Nodes only ever go from unsatisfied to satisfied, until the graph is reset
+ */
+class GRIMRAILDEMO_API FClueGraph
+{
+public:
+
+	/** Builds the graph from an asset. Call Reset before use */
+	void Build(const UClueGraphAsset* Asset);
+
+	/** Returns true if the graph has any objectives */
+	bool IsEmpty() const { return Objectives.IsEmpty(); }
+
+	/** Marks every node unsatisfied again. Objectives with no requirements are unlocked and returned */
+	void Reset(TArray<const FClueObjective*>& OutUnlocked);
+
+	/**
+	 * Marks a notebook entry as collected and propagates to the nodes that depend on it
+	 * @param EntryID The collected entry
+	 * @param OutUnlocked Objectives unlocked as a result, in dependency order
+	 */
+	void SatisfyEntry(FName EntryID, TArray<const FClueObjective*>& OutUnlocked);
+
+	/** Returns true if the objective has been unlocked */
+	bool IsObjectiveUnlocked(FName ObjectiveID) const;
+
+private:
+
+	/** A notebook entry or objective */
+	struct FNode
+	{
+		/** Nodes that list this node as a requirement */
+		TArray<int32> Dependents;
+
+		/** Index into Objectives, or INDEX_NONE for notebook entries */
+		int32 ObjectiveIndex = INDEX_NONE;
+
+		/** Number of satisfied requirements needed to satisfy this node */
+		int32 NumRequired = 0;
+
+		/** Number of requirements satisfied so far */
+		int32 NumSatisfied = 0;
+
+		/** True once the node is satisfied */
+		bool bSatisfied = false;
+	};
+
+	/** Objectives copied from the asset */
+	TArray<FClueObjective> Objectives;
+
+	/** All nodes */
+	TArray<FNode> Nodes;
+
+	/** Node index by entry or objective ID */
+	TMap<FName, int32> NodeIndexByID;
+
+	/** Returns the node for an ID, adding an entry node if needed */
+	int32 FindOrAddNode(FName ID);
+
+	/** Satisfies a node and everything that becomes satisfied because of it */
+	void Propagate(int32 StartNode, TArray<const FClueObjective*>& OutUnlocked);
+
+	/** Logs the objectives that are part of a dependency cycle */
+	void WarnAboutCycles() const;
+};
@@ -6,10 +6,16 @@
 #include "GameFramework/PlayerController.h"
 #include "GameFramework/Pawn.h"
 #include "TimerManager.h"
+#include "GrimRailSaveSubsystem.h"
+#include "NotebookContentSubsystem.h"
+#include "InteractionSubsystem.h"
+#include "GrimRailSignificanceSubsystem.h"
+#include "CollectibleAnimationSubsystem.h"
 
 ACollectibleActor::ACollectibleActor()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// The animation runs from the collectible animation subsystem
+	PrimaryActorTick.bCanEverTick = false;
 
 	// Create root scene component
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
@@ -30,7 +36,6 @@ ACollectibleActor::ACollectibleActor()
 	// Default values
 	bHasBeenCollected = false;
 	InteractionPromptText = FText::FromString(TEXT("Pick Up"));
-	FocusingPlayerController = nullptr;
 }
 
 void ACollectibleActor::BeginPlay()
@@ -40,26 +45,70 @@ void ACollectibleActor::BeginPlay()
 	// Store initial Z position for floating animation
 	InitialZPosition = GetActorLocation().Z;
 
-	// Validate notebook entry
-	if (NotebookEntry.EntryID.IsNone())
+#if !UE_BUILD_SHIPPING
+	// Validate notebook entry. The entry itself is only resolved when collected
+	if (!RegistryEntryID.IsNone())
+	{
+		UNotebookContentSubsystem* ContentSubsystem = UNotebookContentSubsystem::Get(this);
+		if (!ContentSubsystem || !ContentSubsystem->FindDefinition(RegistryEntryID))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("CollectibleActor '%s' references unregistered entry '%s'!"), *GetName(), *RegistryEntryID.ToString());
+		}
+	}
+	else if (NotebookEntry.EntryID.IsNone())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("CollectibleActor '%s' has no EntryID set!"), *GetName());
 	}
+#endif
+
+	// Register for interaction focus scoring
+	if (UInteractionSubsystem* InteractionSubsystem = GetWorld()->GetSubsystem<UInteractionSubsystem>())
+	{
+		InteractionSubsystem->RegisterInteractable(this, InteractionPriority);
+	}
+
+	// Restore the collected state from earlier sessions
+	UGrimRailSaveSubsystem* SaveSubsystem = UGrimRailSaveSubsystem::Get(this);
+	if (SaveSubsystem && SaveSubsystem->IsCollected(this))
+	{
+		bHasBeenCollected = true;
+
+		if (bDestroyOnCollect)
+		{
+			Destroy();
+			return;
+		}
+	}
+
+	// Only animate while near and visible to a player
+	if (UGrimRailSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UGrimRailSignificanceSubsystem>())
+	{
+		Significance->RegisterActor(this, TEXT("Collectible"), true, FGrimRailTickStateDelegate::CreateUObject(this, &ACollectibleActor::SetAnimating));
+	}
+
+	UpdateTickWork();
 }
 
-void ACollectibleActor::Tick(float DeltaTime)
+void ACollectibleActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
+	if (UInteractionSubsystem* InteractionSubsystem = GetWorld()->GetSubsystem<UInteractionSubsystem>())
+	{
+		InteractionSubsystem->UnregisterInteractable(this);
+	}
 
-	if (!bHasBeenCollected)
+	if (UGrimRailSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UGrimRailSignificanceSubsystem>())
 	{
-		UpdateVisualEffects(DeltaTime);
+		Significance->UnregisterActor(this);
 	}
+
+	SetAnimating(false);
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ACollectibleActor::OnInteractionFocus_Implementation(APlayerController* PlayerController)
 {
-	FocusingPlayerController = PlayerController;
+	FocusingPlayerControllers.AddUnique(PlayerController);
 
 	// Call Blueprint event
 	BP_OnFocusGained(PlayerController);
@@ -69,7 +118,7 @@ void ACollectibleActor::OnInteractionFocus_Implementation(APlayerController* Pla
 
 void ACollectibleActor::OnInteractionFocusLost_Implementation(APlayerController* PlayerController)
 {
-	FocusingPlayerController = nullptr;
+	FocusingPlayerControllers.Remove(PlayerController);
 
 	// Call Blueprint event
 	BP_OnFocusLost(PlayerController);
@@ -110,6 +159,29 @@ bool ACollectibleActor::CanInteract_Implementation(APlayerController* PlayerCont
 	return true;
 }
 
+bool ACollectibleActor::GetCollectedEntry(FNotebookEntry& OutEntry) const
+{
+	// Registry entries keep the text and content out of the level
+	if (!RegistryEntryID.IsNone())
+	{
+		UNotebookContentSubsystem* ContentSubsystem = UNotebookContentSubsystem::Get(this);
+		return ContentSubsystem && ContentSubsystem->MakeNotebookEntry(RegistryEntryID, OutEntry);
+	}
+
+	OutEntry = NotebookEntry;
+	return !OutEntry.EntryID.IsNone();
+}
+
+const FNotebookEntry* ACollectibleActor::GetInlineEntry() const
+{
+	if (!RegistryEntryID.IsNone() || NotebookEntry.EntryID.IsNone())
+	{
+		return nullptr;
+	}
+
+	return &NotebookEntry;
+}
+
 void ACollectibleActor::PerformCollection(APlayerController* Collector)
 {
 	if (!Collector)
@@ -133,18 +205,34 @@ void ACollectibleActor::PerformCollection(APlayerController* Collector)
 	}
 
 	// Validate entry data before adding
-	if (NotebookEntry.EntryID.IsNone())
+	FNotebookEntry CollectedEntry;
+	if (!GetCollectedEntry(CollectedEntry))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("CollectibleActor '%s': NotebookEntry has no EntryID! Cannot collect."), *GetName());
+		UE_LOG(LogTemp, Warning, TEXT("CollectibleActor '%s': No valid notebook entry! Cannot collect."), *GetName());
 		return;
 	}
 
 	// Add the entry to the notebook
-	if (NotebookComponent->AddEntry(NotebookEntry))
+	if (NotebookComponent->AddEntry(CollectedEntry))
 	{
 		// Mark as collected
 		bHasBeenCollected = true;
 
+		// Persist the collected state
+		if (UGrimRailSaveSubsystem* SaveSubsystem = UGrimRailSaveSubsystem::Get(this))
+		{
+			SaveSubsystem->RecordCollected(this);
+		}
+
+		// Let focus checks know this may no longer be interactable
+		if (UInteractionSubsystem* InteractionSubsystem = GetWorld()->GetSubsystem<UInteractionSubsystem>())
+		{
+			InteractionSubsystem->NotifyInteractableChanged(this);
+		}
+
+		// Collected items stop animating
+		UpdateTickWork();
+
 		// Call Blueprint event
 		BP_OnCollected(Collector);
 
@@ -171,24 +259,36 @@ void ACollectibleActor::PerformCollection(APlayerController* Collector)
 	}
 }
 
-void ACollectibleActor::UpdateVisualEffects(float DeltaTime)
+void ACollectibleActor::GetAnimationState(FCollectibleAnimationState& OutState) const
+{
+	OutState.Location = GetActorLocation();
+	OutState.Rotation = GetActorRotation();
+	OutState.InitialZPosition = InitialZPosition;
+	OutState.FloatingSpeed = FloatingSpeed;
+	OutState.FloatingAmplitude = FloatingAmplitude;
+	OutState.RotationSpeed = RotationSpeed;
+	OutState.bFloating = bEnableFloating;
+	OutState.bRotating = bEnableRotation;
+}
+
+void ACollectibleActor::UpdateTickWork()
 {
-	FVector NewLocation = GetActorLocation();
-	FRotator NewRotation = GetActorRotation();
+	const bool bHasWork = !bHasBeenCollected && (bEnableFloating || bEnableRotation);
 
-	// Floating animation
-	if (bEnableFloating)
+	if (UGrimRailSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UGrimRailSignificanceSubsystem>())
 	{
-		const float Time = GetWorld()->GetTimeSeconds();
-		const float FloatOffset = FMath::Sin(Time * FloatingSpeed) * FloatingAmplitude;
-		NewLocation.Z = InitialZPosition + FloatOffset;
+		Significance->SetHasWork(this, bHasWork);
 	}
-
-	// Rotation animation
-	if (bEnableRotation)
+	else
 	{
-		NewRotation.Yaw += RotationSpeed * DeltaTime;
+		SetAnimating(bHasWork);
 	}
+}
 
-	SetActorLocationAndRotation(NewLocation, NewRotation);
+void ACollectibleActor::SetAnimating(bool bAnimating)
+{
+	if (UCollectibleAnimationSubsystem* Animation = GetWorld()->GetSubsystem<UCollectibleAnimationSubsystem>())
+	{
+		Animation->SetAnimating(this, bAnimating);
+	}
 }
@@ -10,6 +10,7 @@
 
 class USphereComponent;
 class UStaticMeshComponent;
+struct FCollectibleAnimationState;
 
 /**
  * Base class for collectible items that add entries to the player's notebook
@@ -30,7 +31,11 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
 	TObjectPtr<USphereComponent> InteractionSphere;
 
-	/** The notebook entry this collectible adds when picked up */
+	/** ID of the notebook registry entry this collectible adds when picked up. Preferred over the inline entry */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collectible")
+	FName RegistryEntryID;
+
+	/** Inline notebook entry this collectible adds when picked up, used when no registry entry is set */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collectible")
 	FNotebookEntry NotebookEntry;
 
@@ -38,6 +43,10 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collectible")
 	FText InteractionPromptText;
 
+	/** Focus priority over other nearby interactables */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collectible", meta = (ClampMin = 0.1, ClampMax = 10))
+	float InteractionPriority = 1.0f;
+
 	/** Whether this collectible can be picked up multiple times */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collectible")
 	bool bCanBeCollectedMultipleTimes = false;
@@ -77,8 +86,8 @@ protected:
 	/** Starting Z position for floating animation */
 	float InitialZPosition = 0.0f;
 
-	/** Current player controller that is focusing on this collectible */
-	TObjectPtr<APlayerController> FocusingPlayerController;
+	/** Player controllers currently focusing on this collectible, several in splitscreen */
+	TArray<TObjectPtr<APlayerController>> FocusingPlayerControllers;
 
 public:
 
@@ -87,7 +96,7 @@ public:
 protected:
 
 	virtual void BeginPlay() override;
-	virtual void Tick(float DeltaTime) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 
@@ -99,6 +108,12 @@ public:
 	virtual bool CanInteract_Implementation(APlayerController* PlayerController) const override;
 	//~End IInteractable Interface
 
+	/** Copies the current transform and animation settings for the collectible animation subsystem */
+	void GetAnimationState(FCollectibleAnimationState& OutState) const;
+
+	/** Gets the inline notebook entry this collectible holds, or null if it uses the registry */
+	const FNotebookEntry* GetInlineEntry() const;
+
 protected:
 
 	/**
@@ -122,9 +137,15 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent, Category = "Collectible", meta = (DisplayName = "On Focus Lost"))
 	void BP_OnFocusLost(APlayerController* PlayerController);
 
+	/** Gets the notebook entry this collectible adds, from the registry or the inline entry */
+	bool GetCollectedEntry(FNotebookEntry& OutEntry) const;
+
 	/** Performs the collection logic - adds entry to notebook */
 	void PerformCollection(APlayerController* Collector);
 
-	/** Handles visual animations (floating, rotation) */
-	void UpdateVisualEffects(float DeltaTime);
+	/** Tells the significance subsystem whether there is anything left to animate */
+	void UpdateTickWork();
+
+	/** Starts or stops the floating and rotation animation */
+	void SetAnimating(bool bAnimating);
 };
@@ -0,0 +1,131 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CollectibleAnimationSubsystem.h"
+#include "CollectibleActor.h"
+#include "Engine/World.h"
+
+void UCollectibleAnimationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// run as a tick scheduler job instead of ticking every collectible
+	if (UGrimRailTickScheduler* Scheduler = Collection.InitializeDependency<UGrimRailTickScheduler>())
+	{
+		JobID = Scheduler->RegisterJob(TEXT("CollectibleAnimation"), this, this, EGrimRailJobData::None, EGrimRailJobData::CollectibleTransforms);
+	}
+}
+
+void UCollectibleAnimationSubsystem::Deinitialize()
+{
+	if (UGrimRailTickScheduler* Scheduler = GetWorld()->GetSubsystem<UGrimRailTickScheduler>())
+	{
+		Scheduler->UnregisterJob(JobID);
+	}
+
+	JobID = INDEX_NONE;
+
+	Super::Deinitialize();
+}
+
+bool UCollectibleAnimationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCollectibleAnimationSubsystem::SetAnimating(ACollectibleActor* Collectible, bool bAnimating)
+{
+	if (!Collectible)
+	{
+		return;
+	}
+
+	if (bAnimating)
+	{
+		if (!CollectibleIndex.Contains(Collectible))
+		{
+			CollectibleIndex.Add(Collectible, Collectibles.Add(Collectible));
+		}
+
+		return;
+	}
+
+	int32 Index = INDEX_NONE;
+
+	if (!CollectibleIndex.RemoveAndCopyValue(Collectible, Index))
+	{
+		return;
+	}
+
+	// swap the last collectible into the hole and fix up its index
+	Collectibles.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	if (Collectibles.IsValidIndex(Index))
+	{
+		if (ACollectibleActor* MovedCollectible = Collectibles[Index].Get())
+		{
+			CollectibleIndex.Add(MovedCollectible, Index);
+		}
+	}
+}
+
+bool UCollectibleAnimationSubsystem::GatherJob(float DeltaTime)
+{
+	JobEntries.Reset();
+
+	if (Collectibles.Num() == 0)
+	{
+		return false;
+	}
+
+	JobTime = GetWorld()->GetTimeSeconds();
+	JobDeltaTime = DeltaTime;
+	JobEntries.Reserve(Collectibles.Num());
+
+	for (const TWeakObjectPtr<ACollectibleActor>& CollectiblePtr : Collectibles)
+	{
+		if (const ACollectibleActor* Collectible = CollectiblePtr.Get())
+		{
+			FAnimationJobEntry& Entry = JobEntries.AddDefaulted_GetRef();
+			Entry.Collectible = CollectiblePtr;
+			Collectible->GetAnimationState(Entry.State);
+		}
+	}
+
+	return JobEntries.Num() > 0;
+}
+
+void UCollectibleAnimationSubsystem::PrepareJob()
+{
+	for (FAnimationJobEntry& Entry : JobEntries)
+	{
+		FCollectibleAnimationState& State = Entry.State;
+
+		// floating animation
+		if (State.bFloating)
+		{
+			State.Location.Z = State.InitialZPosition + FMath::Sin(JobTime * State.FloatingSpeed) * State.FloatingAmplitude;
+		}
+
+		// rotation animation
+		if (State.bRotating)
+		{
+			State.Rotation.Yaw += State.RotationSpeed * JobDeltaTime;
+		}
+	}
+}
+
+void UCollectibleAnimationSubsystem::CommitJob()
+{
+	for (const FAnimationJobEntry& Entry : JobEntries)
+	{
+		// skip collectibles that stopped animating since the gather, e.g. because they were collected
+		ACollectibleActor* Collectible = Entry.Collectible.Get();
+
+		if (Collectible && CollectibleIndex.Contains(Collectible))
+		{
+			Collectible->SetActorLocationAndRotation(Entry.State.Location, Entry.State.Rotation);
+		}
+	}
+
+	JobEntries.Reset();
+}
@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GrimRailTickScheduler.h"
+#include "CollectibleAnimationSubsystem.generated.h"
+
+class ACollectibleActor;
+
+/** Floating and rotation of a collectible, copied out for the animation job */
+struct FCollectibleAnimationState
+{
+	FVector Location = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+	float InitialZPosition = 0.0f;
+	float FloatingSpeed = 0.0f;
+	float FloatingAmplitude = 0.0f;
+	float RotationSpeed = 0.0f;
+	bool bFloating = false;
+	bool bRotating = false;
+};
+
+/**
+ *  Animates every collectible that is near and visible to a player as one tick scheduler job
+ *  The new transforms are computed on a worker thread from a copy and applied on the game thread
+ */
+UCLASS()
+class GRIMRAILDEMO_API UCollectibleAnimationSubsystem : public UWorldSubsystem, public IGrimRailJob
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** A collectible copied out for the job */
+	struct FAnimationJobEntry
+	{
+		TWeakObjectPtr<ACollectibleActor> Collectible;
+		FCollectibleAnimationState State;
+	};
+
+	/** Collectibles currently animating */
+	TArray<TWeakObjectPtr<ACollectibleActor>> Collectibles;
+
+	/** Index into Collectibles by actor */
+	TMap<TObjectKey<ACollectibleActor>, int32> CollectibleIndex;
+
+	/** Collectibles copied out for the job this frame */
+	TArray<FAnimationJobEntry> JobEntries;
+
+	/** World time and frame time the job runs with */
+	float JobTime = 0.0f;
+	float JobDeltaTime = 0.0f;
+
+	/** Tick scheduler job running the animation */
+	int32 JobID = INDEX_NONE;
+
+public:
+
+	//~Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem Interface
+
+	//~Begin IGrimRailJob Interface
+	virtual bool GatherJob(float DeltaTime) override;
+	virtual void PrepareJob() override;
+	virtual void CommitJob() override;
+	//~End IGrimRailJob Interface
+
+	/** Starts or stops animating a collectible */
+	void SetAnimating(ACollectibleActor* Collectible, bool bAnimating);
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem Interface
+};
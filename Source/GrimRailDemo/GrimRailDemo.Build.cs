@@ -21,7 +21,10 @@ public class GrimRailDemo : ModuleRules
 			"Slate"
 		});
 
-		PrivateDependencyModuleNames.AddRange(new string[] { });
+		PrivateDependencyModuleNames.AddRange(new string[] {
+			"SignificanceManager",
+			"AnimationBudgetAllocator"
+		});
 
 		PublicIncludePaths.AddRange(new string[] {
 			"GrimRailDemo",
@@ -50,7 +50,7 @@ protected:
 	class UInputAction* MouseLookAction;
 	
 public:
-	AGrimRailDemoCharacter();
+	AGrimRailDemoCharacter(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
 protected:
 
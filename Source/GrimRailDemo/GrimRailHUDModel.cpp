@@ -0,0 +1,110 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrimRailHUDModel.h"
+#include "Engine/World.h"
+
+void UGrimRailHUDModel::Tick(float DeltaTime)
+{
+	Flush();
+}
+
+ETickableTickType UGrimRailHUDModel::GetTickableTickType() const
+{
+	// the CDO never ticks, instances only tick while they have pending changes
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UGrimRailHUDModel::IsTickable() const
+{
+	return DirtyFields != EGrimRailHUDField::None;
+}
+
+TStatId UGrimRailHUDModel::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGrimRailHUDModel, STATGROUP_Tickables);
+}
+
+UWorld* UGrimRailHUDModel::GetWorld() const
+{
+	// the model lives under a player controller, so use its world
+	if (const UObject* Outer = GetOuter())
+	{
+		return HasAnyFlags(RF_ClassDefaultObject) ? nullptr : Outer->GetWorld();
+	}
+
+	return nullptr;
+}
+
+void UGrimRailHUDModel::SetSprintPercent(float Percent)
+{
+	MarkChanged(EGrimRailHUDField::SprintPercent, SprintPercent != Percent);
+	SprintPercent = Percent;
+}
+
+void UGrimRailHUDModel::SetSprinting(bool bInSprinting)
+{
+	MarkChanged(EGrimRailHUDField::Sprinting, bSprinting != bInSprinting);
+	bSprinting = bInSprinting;
+}
+
+void UGrimRailHUDModel::SetAmmo(int32 InMagazineSize, int32 InBullets)
+{
+	MarkChanged(EGrimRailHUDField::Ammo, MagazineSize != InMagazineSize || Bullets != InBullets);
+	MagazineSize = InMagazineSize;
+	Bullets = InBullets;
+}
+
+void UGrimRailHUDModel::SetLifePercent(float Percent)
+{
+	MarkChanged(EGrimRailHUDField::LifePercent, LifePercent != Percent);
+	LifePercent = Percent;
+}
+
+void UGrimRailHUDModel::MarkAllDirty()
+{
+	DirtyFields |= SetFields;
+}
+
+void UGrimRailHUDModel::Flush()
+{
+	if (DirtyFields == EGrimRailHUDField::None)
+	{
+		return;
+	}
+
+	// clear the flags first so listeners can write new values while being notified
+	const EGrimRailHUDField Fields = DirtyFields;
+	DirtyFields = EGrimRailHUDField::None;
+
+	if (EnumHasAnyFlags(Fields, EGrimRailHUDField::SprintPercent))
+	{
+		OnSprintPercentChanged.Broadcast(SprintPercent);
+	}
+
+	if (EnumHasAnyFlags(Fields, EGrimRailHUDField::Sprinting))
+	{
+		OnSprintingChanged.Broadcast(bSprinting);
+	}
+
+	if (EnumHasAnyFlags(Fields, EGrimRailHUDField::Ammo))
+	{
+		OnAmmoChanged.Broadcast(MagazineSize, Bullets);
+	}
+
+	if (EnumHasAnyFlags(Fields, EGrimRailHUDField::LifePercent))
+	{
+		OnLifePercentChanged.Broadcast(LifePercent);
+	}
+
+	OnFlushed.Broadcast();
+}
+
+void UGrimRailHUDModel::MarkChanged(EGrimRailHUDField Field, bool bValueChanged)
+{
+	// the first write always goes through so widgets leave their designer defaults
+	if (bValueChanged || !EnumHasAnyFlags(SetFields, Field))
+	{
+		SetFields |= Field;
+		DirtyFields |= Field;
+	}
+}
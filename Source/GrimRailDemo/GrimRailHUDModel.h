@@ -0,0 +1,148 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Tickable.h"
+#include "GrimRailHUDModel.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FHUDModelPercentChangedDelegate, float, Percent);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FHUDModelSprintingChangedDelegate, bool, bSprinting);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHUDModelAmmoChangedDelegate, int32, MagazineSize, int32, Bullets);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FHUDModelFlushedDelegate);
+
+/** HUD values tracked by the model */
+enum class EGrimRailHUDField : uint8
+{
+	None			= 0,
+	SprintPercent	= 1 << 0,
+	Sprinting		= 1 << 1,
+	Ammo			= 1 << 2,
+	LifePercent		= 1 << 3,
+
+	All				= SprintPercent | Sprinting | Ammo | LifePercent
+};
+ENUM_CLASS_FLAGS(EGrimRailHUDField);
+
+/**
+ *  View model between gameplay and HUD widgets
+ *  Gameplay code writes the latest values as often as it likes. Unchanged values are ignored,
+ *  and changed values are pushed to the widgets at most once per frame.
+ *  Since widgets only hear about real changes, they can sit behind invalidation or retainer panels
+ */
+UCLASS(BlueprintType)
+class GRIMRAILDEMO_API UGrimRailHUDModel : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Sprint meter, from 0 to 1 */
+	float SprintPercent = 0.0f;
+
+	/** True while sprinting */
+	bool bSprinting = false;
+
+	/** Magazine size of the current weapon */
+	int32 MagazineSize = 0;
+
+	/** Bullets left in the current weapon */
+	int32 Bullets = 0;
+
+	/** Life total, from 0 to 1 */
+	float LifePercent = 0.0f;
+
+	/** Fields that were written at least once */
+	EGrimRailHUDField SetFields = EGrimRailHUDField::None;
+
+	/** Fields that changed since the last flush */
+	EGrimRailHUDField DirtyFields = EGrimRailHUDField::None;
+
+public:
+
+	/** Called on flush when the sprint meter changed */
+	UPROPERTY(BlueprintAssignable, Category="HUD")
+	FHUDModelPercentChangedDelegate OnSprintPercentChanged;
+
+	/** Called on flush when the sprint state changed */
+	UPROPERTY(BlueprintAssignable, Category="HUD")
+	FHUDModelSprintingChangedDelegate OnSprintingChanged;
+
+	/** Called on flush when the magazine size or bullet count changed */
+	UPROPERTY(BlueprintAssignable, Category="HUD")
+	FHUDModelAmmoChangedDelegate OnAmmoChanged;
+
+	/** Called on flush when the life total changed */
+	UPROPERTY(BlueprintAssignable, Category="HUD")
+	FHUDModelPercentChangedDelegate OnLifePercentChanged;
+
+	/** Called after all changed values were pushed. Useful to request a redraw of retainer panels */
+	UPROPERTY(BlueprintAssignable, Category="HUD")
+	FHUDModelFlushedDelegate OnFlushed;
+
+public:
+
+	//~Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual bool IsTickableWhenPaused() const override { return true; }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+	//~End FTickableGameObject Interface
+
+	/** Returns the world of the owning object */
+	virtual UWorld* GetWorld() const override;
+
+public:
+
+	/** Sets the sprint meter */
+	UFUNCTION(BlueprintCallable, Category="HUD")
+	void SetSprintPercent(float Percent);
+
+	/** Sets the sprint state */
+	UFUNCTION(BlueprintCallable, Category="HUD")
+	void SetSprinting(bool bInSprinting);
+
+	/** Sets the magazine size and bullet count. Parameter order matches the bullet count delegate */
+	UFUNCTION(BlueprintCallable, Category="HUD")
+	void SetAmmo(int32 InMagazineSize, int32 InBullets);
+
+	/** Sets the life total */
+	UFUNCTION(BlueprintCallable, Category="HUD")
+	void SetLifePercent(float Percent);
+
+	/** Pushes every value that was set at least once on the next flush, e.g. after possessing a new pawn */
+	UFUNCTION(BlueprintCallable, Category="HUD")
+	void MarkAllDirty();
+
+	/** Pushes all pending changes right away */
+	UFUNCTION(BlueprintCallable, Category="HUD")
+	void Flush();
+
+	/** Returns the current sprint meter */
+	UFUNCTION(BlueprintPure, Category="HUD")
+	float GetSprintPercent() const { return SprintPercent; }
+
+	/** Returns the current sprint state */
+	UFUNCTION(BlueprintPure, Category="HUD")
+	bool IsSprinting() const { return bSprinting; }
+
+	/** Returns the current magazine size */
+	UFUNCTION(BlueprintPure, Category="HUD")
+	int32 GetMagazineSize() const { return MagazineSize; }
+
+	/** Returns the current bullet count */
+	UFUNCTION(BlueprintPure, Category="HUD")
+	int32 GetBullets() const { return Bullets; }
+
+	/** Returns the current life total */
+	UFUNCTION(BlueprintPure, Category="HUD")
+	float GetLifePercent() const { return LifePercent; }
+
+protected:
+
+	/** Flags the field as changed if it was never set before or if the value differs */
+	void MarkChanged(EGrimRailHUDField Field, bool bValueChanged);
+};
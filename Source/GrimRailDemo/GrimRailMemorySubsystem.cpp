@@ -0,0 +1,317 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrimRailMemorySubsystem.h"
+#include "GrimRailTickScheduler.h"
+#include "NotebookComponent.h"
+#include "CollectibleActor.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/UObjectIterator.h"
+#include "GrimRailDemo.h"
+
+LLM_DEFINE_TAG(GrimRail);
+LLM_DEFINE_TAG(GrimRail_Notebook, NAME_None, TEXT("GrimRail"));
+LLM_DEFINE_TAG(GrimRail_Projectiles, NAME_None, TEXT("GrimRail"));
+LLM_DEFINE_TAG(GrimRail_Weapons, NAME_None, TEXT("GrimRail"));
+LLM_DEFINE_TAG(GrimRail_NPCs, NAME_None, TEXT("GrimRail"));
+
+static FAutoConsoleCommandWithWorldAndArgs GGrimRailMemReportCommand(
+	TEXT("GrimRail.MemReport"),
+	TEXT("Logs how many GrimRail gameplay objects are alive and the memory they hold. Usage: GrimRail.MemReport [csv]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UGrimRailMemorySubsystem* Memory = World ? World->GetSubsystem<UGrimRailMemorySubsystem>() : nullptr)
+		{
+			Memory->LogReport();
+
+			if (Args.Num() > 0 && Args[0] == TEXT("csv"))
+			{
+				Memory->WriteCSV();
+			}
+		}
+	}));
+
+namespace GrimRailMemory
+{
+	/** Package of the classes this module declares */
+	static const FName ModulePackageName(TEXT("/Script/GrimRailDemo"));
+
+	/** Returns the native class a GrimRail actor is counted under, or null if it isn't a GrimRail actor */
+	static const UClass* GetReportClass(const AActor* Actor)
+	{
+		const UClass* NativeClass = Actor->GetClass();
+
+		// Blueprint subclasses are counted under the class they extend
+		while (NativeClass && !NativeClass->HasAnyClassFlags(CLASS_Native))
+		{
+			NativeClass = NativeClass->GetSuperClass();
+		}
+
+		return (NativeClass && NativeClass->GetOutermost()->GetFName() == ModulePackageName) ? NativeClass : nullptr;
+	}
+}
+
+bool UGrimRailMemorySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGrimRailMemorySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// notebook entries live in notebooks and collectibles rather than in actors of their own
+	RegisterCounter(TEXT("NotebookEntries"), FGrimRailMemoryCounter::CreateUObject(this, &UGrimRailMemorySubsystem::CountNotebookEntries));
+
+	// run from the tick scheduler instead of ticking on our own
+	if (UGrimRailTickScheduler* Scheduler = Collection.InitializeDependency<UGrimRailTickScheduler>())
+	{
+		TickTaskID = Scheduler->RegisterTask(TEXT("MemoryBudgets"), EGrimRailTickLane::Deferrable, FGrimRailTickDelegate::CreateUObject(this, &UGrimRailMemorySubsystem::ScheduledTick));
+	}
+}
+
+void UGrimRailMemorySubsystem::Deinitialize()
+{
+	if (UGrimRailTickScheduler* Scheduler = GetWorld()->GetSubsystem<UGrimRailTickScheduler>())
+	{
+		Scheduler->UnregisterTask(TickTaskID);
+	}
+
+	TickTaskID = INDEX_NONE;
+	Counters.Reset();
+
+	Super::Deinitialize();
+}
+
+void UGrimRailMemorySubsystem::RegisterCounter(FName Name, FGrimRailMemoryCounter Counter, bool bSubset)
+{
+	if (Name.IsNone() || !Counter.IsBound())
+	{
+		return;
+	}
+
+	Counters.Add(Name, { MoveTemp(Counter), bSubset });
+}
+
+void UGrimRailMemorySubsystem::UnregisterCounter(FName Name)
+{
+	Counters.Remove(Name);
+	OverBudget.Remove(Name);
+}
+
+void UGrimRailMemorySubsystem::ScheduledTick(float DeltaTime)
+{
+	if (BudgetCheckInterval <= 0.0f)
+	{
+		return;
+	}
+
+	// throttle the checks
+	TimeSinceBudgetCheck += DeltaTime;
+
+	if (TimeSinceBudgetCheck < BudgetCheckInterval)
+	{
+		return;
+	}
+
+	TimeSinceBudgetCheck = 0.0f;
+
+	CheckBudgets();
+}
+
+void UGrimRailMemorySubsystem::GatherStats(bool bWithBytes, TMap<FName, FMemoryStat>& OutStats)
+{
+	OutStats.Reset();
+
+	// every GrimRail actor, under its native class
+	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+	{
+		const UClass* ReportClass = GrimRailMemory::GetReportClass(*It);
+
+		if (!ReportClass)
+		{
+			continue;
+		}
+
+		FMemoryStat& Stat = OutStats.FindOrAdd(ReportClass->GetFName());
+		++Stat.Count;
+
+		if (bWithBytes)
+		{
+			Stat.Bytes += GetActorBytes(*It);
+		}
+	}
+
+	// everything the counters track
+	for (const TPair<FName, FMemoryCounter>& Pair : Counters)
+	{
+		FMemoryStat& Stat = OutStats.FindOrAdd(Pair.Key);
+		Stat.bSubset = Pair.Value.bSubset;
+		Pair.Value.Counter.ExecuteIfBound(bWithBytes, Stat.Count, Stat.Bytes);
+	}
+}
+
+void UGrimRailMemorySubsystem::CountNotebookEntries(bool bWithBytes, int32& OutCount, int64& OutBytes) const
+{
+	// entries the player has collected
+	for (TObjectIterator<UNotebookComponent> It; It; ++It)
+	{
+		if (It->GetWorld() != GetWorld())
+		{
+			continue;
+		}
+
+		OutCount += It->GetAllEntries().Num();
+
+		if (bWithBytes)
+		{
+			for (const FNotebookEntry& Entry : It->GetAllEntries())
+			{
+				OutBytes += GetEntryBytes(Entry);
+			}
+		}
+	}
+
+	// copies waiting in collectibles still in the level
+	for (TActorIterator<ACollectibleActor> It(GetWorld()); It; ++It)
+	{
+		if (const FNotebookEntry* Entry = It->GetInlineEntry())
+		{
+			++OutCount;
+			OutBytes += bWithBytes ? GetEntryBytes(*Entry) : 0;
+		}
+	}
+}
+
+void UGrimRailMemorySubsystem::CheckBudgets()
+{
+	TMap<FName, FMemoryStat> Stats;
+	GatherStats(false, Stats);
+
+	for (const TPair<FName, int32>& Budget : CountBudgets)
+	{
+		const FMemoryStat* Stat = Stats.Find(Budget.Key);
+		const int32 Count = Stat ? Stat->Count : 0;
+
+		if (Count > Budget.Value)
+		{
+			bool bAlreadyOver = false;
+			OverBudget.Add(Budget.Key, &bAlreadyOver);
+
+			if (!bAlreadyOver)
+			{
+				UE_LOG(LogGrimRailDemo, Warning, TEXT("GrimRailMemorySubsystem: %s over budget, %d live with a budget of %d"), *Budget.Key.ToString(), Count, Budget.Value);
+			}
+
+		} else if (OverBudget.Remove(Budget.Key) > 0) {
+
+			UE_LOG(LogGrimRailDemo, Log, TEXT("GrimRailMemorySubsystem: %s back within budget, %d live"), *Budget.Key.ToString(), Count);
+		}
+	}
+}
+
+void UGrimRailMemorySubsystem::GetCounts(TMap<FName, int32>& OutCounts)
+{
+	TMap<FName, FMemoryStat> Stats;
+	GatherStats(false, Stats);
+
+	OutCounts.Reset();
+
+	for (const TPair<FName, FMemoryStat>& Pair : Stats)
+	{
+		OutCounts.Add(Pair.Key, Pair.Value.Count);
+	}
+}
+
+void UGrimRailMemorySubsystem::LogReport()
+{
+	TMap<FName, FMemoryStat> Stats;
+	GatherStats(true, Stats);
+
+	// biggest first
+	Stats.ValueSort([](const FMemoryStat& A, const FMemoryStat& B)
+	{
+		return A.Bytes > B.Bytes;
+	});
+
+	int32 TotalCount = 0;
+	int64 TotalBytes = 0;
+
+	for (const TPair<FName, FMemoryStat>& Pair : Stats)
+	{
+		const int32* Budget = CountBudgets.Find(Pair.Key);
+
+		UE_LOG(LogGrimRailDemo, Display, TEXT("GrimRailMemorySubsystem: %-24s %6d live %10.1f KB%s%s"),
+			*Pair.Key.ToString(),
+			Pair.Value.Count,
+			Pair.Value.Bytes / 1024.0,
+			Budget ? *FString::Printf(TEXT(", budget %d"), *Budget) : TEXT(""),
+			Pair.Value.bSubset ? TEXT(", subset of another row") : TEXT(""));
+
+		// subsets are already in the totals through the row they're part of
+		if (!Pair.Value.bSubset)
+		{
+			TotalCount += Pair.Value.Count;
+			TotalBytes += Pair.Value.Bytes;
+		}
+	}
+
+	UE_LOG(LogGrimRailDemo, Display, TEXT("GrimRailMemorySubsystem: %d objects, %.1f KB in total"), TotalCount, TotalBytes / 1024.0);
+}
+
+FString UGrimRailMemorySubsystem::WriteCSV()
+{
+	TMap<FName, FMemoryStat> Stats;
+	GatherStats(true, Stats);
+
+	FString CSV = TEXT("Name,Count,Bytes,Budget,Subset\n");
+
+	for (const TPair<FName, FMemoryStat>& Pair : Stats)
+	{
+		const int32* Budget = CountBudgets.Find(Pair.Key);
+		CSV += FString::Printf(TEXT("%s,%d,%lld,%s,%d\n"), *Pair.Key.ToString(), Pair.Value.Count, Pair.Value.Bytes, Budget ? *FString::FromInt(*Budget) : TEXT(""), Pair.Value.bSubset ? 1 : 0);
+	}
+
+	const FString Path = FPaths::ProfilingDir() / TEXT("GrimRail") / FString::Printf(TEXT("MemReport-%s.csv"), *FDateTime::Now().ToString());
+
+	if (!FFileHelper::SaveStringToFile(CSV, *Path))
+	{
+		UE_LOG(LogGrimRailDemo, Warning, TEXT("GrimRailMemorySubsystem: Couldn't write %s"), *Path);
+		return FString();
+	}
+
+	UE_LOG(LogGrimRailDemo, Display, TEXT("GrimRailMemorySubsystem: Wrote %s"), *Path);
+	return Path;
+}
+
+int64 UGrimRailMemorySubsystem::GetActorBytes(AActor* Actor)
+{
+	if (!Actor)
+	{
+		return 0;
+	}
+
+	// count the actor and its components the way obj list does, plus whatever resources they hold on their own
+	TInlineComponentArray<UActorComponent*> Components(Actor);
+
+	FArchiveCountMem ActorMem(Actor);
+	int64 Bytes = ActorMem.GetMax() + Actor->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+
+	for (UActorComponent* Component : Components)
+	{
+		FArchiveCountMem ComponentMem(Component);
+		Bytes += ComponentMem.GetMax() + Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	}
+
+	return Bytes;
+}
+
+int64 UGrimRailMemorySubsystem::GetEntryBytes(const FNotebookEntry& Entry)
+{
+	return sizeof(FNotebookEntry) + Entry.Title.ToString().GetAllocatedSize() + Entry.Body.ToString().GetAllocatedSize();
+}
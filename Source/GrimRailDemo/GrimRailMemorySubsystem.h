@@ -0,0 +1,136 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "GrimRailMemorySubsystem.generated.h"
+
+struct FNotebookEntry;
+
+/** LLM tags for GrimRail gameplay allocations, shown under GrimRail when running with -llm */
+LLM_DECLARE_TAG_API(GrimRail, GRIMRAILDEMO_API);
+LLM_DECLARE_TAG_API(GrimRail_Notebook, GRIMRAILDEMO_API);
+LLM_DECLARE_TAG_API(GrimRail_Projectiles, GRIMRAILDEMO_API);
+LLM_DECLARE_TAG_API(GrimRail_Weapons, GRIMRAILDEMO_API);
+LLM_DECLARE_TAG_API(GrimRail_NPCs, GRIMRAILDEMO_API);
+
+/** Counts something that isn't an actor of its own or a subset of another row, e.g. notebook entries or corpses. Bytes are only needed if bWithBytes is set */
+DECLARE_DELEGATE_ThreeParams(FGrimRailMemoryCounter, bool /*bWithBytes*/, int32& /*OutCount*/, int64& /*OutBytes*/);
+
+/**
+ *  Reports how many GrimRail gameplay objects are alive and how much memory they hold
+ *  Every actor of a GrimRail class is counted under its native class. Systems can add counters for things that
+ *  aren't actors of their own, or break out a subset of another row. Counts are checked against configurable budgets every few seconds and a warning is
+ *  logged when one goes over, e.g. projectiles piling up during a soak test.
+ *  Bytes are what the objects and their components hold, the same way obj list counts them. For allocations
+ *  made on behalf of GrimRail systems, run with -llm and look at the GrimRail LLM tags
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UGrimRailMemorySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Most live objects of each row before a warning is logged. Rows are native class names or counter names */
+	UPROPERTY(Config, EditAnywhere, Category="Memory")
+	TMap<FName, int32> CountBudgets = {
+		{ TEXT("ShooterProjectile"), 200 },
+		{ TEXT("ShooterWeapon"), 64 },
+		{ TEXT("Corpses"), 20 },
+		{ TEXT("NotebookEntries"), 500 }
+	};
+
+	/** Time between budget checks. Zero turns the checks off */
+	UPROPERTY(Config, EditAnywhere, Category="Memory", meta = (ClampMin = 0, Units = "s"))
+	float BudgetCheckInterval = 5.0f;
+
+	/** Live count and bytes of a report row */
+	struct FMemoryStat
+	{
+		int32 Count = 0;
+		int64 Bytes = 0;
+
+		/** True if the row counts objects another row already counts, so it's left out of the totals */
+		bool bSubset = false;
+	};
+
+	/** A registered counter */
+	struct FMemoryCounter
+	{
+		FGrimRailMemoryCounter Counter;
+		bool bSubset = false;
+	};
+
+	/** Registered counters by row name */
+	TMap<FName, FMemoryCounter> Counters;
+
+	/** Rows that were over budget at the last check, so each overrun is only warned about once */
+	TSet<FName> OverBudget;
+
+	/** Time accumulated since the last budget check */
+	float TimeSinceBudgetCheck = 0.0f;
+
+	/** Tick scheduler task running the budget checks */
+	int32 TickTaskID = INDEX_NONE;
+
+public:
+
+	//~Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem Interface
+
+	/**
+	 * Adds a report row for something that isn't an actor of its own, or for a subset of another row
+	 * @param Name Row name, also used to look up its budget
+	 * @param Counter Called on the game thread to count the live objects and, when asked for, their bytes
+	 * @param bSubset True if the objects are already counted by another row, e.g. corpses are NPC actors. Left out of the totals
+	 */
+	void RegisterCounter(FName Name, FGrimRailMemoryCounter Counter, bool bSubset = false);
+
+	/** Removes a report row */
+	void UnregisterCounter(FName Name);
+
+	/** Logs live counts and bytes per row */
+	void LogReport();
+
+	/** Gets the live count of every row, without the more expensive bytes */
+	void GetCounts(TMap<FName, int32>& OutCounts);
+
+	/**
+	 * Writes live counts and bytes per row to a CSV file in the profiling folder
+	 * @return Path of the written file, empty if it couldn't be written
+	 */
+	FString WriteCSV();
+
+	/** Runs the budget checks from the tick scheduler's deferrable lane */
+	void ScheduledTick(float DeltaTime);
+
+	/** Returns the bytes an actor and its components hold */
+	static int64 GetActorBytes(AActor* Actor);
+
+	/** Returns the bytes a notebook entry holds, including its text */
+	static int64 GetEntryBytes(const FNotebookEntry& Entry);
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem Interface
+
+	/**
+	 * Counts the live objects of every row
+	 * @param bWithBytes If false, only counts are gathered, which is much cheaper
+	 * @param OutStats Stats by row name
+	 */
+	void GatherStats(bool bWithBytes, TMap<FName, FMemoryStat>& OutStats);
+
+	/** Counts the notebook entries held by notebooks and collectibles */
+	void CountNotebookEntries(bool bWithBytes, int32& OutCount, int64& OutBytes) const;
+
+	/** Warns about rows that went over budget */
+	void CheckBudgets();
+};
@@ -0,0 +1,409 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrimRailPerfCaptureSubsystem.h"
+#include "GrimRailTickScheduler.h"
+#include "GrimRailMemorySubsystem.h"
+#include "CollectibleActor.h"
+#include "RoomFlipActor.h"
+#include "Interactable.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "GrimRailDemo.h"
+
+bool UGrimRailPerfCaptureSubsystem::IsCapturing()
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("GrimRailPerfCapture"));
+}
+
+bool UGrimRailPerfCaptureSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && IsCapturing();
+}
+
+bool UGrimRailPerfCaptureSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGrimRailPerfCaptureSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// optional run time override for quick local runs
+	FParse::Value(FCommandLine::Get(), TEXT("GrimRailPerfDuration="), CaptureDuration);
+
+	// measure the game thread work per frame, the frame delta also holds any idle time
+	BeginFrameHandle = FCoreDelegates::OnBeginFrame.AddUObject(this, &UGrimRailPerfCaptureSubsystem::OnBeginFrame);
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UGrimRailPerfCaptureSubsystem::OnEndFrame);
+
+	UE_LOG(LogGrimRailDemo, Display, TEXT("GrimRailPerfCapture: Capturing %s for %.0fs after a %.0fs warmup"), *UWorld::RemovePIEPrefix(GetWorld()->GetMapName()), CaptureDuration, WarmupTime);
+}
+
+void UGrimRailPerfCaptureSubsystem::Deinitialize()
+{
+	FCoreDelegates::OnBeginFrame.Remove(BeginFrameHandle);
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+	Super::Deinitialize();
+}
+
+void UGrimRailPerfCaptureSubsystem::OnBeginFrame()
+{
+	FrameStartTime = FPlatformTime::Seconds();
+	bSkipFrame = false;
+}
+
+void UGrimRailPerfCaptureSubsystem::OnEndFrame()
+{
+	// only record once the map has settled, and leave out frames that did capture book-keeping
+	if (FrameStartTime <= 0.0 || ElapsedTime < WarmupTime || bFinished || bSkipFrame)
+	{
+		return;
+	}
+
+	FrameTimesMs.Add(static_cast<float>((FPlatformTime::Seconds() - FrameStartTime) * 1000.0));
+}
+
+void UGrimRailPerfCaptureSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (bFinished)
+	{
+		return;
+	}
+
+	ElapsedTime += DeltaTime;
+	TimeSinceStep += DeltaTime;
+
+	// walk the scripted path from the start, so the map is already busy once recording begins
+	if (TimeSinceStep >= StepInterval)
+	{
+		TimeSinceStep = 0.0f;
+		RunScriptStep();
+
+		if (ElapsedTime >= WarmupTime)
+		{
+			SampleCounters();
+		}
+	}
+
+	if (ElapsedTime < WarmupTime)
+	{
+		return;
+	}
+
+	if (const UGrimRailTickScheduler* Scheduler = GetWorld()->GetSubsystem<UGrimRailTickScheduler>())
+	{
+		for (int32 Lane = 0; Lane < static_cast<int32>(EGrimRailTickLane::Num); ++Lane)
+		{
+			SchedulerTimeMs += Scheduler->GetLaneTimeMs(static_cast<EGrimRailTickLane>(Lane));
+		}
+
+		++NumSchedulerFrames;
+	}
+
+	if (ElapsedTime >= WarmupTime + CaptureDuration)
+	{
+		FinishCapture();
+	}
+}
+
+TStatId UGrimRailPerfCaptureSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGrimRailPerfCaptureSubsystem, STATGROUP_Tickables);
+}
+
+void UGrimRailPerfCaptureSubsystem::RunScriptStep()
+{
+	APlayerController* PC = GetWorld()->GetFirstPlayerController();
+	APawn* Pawn = PC ? PC->GetPawn() : nullptr;
+
+	// visit the next collectible that can still be picked up, and pick it up
+	if (Pawn)
+	{
+		TArray<ACollectibleActor*> Collectibles;
+
+		for (TActorIterator<ACollectibleActor> It(GetWorld()); It; ++It)
+		{
+			if (IInteractable::Execute_CanInteract(*It, PC))
+			{
+				Collectibles.Add(*It);
+			}
+		}
+
+		if (Collectibles.Num() > 0)
+		{
+			ACollectibleActor* Collectible = Collectibles[CollectibleCursor++ % Collectibles.Num()];
+
+			Pawn->TeleportTo(Collectible->GetActorLocation() + FVector(0.0f, 0.0f, 100.0f), Pawn->GetActorRotation());
+			IInteractable::Execute_OnInteract(Collectible, PC);
+		}
+	}
+
+	// flip the next room that's ready to
+	TArray<ARoomFlipActor*> Rooms;
+
+	for (TActorIterator<ARoomFlipActor> It(GetWorld()); It; ++It)
+	{
+		Rooms.Add(*It);
+	}
+
+	for (int32 Attempt = 0; Attempt < Rooms.Num(); ++Attempt)
+	{
+		ARoomFlipActor* Room = Rooms[FlipCursor++ % Rooms.Num()];
+
+		if (Room->CanFlip())
+		{
+			Room->TriggerFlip();
+			break;
+		}
+	}
+}
+
+void UGrimRailPerfCaptureSubsystem::SampleCounters()
+{
+	UGrimRailMemorySubsystem* Memory = GetWorld()->GetSubsystem<UGrimRailMemorySubsystem>();
+
+	if (!Memory)
+	{
+		return;
+	}
+
+	// counting walks every actor, keep it out of the frame times
+	bSkipFrame = true;
+
+	TMap<FName, int32> Counts;
+	Memory->GetCounts(Counts);
+
+	for (const TPair<FName, int32>& Pair : Counts)
+	{
+		int32& Peak = PeakCounts.FindOrAdd(Pair.Key);
+		Peak = FMath::Max(Peak, Pair.Value);
+	}
+}
+
+void UGrimRailPerfCaptureSubsystem::FinishCapture()
+{
+	bFinished = true;
+
+	// build the metrics. All of them are better when lower
+	TArray<FPerfMetric> Metrics;
+
+	auto AddMetric = [&Metrics](const FString& Name, double Value, double DefaultSlack)
+	{
+		FPerfMetric& Metric = Metrics.AddDefaulted_GetRef();
+		Metric.Name = Name;
+		Metric.Value = Value;
+		Metric.DefaultSlack = DefaultSlack;
+	};
+
+	TArray<float> SortedFrameTimes = FrameTimesMs;
+	SortedFrameTimes.Sort();
+
+	const int32 NumFrames = SortedFrameTimes.Num();
+	double TotalFrameMs = 0.0;
+	int32 NumHitches = 0;
+
+	for (const float FrameMs : SortedFrameTimes)
+	{
+		TotalFrameMs += FrameMs;
+		NumHitches += FrameMs > HitchThresholdMs ? 1 : 0;
+	}
+
+	AddMetric(TEXT("GameThreadAvgMs"), NumFrames > 0 ? TotalFrameMs / NumFrames : 0.0, 0.1);
+	AddMetric(TEXT("GameThreadP95Ms"), NumFrames > 0 ? SortedFrameTimes[FMath::Min(NumFrames - 1, FMath::FloorToInt(NumFrames * 0.95f))] : 0.0, 0.25);
+	AddMetric(TEXT("GameThreadMaxMs"), NumFrames > 0 ? SortedFrameTimes.Last() : 0.0, 5.0);
+	AddMetric(TEXT("Hitches"), NumHitches, 2.0);
+	AddMetric(TEXT("SchedulerAvgMs"), NumSchedulerFrames > 0 ? SchedulerTimeMs / NumSchedulerFrames : 0.0, 0.05);
+	AddMetric(TEXT("PeakUsedPhysicalMB"), FPlatformMemory::GetStats().PeakUsedPhysical / (1024.0 * 1024.0), 16.0);
+
+	PeakCounts.KeySort(FNameLexicalLess());
+
+	for (const TPair<FName, int32>& Pair : PeakCounts)
+	{
+		AddMetric(FString::Printf(TEXT("Peak%s"), *Pair.Key.ToString()), Pair.Value, 2.0);
+	}
+
+	const FString MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+
+	// record a new baseline instead of comparing against the old one
+	if (FParse::Param(FCommandLine::Get(), TEXT("GrimRailPerfUpdateBaseline")))
+	{
+		WriteBaseline(Metrics);
+		WriteResultsCSV(Metrics);
+		FPlatformMisc::RequestExitWithStatus(false, 0);
+		return;
+	}
+
+	ApplyBaseline(Metrics);
+
+	int32 NumRegressions = 0;
+	int32 NumMissing = 0;
+
+	for (const FPerfMetric& Metric : Metrics)
+	{
+		// a metric nobody recorded can't be checked, so it fails the run until the baseline is updated
+		if (!Metric.bHasBaseline)
+		{
+			UE_LOG(LogGrimRailDemo, Error, TEXT("GrimRailPerfCapture: %-28s %10.2f NO BASELINE"), *Metric.Name, Metric.Value);
+			++NumMissing;
+			continue;
+		}
+
+		const bool bRegressed = Metric.Value > Metric.Limit;
+		NumRegressions += bRegressed ? 1 : 0;
+
+		if (bRegressed)
+		{
+			UE_LOG(LogGrimRailDemo, Error, TEXT("GrimRailPerfCapture: %-28s %10.2f, baseline %.2f, limit %.2f REGRESSED"), *Metric.Name, Metric.Value, Metric.Baseline, Metric.Limit);
+
+		} else {
+
+			UE_LOG(LogGrimRailDemo, Display, TEXT("GrimRailPerfCapture: %-28s %10.2f, baseline %.2f, limit %.2f"), *Metric.Name, Metric.Value, Metric.Baseline, Metric.Limit);
+		}
+	}
+
+	WriteResultsCSV(Metrics);
+
+	const bool bFailed = NumRegressions > 0 || NumMissing > 0;
+
+	UE_LOG(LogGrimRailDemo, Display, TEXT("GrimRailPerfCapture: %s %s over %d frames, %d regressions, %d metrics without a baseline"), *MapName, bFailed ? TEXT("failed") : TEXT("passed"), NumFrames, NumRegressions, NumMissing);
+
+	FPlatformMisc::RequestExitWithStatus(false, bFailed ? 1 : 0);
+}
+
+FString UGrimRailPerfCaptureSubsystem::GetBaselinePath() const
+{
+	FString Path;
+
+	// CI can point at a baseline recorded on its own hardware
+	if (!FParse::Value(FCommandLine::Get(), TEXT("GrimRailPerfBaseline="), Path))
+	{
+		Path = FPaths::ProjectConfigDir() / TEXT("PerfBaselines") / (UWorld::RemovePIEPrefix(GetWorld()->GetMapName()) + TEXT(".ini"));
+	}
+
+	return Path;
+}
+
+void UGrimRailPerfCaptureSubsystem::ApplyBaseline(TArray<FPerfMetric>& Metrics) const
+{
+	const FString Path = GetBaselinePath();
+
+	FConfigFile Baseline;
+	Baseline.Read(Path);
+
+	if (!Baseline.FindSection(TEXT("Baseline")))
+	{
+		UE_LOG(LogGrimRailDemo, Error, TEXT("GrimRailPerfCapture: No baseline in %s, record one with -GrimRailPerfUpdateBaseline"), *Path);
+		return;
+	}
+
+	double Tolerance = DefaultTolerance;
+	FString ToleranceString;
+
+	if (Baseline.GetString(TEXT("Baseline"), TEXT("DefaultTolerance"), ToleranceString))
+	{
+		Tolerance = FCString::Atod(*ToleranceString);
+	}
+
+	for (FPerfMetric& Metric : Metrics)
+	{
+		// e.g. GameThreadAvgMs=(Value=4.2,Tolerance=0.1,Slack=0.5), tolerance and slack are optional
+		FString Entry;
+
+		if (!Baseline.GetString(TEXT("Baseline"), *Metric.Name, Entry) || !FParse::Value(*Entry, TEXT("Value="), Metric.Baseline))
+		{
+			continue;
+		}
+
+		double MetricTolerance = Tolerance;
+		double Slack = Metric.DefaultSlack;
+
+		FParse::Value(*Entry, TEXT("Tolerance="), MetricTolerance);
+		FParse::Value(*Entry, TEXT("Slack="), Slack);
+
+		Metric.bHasBaseline = true;
+		Metric.Limit = Metric.Baseline * (1.0 + MetricTolerance) + Slack;
+	}
+}
+
+void UGrimRailPerfCaptureSubsystem::WriteBaseline(const TArray<FPerfMetric>& Metrics) const
+{
+	const FString Path = GetBaselinePath();
+
+	// keep the tolerances that were tuned by hand
+	FConfigFile OldBaseline;
+	OldBaseline.Read(Path);
+
+	FString ToleranceString = FString::SanitizeFloat(DefaultTolerance);
+	OldBaseline.GetString(TEXT("Baseline"), TEXT("DefaultTolerance"), ToleranceString);
+
+	FString Text;
+	Text += FString::Printf(TEXT("; Performance baseline for %s, recorded %s with -GrimRailPerfUpdateBaseline\n"), *UWorld::RemovePIEPrefix(GetWorld()->GetMapName()), *FDateTime::Now().ToString());
+	Text += TEXT("; A metric fails once it's above Value * (1 + Tolerance) + Slack. Tolerance falls back to DefaultTolerance\n");
+	Text += TEXT("[Baseline]\n");
+	Text += FString::Printf(TEXT("DefaultTolerance=%s\n"), *ToleranceString);
+
+	for (const FPerfMetric& Metric : Metrics)
+	{
+		FString OldEntry;
+		OldBaseline.GetString(TEXT("Baseline"), *Metric.Name, OldEntry);
+
+		double Tolerance = 0.0;
+		double Slack = Metric.DefaultSlack;
+		const bool bHasTolerance = FParse::Value(*OldEntry, TEXT("Tolerance="), Tolerance);
+		FParse::Value(*OldEntry, TEXT("Slack="), Slack);
+
+		Text += FString::Printf(TEXT("%s=(Value=%.3f%s,Slack=%s)\n"),
+			*Metric.Name,
+			Metric.Value,
+			bHasTolerance ? *FString::Printf(TEXT(",Tolerance=%s"), *FString::SanitizeFloat(Tolerance)) : TEXT(""),
+			*FString::SanitizeFloat(Slack));
+	}
+
+	if (FFileHelper::SaveStringToFile(Text, *Path))
+	{
+		UE_LOG(LogGrimRailDemo, Display, TEXT("GrimRailPerfCapture: Wrote baseline %s"), *Path);
+
+	} else {
+
+		UE_LOG(LogGrimRailDemo, Error, TEXT("GrimRailPerfCapture: Couldn't write baseline %s"), *Path);
+	}
+}
+
+void UGrimRailPerfCaptureSubsystem::WriteResultsCSV(const TArray<FPerfMetric>& Metrics) const
+{
+	FString CSV = TEXT("Metric,Value,Baseline,Limit,Result\n");
+
+	for (const FPerfMetric& Metric : Metrics)
+	{
+		if (Metric.bHasBaseline)
+		{
+			CSV += FString::Printf(TEXT("%s,%.3f,%.3f,%.3f,%s\n"), *Metric.Name, Metric.Value, Metric.Baseline, Metric.Limit, Metric.Value > Metric.Limit ? TEXT("Regressed") : TEXT("Passed"));
+
+		} else {
+
+			CSV += FString::Printf(TEXT("%s,%.3f,,,NoBaseline\n"), *Metric.Name, Metric.Value);
+		}
+	}
+
+	const FString Path = FPaths::ProfilingDir() / TEXT("GrimRail") / FString::Printf(TEXT("Perf-%s-%s.csv"), *UWorld::RemovePIEPrefix(GetWorld()->GetMapName()), *FDateTime::Now().ToString());
+
+	if (FFileHelper::SaveStringToFile(CSV, *Path))
+	{
+		UE_LOG(LogGrimRailDemo, Display, TEXT("GrimRailPerfCapture: Wrote %s"), *Path);
+	}
+}
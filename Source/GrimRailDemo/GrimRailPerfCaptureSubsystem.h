@@ -0,0 +1,144 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GrimRailPerfCaptureSubsystem.generated.h"
+
+/**
+ *  Performance regression capture for the demo maps
+ *  Only created when the game runs with -GrimRailPerfCapture, e.g.
+ *  GrimRailDemo Lvl_Horror -game -nullrhi -nosound -unattended -GrimRailPerfCapture
+ *  Plays the map along a scripted path: the player visits and collects every collectible and room flips are
+ *  triggered in turn. Other systems can add their own scripted work, e.g. the shooter firefights.
+ *  Records game thread frame times, hitches, the memory high water mark and GrimRail counters, then compares
+ *  them against Config/PerfBaselines/<Map>.ini and quits with a non zero exit code if anything regressed
+ *  or has no baseline to compare against.
+ *  Run with -GrimRailPerfUpdateBaseline on the reference machine to record a new baseline instead
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UGrimRailPerfCaptureSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Time to let the map settle before recording */
+	UPROPERTY(Config, EditAnywhere, Category="Perf Capture", meta = (ClampMin = 0, Units = "s"))
+	float WarmupTime = 5.0f;
+
+	/** Time to record for. Overridden by -GrimRailPerfDuration=<seconds> */
+	UPROPERTY(Config, EditAnywhere, Category="Perf Capture", meta = (ClampMin = 1, Units = "s"))
+	float CaptureDuration = 60.0f;
+
+	/** Game thread frames longer than this count as hitches */
+	UPROPERTY(Config, EditAnywhere, Category="Perf Capture", meta = (ClampMin = 0, Units = "ms"))
+	float HitchThresholdMs = 33.3f;
+
+	/** Time between scripted path steps */
+	UPROPERTY(Config, EditAnywhere, Category="Perf Capture", meta = (ClampMin = 0.1, Units = "s"))
+	float StepInterval = 2.0f;
+
+	/** How much a metric may grow over its baseline, as a fraction, if the baseline doesn't say */
+	UPROPERTY(Config, EditAnywhere, Category="Perf Capture", meta = (ClampMin = 0))
+	float DefaultTolerance = 0.15f;
+
+	/** A measured metric and how it compares to the baseline */
+	struct FPerfMetric
+	{
+		FString Name;
+		double Value = 0.0;
+
+		/** Absolute growth allowed on top of the tolerance unless the baseline says otherwise, for metrics that are often zero */
+		double DefaultSlack = 0.0;
+
+		bool bHasBaseline = false;
+		double Baseline = 0.0;
+		double Limit = 0.0;
+	};
+
+	/** Time since the capture started, including the warmup */
+	float ElapsedTime = 0.0f;
+
+	/** Time accumulated since the last scripted step */
+	float TimeSinceStep = 0.0f;
+
+	/** Time the game thread started working on the current frame */
+	double FrameStartTime = 0.0;
+
+	/** True if the current frame did capture book-keeping and shouldn't be recorded */
+	bool bSkipFrame = false;
+
+	/** Game thread time of every recorded frame, in milliseconds */
+	TArray<float> FrameTimesMs;
+
+	/** Tick scheduler time summed over the frames since the warmup, in milliseconds */
+	double SchedulerTimeMs = 0.0;
+
+	/** Number of frames summed into SchedulerTimeMs */
+	int32 NumSchedulerFrames = 0;
+
+	/** Highest live count of every GrimRail memory report row */
+	TMap<FName, int32> PeakCounts;
+
+	/** Next collectible and room flip the scripted path visits */
+	int32 CollectibleCursor = 0;
+	int32 FlipCursor = 0;
+
+	/** True once the results were reported */
+	bool bFinished = false;
+
+	/** Frame delegate handles */
+	FDelegateHandle BeginFrameHandle;
+	FDelegateHandle EndFrameHandle;
+
+public:
+
+	//~Begin USubsystem Interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem Interface
+
+	//~Begin UTickableWorldSubsystem Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End UTickableWorldSubsystem Interface
+
+	/** Returns true if the game runs a perf capture */
+	static bool IsCapturing();
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem Interface
+
+	/** Marks the start of the game thread work for this frame */
+	void OnBeginFrame();
+
+	/** Records the game thread work time for this frame */
+	void OnEndFrame();
+
+	/** Moves the player to the next collectible and collects it, and triggers the next room flip */
+	void RunScriptStep();
+
+	/** Updates the peak GrimRail counters */
+	void SampleCounters();
+
+	/** Builds the metrics, compares them to the baseline, reports and quits */
+	void FinishCapture();
+
+	/** Returns the path of the baseline for this map */
+	FString GetBaselinePath() const;
+
+	/** Fills in baseline values and limits from the baseline file, if there is one */
+	void ApplyBaseline(TArray<FPerfMetric>& Metrics) const;
+
+	/** Writes the measured metrics as the new baseline for this map */
+	void WriteBaseline(const TArray<FPerfMetric>& Metrics) const;
+
+	/** Writes the results to a CSV file in the profiling folder */
+	void WriteResultsCSV(const TArray<FPerfMetric>& Metrics) const;
+};
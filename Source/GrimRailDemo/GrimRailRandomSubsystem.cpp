@@ -0,0 +1,156 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrimRailRandomSubsystem.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "HAL/PlatformTime.h"
+#include "GrimRailDemo.h"
+
+namespace GrimRailRandom
+{
+	/** Golden ratio increment used by SplitMix64 */
+	static constexpr uint64 GoldenGamma = 0x9E3779B97F4A7C15ull;
+
+	/** SplitMix64 finalizer. Turns a counter into a well distributed 64 bit value */
+	static uint64 Mix(uint64 Value)
+	{
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+}
+
+void FGrimRailRandomStream::Reset(uint64 InSeed)
+{
+	Seed.store(InSeed, std::memory_order_relaxed);
+	Counter.store(0, std::memory_order_relaxed);
+}
+
+uint64 FGrimRailRandomStream::NextUInt64()
+{
+	// claim the next slot in the sequence. Relaxed is enough since slots are independent of each other
+	const uint64 Index = Counter.fetch_add(1, std::memory_order_relaxed);
+	return GrimRailRandom::Mix(Seed.load(std::memory_order_relaxed) + (Index + 1) * GrimRailRandom::GoldenGamma);
+}
+
+float FGrimRailRandomStream::GetFraction()
+{
+	// use the top 24 bits so the result is exactly representable and strictly below 1
+	return static_cast<float>(NextUInt64() >> 40) * (1.0f / 16777216.0f);
+}
+
+float FGrimRailRandomStream::FRandRange(float Min, float Max)
+{
+	return Min + (Max - Min) * GetFraction();
+}
+
+int32 FGrimRailRandomStream::RandRange(int32 Min, int32 Max)
+{
+	const int64 Range = static_cast<int64>(Max) - static_cast<int64>(Min) + 1;
+	return Range > 0 ? Min + static_cast<int32>(NextUInt64() % static_cast<uint64>(Range)) : Min;
+}
+
+FVector FGrimRailRandomStream::GetUnitVector()
+{
+	// uniform point on the sphere from a random height and a random longitude
+	const float Z = 2.0f * GetFraction() - 1.0f;
+	const float Phi = 2.0f * UE_PI * GetFraction();
+	const float Radius = FMath::Sqrt(FMath::Max(0.0f, 1.0f - Z * Z));
+
+	return FVector(Radius * FMath::Cos(Phi), Radius * FMath::Sin(Phi), Z);
+}
+
+FVector FGrimRailRandomStream::VRandCone(const FVector& Dir, float ConeHalfAngleRad)
+{
+	if (ConeHalfAngleRad <= 0.0f)
+	{
+		return Dir.GetSafeNormal();
+	}
+
+	// same distribution as FMath::VRandCone so aim feel is unchanged
+	const float RandU = GetFraction();
+	const float RandV = GetFraction();
+
+	const float Theta = 2.0f * UE_PI * RandU;
+	const float Phi = FMath::Fmod(FMath::Acos((2.0f * RandV) - 1.0f), ConeHalfAngleRad);
+
+	const FMatrix DirMat = FRotationMatrix(Dir.Rotation());
+	const FVector DirZ = DirMat.GetScaledAxis(EAxis::X);
+	const FVector DirY = DirMat.GetScaledAxis(EAxis::Y);
+
+	FVector Result = Dir.RotateAngleAxis(FMath::RadiansToDegrees(Phi), DirY);
+	Result = Result.RotateAngleAxis(FMath::RadiansToDegrees(Theta), DirZ);
+
+	return Result.GetSafeNormal();
+}
+
+void UGrimRailRandomSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// a seed passed on the command line makes perf and replay runs reproducible
+	int32 CommandLineSeed = 0;
+	if (FParse::Value(FCommandLine::Get(), TEXT("GrimRailSeed="), CommandLineSeed))
+	{
+		BaseSeed = CommandLineSeed;
+		bSeedFromCommandLine = true;
+	}
+	else
+	{
+		BaseSeed = static_cast<int32>(FPlatformTime::Cycles());
+	}
+
+	ReseedStreams();
+
+	UE_LOG(LogGrimRailDemo, Log, TEXT("GrimRailRandomSubsystem: Base seed %d (%s)"), BaseSeed, bSeedFromCommandLine ? TEXT("command line") : TEXT("time"));
+}
+
+FGrimRailRandomStream& UGrimRailRandomSubsystem::GetStream(const UWorld* World, EGrimRailRandomStream Stream)
+{
+	if (World)
+	{
+		if (UGrimRailRandomSubsystem* RandomSubsystem = World->GetSubsystem<UGrimRailRandomSubsystem>())
+		{
+			return RandomSubsystem->GetStream(Stream);
+		}
+	}
+
+	// worlds without the subsystem (e.g. editor previews) still get random values, just not reproducible ones
+	static FGrimRailRandomStream FallbackStream;
+	static const bool bFallbackSeeded = []()
+	{
+		FallbackStream.Reset(FPlatformTime::Cycles64());
+		return true;
+	}();
+	(void)bFallbackSeeded;
+
+	return FallbackStream;
+}
+
+FGrimRailRandomStream& UGrimRailRandomSubsystem::GetStream(EGrimRailRandomStream Stream)
+{
+	check(Stream < EGrimRailRandomStream::Count);
+	return Streams[static_cast<uint8>(Stream)];
+}
+
+void UGrimRailRandomSubsystem::SetBaseSeed(int32 NewSeed)
+{
+	BaseSeed = NewSeed;
+	ReseedStreams();
+}
+
+float UGrimRailRandomSubsystem::RandomFloatInRange(EGrimRailRandomStream Stream, float Min, float Max)
+{
+	return GetStream(Stream).FRandRange(Min, Max);
+}
+
+void UGrimRailRandomSubsystem::ReseedStreams()
+{
+	// give each stream its own seed so draws in one domain never shift another domain's sequence
+	for (uint8 StreamIndex = 0; StreamIndex < static_cast<uint8>(EGrimRailRandomStream::Count); ++StreamIndex)
+	{
+		const uint64 StreamSeed = GrimRailRandom::Mix(static_cast<uint64>(static_cast<uint32>(BaseSeed)) ^ ((StreamIndex + 1) * GrimRailRandom::GoldenGamma));
+		Streams[StreamIndex].Reset(StreamSeed);
+	}
+}
@@ -0,0 +1,120 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include <atomic>
+#include "GrimRailRandomSubsystem.generated.h"
+
+/** Independent random streams used by gameplay systems */
+UENUM(BlueprintType)
+enum class EGrimRailRandomStream : uint8
+{
+	NPCAim			UMETA(DisplayName = "NPC Aim"),
+	WeaponSpread	UMETA(DisplayName = "Weapon Spread"),
+	AIDecision		UMETA(DisplayName = "AI Decision"),
+
+	Count			UMETA(Hidden)
+};
+
+/**
+ * Seedable random stream that can be drawn from any thread without locking
+ * Each draw atomically claims the next counter value and hashes it with the seed,
+ * so the produced sequence only depends on the seed and the order of the draws
+ */
+class GRIMRAILDEMO_API FGrimRailRandomStream
+{
+public:
+
+	/** Reseeds the stream and rewinds it to its first value. Not safe while other threads are drawing */
+	void Reset(uint64 InSeed);
+
+	/** Returns the seed this stream was last reset with */
+	uint64 GetSeed() const { return Seed.load(std::memory_order_relaxed); }
+
+	/** Returns the next raw 64 bit value */
+	uint64 NextUInt64();
+
+	/** Returns a random value in [0, 1) */
+	float GetFraction();
+
+	/** Returns a random float between Min and Max. Mirrors FMath::RandRange */
+	float FRandRange(float Min, float Max);
+
+	/** Returns a random integer in [Min, Max]. Mirrors FMath::RandRange */
+	int32 RandRange(int32 Min, int32 Max);
+
+	/** Returns a uniformly distributed unit vector */
+	FVector GetUnitVector();
+
+	/** Returns a random unit vector inside a cone around Dir. Mirrors FMath::VRandCone */
+	FVector VRandCone(const FVector& Dir, float ConeHalfAngleRad);
+
+private:
+
+	std::atomic<uint64> Seed { 0 };
+	std::atomic<uint64> Counter { 0 };
+};
+
+/**
+ * Per-world random service for combat and AI
+ * Owns one named stream per gameplay domain so that draws in one system don't shift the sequence of another
+ * Passing -GrimRailSeed=<N> on the command line makes every stream deterministic for headless perf runs
+ */
+UCLASS()
+class GRIMRAILDEMO_API UGrimRailRandomSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Seed all streams are derived from */
+	int32 BaseSeed = 0;
+
+	/** True if the base seed was forced from the command line */
+	bool bSeedFromCommandLine = false;
+
+	/** One stream per EGrimRailRandomStream entry */
+	FGrimRailRandomStream Streams[static_cast<uint8>(EGrimRailRandomStream::Count)];
+
+public:
+
+	//~Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	//~End USubsystem Interface
+
+	/**
+	 * Returns the requested stream for the given world
+	 * Falls back to a shared, time-seeded stream if the world has no random subsystem
+	 */
+	static FGrimRailRandomStream& GetStream(const UWorld* World, EGrimRailRandomStream Stream);
+
+	/** Returns the requested stream */
+	FGrimRailRandomStream& GetStream(EGrimRailRandomStream Stream);
+
+	/**
+	 * Reseeds every stream from a new base seed
+	 * @param NewSeed Base seed that per-stream seeds are derived from
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Random")
+	void SetBaseSeed(int32 NewSeed);
+
+	/** Returns the base seed all streams were derived from */
+	UFUNCTION(BlueprintPure, Category = "Random")
+	int32 GetBaseSeed() const { return BaseSeed; }
+
+	/**
+	 * Draws a random float from the given stream
+	 * @param Stream Stream to draw from
+	 * @param Min Minimum value
+	 * @param Max Maximum value
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Random")
+	float RandomFloatInRange(EGrimRailRandomStream Stream, float Min, float Max);
+
+protected:
+
+	/** Derives and applies the seed for every stream */
+	void ReseedStreams();
+};
@@ -0,0 +1,617 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrimRailSaveSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/GameInstance.h"
+#include "Engine/Texture2D.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Tasks/Task.h"
+#include "NotebookComponent.h"
+#include "CollectibleActor.h"
+#include "RoomFlipActor.h"
+#include "GrimRailDemo.h"
+
+namespace GrimRailSave
+{
+	/** "GRSV", at the start of the file */
+	static constexpr uint32 FileMagic = 0x56535247;
+
+	/** "GBLK", at the start of each checkpoint block */
+	static constexpr uint32 BlockMagic = 0x4B4C4247;
+
+	/** Bump when the record layout changes. Files from newer versions are ignored */
+	static constexpr int32 Version = 1;
+
+	/** Serializes the payload of a record in either direction */
+	static void SerializePayload(FArchive& Ar, FGrimRailSaveRecord& Record)
+	{
+		switch (Record.Type)
+		{
+		case EGrimRailSaveRecordType::NotebookEntry:
+		{
+			FString ImagePath = Record.Entry.EntryImage.ToString();
+
+			Ar << Record.Entry.EntryID;
+			Ar << Record.Entry.Title;
+			Ar << Record.Entry.Body;
+			Ar << Record.Entry.Category;
+			Ar << Record.Entry.Timestamp;
+			Ar << Record.Entry.bHasBeenRead;
+			Ar << ImagePath;
+
+			if (Ar.IsLoading())
+			{
+				Record.Entry.EntryImage.SetPath(ImagePath);
+			}
+			break;
+		}
+
+		case EGrimRailSaveRecordType::NotebookEntryRead:
+			Ar << Record.Entry.EntryID;
+			break;
+
+		case EGrimRailSaveRecordType::NotebookCleared:
+			break;
+
+		case EGrimRailSaveRecordType::Collected:
+			Ar << Record.Key;
+			break;
+
+		case EGrimRailSaveRecordType::RoomFlip:
+			Ar << Record.Key;
+			Ar << Record.RoomFlip.FlipCount;
+			Ar << Record.RoomFlip.State;
+			Ar << Record.RoomFlip.RotationAngle;
+			Ar << Record.RoomFlip.Rotation;
+			break;
+		}
+	}
+
+	/** Returns true if this build knows how to read the given record type */
+	static bool IsKnownRecordType(uint8 Type)
+	{
+		return Type >= static_cast<uint8>(EGrimRailSaveRecordType::NotebookEntry) && Type <= static_cast<uint8>(EGrimRailSaveRecordType::RoomFlip);
+	}
+
+	/** Appends the file header to the buffer */
+	static void WriteHeader(TArray<uint8>& OutBytes)
+	{
+		FMemoryWriter Ar(OutBytes, false, true);
+
+		uint32 Magic = FileMagic;
+		int32 FileVersion = Version;
+		Ar << Magic;
+		Ar << FileVersion;
+	}
+
+	/** Appends a checkpoint block holding the given records to the buffer */
+	static void WriteBlock(TArray<uint8>& OutBytes, TArray<FGrimRailSaveRecord>& Records)
+	{
+		FMemoryWriter Ar(OutBytes, false, true);
+
+		uint32 Magic = BlockMagic;
+		Ar << Magic;
+
+		// the block size is patched in at the end, so a block cut short by a crash can be detected on load
+		const int64 BlockSizePos = Ar.Tell();
+		int32 BlockSize = 0;
+		Ar << BlockSize;
+
+		int32 NumRecords = Records.Num();
+		Ar << NumRecords;
+
+		for (FGrimRailSaveRecord& Record : Records)
+		{
+			uint8 Type = static_cast<uint8>(Record.Type);
+			Ar << Type;
+
+			// every record carries its payload size so older builds can skip record types they don't know
+			const int64 PayloadSizePos = Ar.Tell();
+			int32 PayloadSize = 0;
+			Ar << PayloadSize;
+
+			SerializePayload(Ar, Record);
+
+			const int64 PayloadEnd = Ar.Tell();
+			PayloadSize = static_cast<int32>(PayloadEnd - PayloadSizePos - sizeof(int32));
+			Ar.Seek(PayloadSizePos);
+			Ar << PayloadSize;
+			Ar.Seek(PayloadEnd);
+		}
+
+		const int64 BlockEnd = Ar.Tell();
+		BlockSize = static_cast<int32>(BlockEnd - BlockSizePos - sizeof(int32));
+		Ar.Seek(BlockSizePos);
+		Ar << BlockSize;
+		Ar.Seek(BlockEnd);
+	}
+
+	/** Reads a checkpoint block and applies its records to the state. Returns false if the block is malformed */
+	static bool ReadBlock(const TArray<uint8>& Bytes, FGrimRailSaveState& OutState)
+	{
+		FMemoryReader Ar(Bytes);
+
+		int32 NumRecords = 0;
+		Ar << NumRecords;
+
+		FGrimRailSaveRecord Record;
+
+		for (int32 RecordIndex = 0; RecordIndex < NumRecords && !Ar.IsError(); ++RecordIndex)
+		{
+			uint8 Type = 0;
+			int32 PayloadSize = 0;
+			Ar << Type;
+			Ar << PayloadSize;
+
+			const int64 PayloadEnd = Ar.Tell() + PayloadSize;
+
+			if (PayloadSize < 0 || PayloadEnd > Ar.TotalSize())
+			{
+				return false;
+			}
+
+			if (!IsKnownRecordType(Type))
+			{
+				Ar.Seek(PayloadEnd);
+				continue;
+			}
+
+			Record.Type = static_cast<EGrimRailSaveRecordType>(Type);
+			SerializePayload(Ar, Record);
+
+			if (Ar.IsError() || Ar.Tell() != PayloadEnd)
+			{
+				return false;
+			}
+
+			OutState.Apply(Record);
+		}
+
+		return !Ar.IsError();
+	}
+}
+
+/**
+ *  File side of the save system
+ *  Owns a mirror of the saved state as of the last checkpoint, so the log can be compacted without the game thread.
+ *  Only used from the load and write tasks, which are chained so they never overlap
+ */
+struct FGrimRailSaveWriter
+{
+	/** Full path of the save file */
+	FString Path;
+
+	/** Saved state as of the last write */
+	FGrimRailSaveState State;
+
+	/** Copy of the loaded state, handed over to the game thread once */
+	FGrimRailSaveState LoadedState;
+
+	/** Set when the file on disk can't be appended to and must be rewritten as a snapshot */
+	bool bRewriteNext = false;
+
+	/** Reads the save file one checkpoint block at a time */
+	void Load();
+
+	/** Applies the records and appends them to the file, or rewrites the file as a snapshot */
+	void Write(TArray<FGrimRailSaveRecord>& Records, bool bCompact);
+};
+
+void FGrimRailSaveWriter::Load()
+{
+	TUniquePtr<FArchive> File(IFileManager::Get().CreateFileReader(*Path));
+
+	// no save yet
+	if (!File)
+	{
+		return;
+	}
+
+	uint32 Magic = 0;
+	int32 FileVersion = 0;
+	*File << Magic;
+	*File << FileVersion;
+
+	if (File->IsError() || Magic != GrimRailSave::FileMagic || FileVersion > GrimRailSave::Version)
+	{
+		UE_LOG(LogGrimRailDemo, Warning, TEXT("GrimRailSaveSubsystem: Ignoring unreadable save '%s' (version %d)"), *Path, FileVersion);
+		bRewriteNext = true;
+		return;
+	}
+
+	// stream the blocks in through a single reused buffer, the file is never fully in memory
+	TArray<uint8> Block;
+	int32 NumBlocks = 0;
+	const int64 FileSize = File->TotalSize();
+
+	while (File->Tell() < FileSize)
+	{
+		uint32 BlockMagic = 0;
+		int32 BlockSize = 0;
+		*File << BlockMagic;
+		*File << BlockSize;
+
+		// a checkpoint was cut short, keep everything before it and rewrite the file on the next checkpoint
+		if (File->IsError() || BlockMagic != GrimRailSave::BlockMagic || BlockSize < 0 || File->Tell() + BlockSize > FileSize)
+		{
+			UE_LOG(LogGrimRailDemo, Warning, TEXT("GrimRailSaveSubsystem: Save '%s' is truncated after %d checkpoints"), *Path, NumBlocks);
+			bRewriteNext = true;
+			break;
+		}
+
+		Block.SetNumUninitialized(BlockSize, EAllowShrinking::No);
+		File->Serialize(Block.GetData(), BlockSize);
+
+		if (File->IsError() || !GrimRailSave::ReadBlock(Block, State))
+		{
+			UE_LOG(LogGrimRailDemo, Warning, TEXT("GrimRailSaveSubsystem: Save '%s' has a malformed checkpoint after %d checkpoints"), *Path, NumBlocks);
+			bRewriteNext = true;
+			break;
+		}
+
+		++NumBlocks;
+	}
+
+	LoadedState = State;
+
+	UE_LOG(LogGrimRailDemo, Log, TEXT("GrimRailSaveSubsystem: Loaded %d checkpoints, %d notebook entries, %d collected, %d rooms"),
+		NumBlocks, State.Entries.Num(), State.Collected.Num(), State.RoomFlips.Num());
+}
+
+void FGrimRailSaveWriter::Write(TArray<FGrimRailSaveRecord>& Records, bool bCompact)
+{
+	for (const FGrimRailSaveRecord& Record : Records)
+	{
+		State.Apply(Record);
+	}
+
+	TArray<uint8> Bytes;
+
+	if (bCompact || bRewriteNext)
+	{
+		// rewrite the whole log as a single block, through a temp file so a crash never leaves no save at all
+		TArray<FGrimRailSaveRecord> Snapshot;
+		State.ToRecords(Snapshot);
+
+		GrimRailSave::WriteHeader(Bytes);
+		GrimRailSave::WriteBlock(Bytes, Snapshot);
+
+		const FString TempPath = Path + TEXT(".tmp");
+
+		if (FFileHelper::SaveArrayToFile(Bytes, *TempPath) && IFileManager::Get().Move(*Path, *TempPath, true))
+		{
+			bRewriteNext = false;
+
+		} else {
+
+			UE_LOG(LogGrimRailDemo, Warning, TEXT("GrimRailSaveSubsystem: Could not write snapshot to '%s'"), *Path);
+			bRewriteNext = true;
+		}
+
+		return;
+	}
+
+	// append only this checkpoint's changes
+	const bool bNewFile = IFileManager::Get().FileSize(*Path) <= 0;
+
+	if (bNewFile)
+	{
+		GrimRailSave::WriteHeader(Bytes);
+	}
+
+	GrimRailSave::WriteBlock(Bytes, Records);
+
+	TUniquePtr<FArchive> File(IFileManager::Get().CreateFileWriter(*Path, bNewFile ? 0 : FILEWRITE_Append));
+
+	if (!File)
+	{
+		UE_LOG(LogGrimRailDemo, Warning, TEXT("GrimRailSaveSubsystem: Could not open '%s' for writing"), *Path);
+		bRewriteNext = true;
+		return;
+	}
+
+	File->Serialize(Bytes.GetData(), Bytes.Num());
+
+	if (!File->Close())
+	{
+		UE_LOG(LogGrimRailDemo, Warning, TEXT("GrimRailSaveSubsystem: Could not append to '%s'"), *Path);
+		bRewriteNext = true;
+	}
+}
+
+void FGrimRailSaveState::Apply(const FGrimRailSaveRecord& Record)
+{
+	switch (Record.Type)
+	{
+	case EGrimRailSaveRecordType::NotebookEntry:
+		if (const int32* Index = EntryIndex.Find(Record.Entry.EntryID))
+		{
+			Entries[*Index] = Record.Entry;
+
+		} else {
+
+			EntryIndex.Add(Record.Entry.EntryID, Entries.Add(Record.Entry));
+		}
+		break;
+
+	case EGrimRailSaveRecordType::NotebookEntryRead:
+		if (const int32* Index = EntryIndex.Find(Record.Entry.EntryID))
+		{
+			Entries[*Index].bHasBeenRead = true;
+		}
+		break;
+
+	case EGrimRailSaveRecordType::NotebookCleared:
+		Entries.Reset();
+		EntryIndex.Reset();
+		break;
+
+	case EGrimRailSaveRecordType::Collected:
+		Collected.Add(Record.Key);
+		break;
+
+	case EGrimRailSaveRecordType::RoomFlip:
+		RoomFlips.Add(Record.Key, Record.RoomFlip);
+		break;
+	}
+}
+
+void FGrimRailSaveState::ToRecords(TArray<FGrimRailSaveRecord>& OutRecords) const
+{
+	OutRecords.Reserve(OutRecords.Num() + Entries.Num() + Collected.Num() + RoomFlips.Num());
+
+	for (const FGrimRailSavedNotebookEntry& Entry : Entries)
+	{
+		FGrimRailSaveRecord& Record = OutRecords.AddDefaulted_GetRef();
+		Record.Type = EGrimRailSaveRecordType::NotebookEntry;
+		Record.Entry = Entry;
+	}
+
+	for (const FString& Key : Collected)
+	{
+		FGrimRailSaveRecord& Record = OutRecords.AddDefaulted_GetRef();
+		Record.Type = EGrimRailSaveRecordType::Collected;
+		Record.Key = Key;
+	}
+
+	for (const TPair<FString, FGrimRailSavedRoomFlip>& Pair : RoomFlips)
+	{
+		FGrimRailSaveRecord& Record = OutRecords.AddDefaulted_GetRef();
+		Record.Type = EGrimRailSaveRecordType::RoomFlip;
+		Record.Key = Pair.Key;
+		Record.RoomFlip = Pair.Value;
+	}
+}
+
+void UGrimRailSaveSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Writer = MakeShared<FGrimRailSaveWriter, ESPMode::ThreadSafe>();
+	Writer->Path = GetSavePath();
+
+	// read the save in the background while the first level loads
+	LoadTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Writer = Writer]()
+	{
+		Writer->Load();
+	});
+
+	// writes queue up behind the load
+	WriteTask = LoadTask;
+
+	if (AutoCheckpointInterval > 0.0f)
+	{
+		AutoCheckpointHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UGrimRailSaveSubsystem::HandleAutoCheckpoint), AutoCheckpointInterval);
+	}
+}
+
+void UGrimRailSaveSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(AutoCheckpointHandle);
+
+	// flush whatever changed since the last checkpoint before the game instance goes away
+	Checkpoint();
+	WriteTask.Wait();
+
+	Super::Deinitialize();
+}
+
+UGrimRailSaveSubsystem* UGrimRailSaveSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+
+	return GameInstance ? GameInstance->GetSubsystem<UGrimRailSaveSubsystem>() : nullptr;
+}
+
+FString UGrimRailSaveSubsystem::MakeActorKey(const AActor* Actor)
+{
+	// level placed actors keep their path across reloads, minus the PIE instance prefix
+	return UWorld::RemovePIEPrefix(Actor->GetPathName());
+}
+
+void UGrimRailSaveSubsystem::Checkpoint()
+{
+	if (PendingRecords.IsEmpty())
+	{
+		return;
+	}
+
+	const bool bCompact = ++CheckpointsSinceCompaction >= CompactAfterCheckpoints;
+
+	if (bCompact)
+	{
+		CheckpointsSinceCompaction = 0;
+	}
+
+	// only the record list changes hands on the game thread. Serialization and file IO happen on the task
+	WriteTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Writer = Writer, Records = MoveTemp(PendingRecords), bCompact]() mutable
+	{
+		Writer->Write(Records, bCompact);
+
+	}, UE::Tasks::Prerequisites(WriteTask));
+
+	PendingRecords.Reset();
+}
+
+void UGrimRailSaveSubsystem::DeleteSave()
+{
+	EnsureLoaded();
+
+	// let any queued writes finish so they don't recreate the file
+	WriteTask.Wait();
+
+	IFileManager::Get().Delete(*Writer->Path, false, false, true);
+
+	Writer->State = FGrimRailSaveState();
+	Writer->bRewriteNext = false;
+	State = FGrimRailSaveState();
+	PendingRecords.Reset();
+	CheckpointsSinceCompaction = 0;
+
+	UE_LOG(LogGrimRailDemo, Log, TEXT("GrimRailSaveSubsystem: Deleted save '%s'"), *Writer->Path);
+}
+
+void UGrimRailSaveSubsystem::RecordNotebookEntry(const FNotebookEntry& Entry)
+{
+	FGrimRailSaveRecord Record;
+	Record.Type = EGrimRailSaveRecordType::NotebookEntry;
+	Record.Entry.EntryID = Entry.EntryID;
+	Record.Entry.Title = Entry.Title;
+	Record.Entry.Body = Entry.Body;
+	Record.Entry.Category = static_cast<uint8>(Entry.Category);
+	Record.Entry.Timestamp = Entry.Timestamp;
+	Record.Entry.bHasBeenRead = Entry.bHasBeenRead;
+	Record.Entry.EntryImage = FSoftObjectPath(Entry.EntryImage.Get());
+
+	AddRecord(MoveTemp(Record));
+}
+
+void UGrimRailSaveSubsystem::RecordNotebookEntryRead(FName EntryID)
+{
+	FGrimRailSaveRecord Record;
+	Record.Type = EGrimRailSaveRecordType::NotebookEntryRead;
+	Record.Entry.EntryID = EntryID;
+
+	AddRecord(MoveTemp(Record));
+}
+
+void UGrimRailSaveSubsystem::RecordNotebookCleared()
+{
+	FGrimRailSaveRecord Record;
+	Record.Type = EGrimRailSaveRecordType::NotebookCleared;
+
+	AddRecord(MoveTemp(Record));
+}
+
+void UGrimRailSaveSubsystem::RecordCollected(const ACollectibleActor* Collectible)
+{
+	FGrimRailSaveRecord Record;
+	Record.Type = EGrimRailSaveRecordType::Collected;
+	Record.Key = MakeActorKey(Collectible);
+
+	AddRecord(MoveTemp(Record));
+}
+
+void UGrimRailSaveSubsystem::RecordRoomFlip(const ARoomFlipActor* Room)
+{
+	FGrimRailSaveRecord Record;
+	Record.Type = EGrimRailSaveRecordType::RoomFlip;
+	Record.Key = MakeActorKey(Room);
+	Record.RoomFlip.FlipCount = Room->GetFlipCount();
+	Record.RoomFlip.State = static_cast<uint8>(Room->GetCurrentState());
+	Record.RoomFlip.RotationAngle = Room->GetRotationAngle();
+	Record.RoomFlip.Rotation = Room->GetActorRotation();
+
+	AddRecord(MoveTemp(Record));
+}
+
+void UGrimRailSaveSubsystem::RestoreNotebook(UNotebookComponent* Notebook)
+{
+	EnsureLoaded();
+
+	if (State.Entries.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FNotebookEntry> Entries;
+	Entries.Reserve(State.Entries.Num());
+
+	for (const FGrimRailSavedNotebookEntry& SavedEntry : State.Entries)
+	{
+		FNotebookEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.EntryID = SavedEntry.EntryID;
+		Entry.Title = SavedEntry.Title;
+		Entry.Body = SavedEntry.Body;
+		Entry.Category = static_cast<ENotebookCategory>(SavedEntry.Category);
+		Entry.Timestamp = SavedEntry.Timestamp;
+		Entry.bHasBeenRead = SavedEntry.bHasBeenRead;
+
+		// entry images are normally already loaded by the collectibles in the level
+		if (!SavedEntry.EntryImage.IsNull())
+		{
+			Entry.EntryImage = Cast<UTexture2D>(SavedEntry.EntryImage.ResolveObject());
+
+			if (!Entry.EntryImage)
+			{
+				Entry.EntryImage = Cast<UTexture2D>(SavedEntry.EntryImage.TryLoad());
+			}
+		}
+	}
+
+	Notebook->RestoreEntries(MoveTemp(Entries));
+}
+
+bool UGrimRailSaveSubsystem::IsCollected(const ACollectibleActor* Collectible)
+{
+	EnsureLoaded();
+
+	return State.Collected.Contains(MakeActorKey(Collectible));
+}
+
+const FGrimRailSavedRoomFlip* UGrimRailSaveSubsystem::FindRoomFlip(const ARoomFlipActor* Room)
+{
+	EnsureLoaded();
+
+	return State.RoomFlips.Find(MakeActorKey(Room));
+}
+
+FString UGrimRailSaveSubsystem::GetSavePath() const
+{
+	return FPaths::ProjectSavedDir() / TEXT("SaveGames") / (SlotName + TEXT(".grsave"));
+}
+
+void UGrimRailSaveSubsystem::EnsureLoaded()
+{
+	if (bLoaded)
+	{
+		return;
+	}
+
+	// the load normally finished long before the first actor asks
+	LoadTask.Wait();
+
+	State = MoveTemp(Writer->LoadedState);
+	bLoaded = true;
+}
+
+void UGrimRailSaveSubsystem::AddRecord(FGrimRailSaveRecord&& Record)
+{
+	EnsureLoaded();
+
+	State.Apply(Record);
+	PendingRecords.Add(MoveTemp(Record));
+}
+
+bool UGrimRailSaveSubsystem::HandleAutoCheckpoint(float DeltaTime)
+{
+	Checkpoint();
+
+	// keep ticking
+	return true;
+}
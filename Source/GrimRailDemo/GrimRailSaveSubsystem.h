@@ -0,0 +1,193 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "Tasks/Task.h"
+#include "GrimRailSaveSubsystem.generated.h"
+
+class UNotebookComponent;
+class ACollectibleActor;
+class ARoomFlipActor;
+struct FNotebookEntry;
+struct FGrimRailSaveWriter;
+
+/** Kinds of records stored in the save log */
+enum class EGrimRailSaveRecordType : uint8
+{
+	NotebookEntry		= 1,
+	NotebookEntryRead	= 2,
+	NotebookCleared		= 3,
+	Collected			= 4,
+	RoomFlip			= 5
+};
+
+/** Saved copy of a notebook entry. Holds no object pointers so it can be serialized off the game thread */
+struct FGrimRailSavedNotebookEntry
+{
+	FName EntryID;
+	FText Title;
+	FText Body;
+	uint8 Category = 0;
+	float Timestamp = 0.0f;
+	bool bHasBeenRead = false;
+	FSoftObjectPath EntryImage;
+};
+
+/** Saved state of a room flip actor */
+struct FGrimRailSavedRoomFlip
+{
+	int32 FlipCount = 0;
+	uint8 State = 0;
+	float RotationAngle = 0.0f;
+	FRotator Rotation = FRotator::ZeroRotator;
+};
+
+/** A single change to the saved state */
+struct FGrimRailSaveRecord
+{
+	EGrimRailSaveRecordType Type = EGrimRailSaveRecordType::NotebookEntry;
+
+	/** Entry ID or actor key, depending on the type */
+	FString Key;
+
+	/** Notebook entry. Only used by NotebookEntry records */
+	FGrimRailSavedNotebookEntry Entry;
+
+	/** Room state. Only used by RoomFlip records */
+	FGrimRailSavedRoomFlip RoomFlip;
+};
+
+/** Full saved state, rebuilt by applying records in order */
+struct FGrimRailSaveState
+{
+	/** Notebook entries in the order they were added */
+	TArray<FGrimRailSavedNotebookEntry> Entries;
+
+	/** Index into Entries by entry ID */
+	TMap<FName, int32> EntryIndex;
+
+	/** Keys of collected collectibles */
+	TSet<FString> Collected;
+
+	/** Room flip state by actor key */
+	TMap<FString, FGrimRailSavedRoomFlip> RoomFlips;
+
+	/** Applies a single change */
+	void Apply(const FGrimRailSaveRecord& Record);
+
+	/** Builds the records that recreate this state from scratch */
+	void ToRecords(TArray<FGrimRailSaveRecord>& OutRecords) const;
+};
+
+/**
+ *  Incremental binary save system for the horror variant
+ *  Keeps the saved state in memory for the whole game session, so it survives level reloads.
+ *  Gameplay code reports changes as records. Checkpoints hand the pending records to a background task
+ *  that appends them to a versioned, append-only log, and compacts the log into a snapshot every so often.
+ *  The log is read back with a streaming reader on a background task when the game starts
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UGrimRailSaveSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Name of the save file, without extension */
+	UPROPERTY(Config, EditAnywhere, Category="Save")
+	FString SlotName = TEXT("GrimRail");
+
+	/** Time between automatic checkpoints. Zero disables them */
+	UPROPERTY(Config, EditAnywhere, Category="Save", meta = (ClampMin = 0, Units = "s"))
+	float AutoCheckpointInterval = 30.0f;
+
+	/** Number of appended checkpoints after which the log is rewritten as a single snapshot */
+	UPROPERTY(Config, EditAnywhere, Category="Save", meta = (ClampMin = 1))
+	int32 CompactAfterCheckpoints = 32;
+
+	/** Game thread copy of the saved state */
+	FGrimRailSaveState State;
+
+	/** Changes since the last checkpoint */
+	TArray<FGrimRailSaveRecord> PendingRecords;
+
+	/** File side of the save. Only touched by the background tasks, which run one at a time */
+	TSharedPtr<FGrimRailSaveWriter, ESPMode::ThreadSafe> Writer;
+
+	/** Background load of the save file */
+	UE::Tasks::FTask LoadTask;
+
+	/** Last background write. Each write waits on the previous one so appends stay in order */
+	UE::Tasks::FTask WriteTask;
+
+	/** True once the loaded state was handed to the game thread */
+	bool bLoaded = false;
+
+	/** Checkpoints appended since the log was last compacted */
+	int32 CheckpointsSinceCompaction = 0;
+
+	/** Auto checkpoint ticker */
+	FTSTicker::FDelegateHandle AutoCheckpointHandle;
+
+public:
+
+	//~Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem Interface
+
+	/** Returns the save subsystem for the given world context object */
+	static UGrimRailSaveSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Builds a key for a level placed actor that stays the same across level reloads and PIE sessions */
+	static FString MakeActorKey(const AActor* Actor);
+
+	/** Writes all pending changes to disk on a background task */
+	UFUNCTION(BlueprintCallable, Category="Save")
+	void Checkpoint();
+
+	/** Deletes the save file and forgets all saved state */
+	UFUNCTION(BlueprintCallable, Category="Save")
+	void DeleteSave();
+
+	/** Records a notebook entry that was just added */
+	void RecordNotebookEntry(const FNotebookEntry& Entry);
+
+	/** Records a notebook entry that was just marked as read */
+	void RecordNotebookEntryRead(FName EntryID);
+
+	/** Records that the notebook was cleared */
+	void RecordNotebookCleared();
+
+	/** Records a collected collectible */
+	void RecordCollected(const ACollectibleActor* Collectible);
+
+	/** Records the state of a room after a flip */
+	void RecordRoomFlip(const ARoomFlipActor* Room);
+
+	/** Rebuilds the notebook from the saved entries in a single pass */
+	void RestoreNotebook(UNotebookComponent* Notebook);
+
+	/** Returns true if the collectible was collected in a saved session */
+	bool IsCollected(const ACollectibleActor* Collectible);
+
+	/** Returns the saved room state, if any */
+	const FGrimRailSavedRoomFlip* FindRoomFlip(const ARoomFlipActor* Room);
+
+protected:
+
+	/** Returns the full path of the save file */
+	FString GetSavePath() const;
+
+	/** Waits for the load task if needed and takes over the loaded state */
+	void EnsureLoaded();
+
+	/** Applies a change to the game thread state and queues it for the next checkpoint */
+	void AddRecord(FGrimRailSaveRecord&& Record);
+
+	/** Runs the automatic checkpoint */
+	bool HandleAutoCheckpoint(float DeltaTime);
+};
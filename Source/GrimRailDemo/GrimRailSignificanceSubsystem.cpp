@@ -0,0 +1,306 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrimRailSignificanceSubsystem.h"
+#include "GrimRailTickScheduler.h"
+#include "SignificanceManager.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "GrimRailDemo.h"
+
+static int32 GGrimRailTickReport = 0;
+static FAutoConsoleVariableRef CVarGrimRailTickReport(
+	TEXT("GrimRail.TickReport"),
+	GGrimRailTickReport,
+	TEXT("Shows how many significance managed GrimRail actors tick every frame, and why the rest don't. 0: off, 1: on screen, 2: on screen and log"));
+
+bool UGrimRailSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGrimRailSignificanceSubsystem::RegisterActor(AActor* Actor, FName Tag, bool bNeedsSignificance, FGrimRailTickStateDelegate OnTickStateChanged)
+{
+	if (!Actor || SubjectIndex.Contains(Actor))
+	{
+		return;
+	}
+
+	FTickSubject& Subject = Subjects.AddDefaulted_GetRef();
+	Subject.Actor = Actor;
+	Subject.Tag = Tag;
+	Subject.OnTickStateChanged = MoveTemp(OnTickStateChanged);
+	Subject.bNeedsSignificance = bNeedsSignificance;
+	Subject.bTicking = Subject.OnTickStateChanged.IsBound() || Actor->IsActorTickEnabled();
+
+	SubjectIndex.Add(Actor, Subjects.Num() - 1);
+
+	// start asleep, the actor turns itself on by reporting work
+	ApplyTickState(Subject);
+
+	if (!bNeedsSignificance)
+	{
+		return;
+	}
+
+	USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld());
+
+	if (!SignificanceManager)
+	{
+		// without a significance manager, anything with work ticks
+		Subject.bSignificant = true;
+		return;
+	}
+
+	// runs on worker threads, only reads the actor
+	auto SignificanceFunction = [this](USignificanceManager::FManagedObjectInfo* Info, const FTransform& Viewpoint) -> float
+	{
+		return CalculateSignificance(Cast<AActor>(Info->GetObject()), Viewpoint);
+	};
+
+	// runs on the game thread once significance is known
+	auto PostSignificanceFunction = [this](USignificanceManager::FManagedObjectInfo* Info, float OldSignificance, float Significance, bool bFinal)
+	{
+		const int32* Index = SubjectIndex.Find(Cast<AActor>(Info->GetObject()));
+
+		if (Index)
+		{
+			FTickSubject& SignificantSubject = Subjects[*Index];
+			SignificantSubject.bSignificant = Significance > 0.0f;
+
+			ApplyTickState(SignificantSubject);
+		}
+	};
+
+	SignificanceManager->RegisterObject(Actor, Tag, SignificanceFunction, USignificanceManager::EPostSignificanceType::Sequential, PostSignificanceFunction);
+}
+
+void UGrimRailSignificanceSubsystem::UnregisterActor(AActor* Actor)
+{
+	int32 Index = INDEX_NONE;
+
+	if (!SubjectIndex.RemoveAndCopyValue(Actor, Index))
+	{
+		return;
+	}
+
+	if (Subjects[Index].bNeedsSignificance)
+	{
+		if (USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld()))
+		{
+			SignificanceManager->UnregisterObject(Actor);
+		}
+	}
+
+	// swap the last entry into the hole and fix up its index
+	Subjects.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	if (Subjects.IsValidIndex(Index))
+	{
+		if (AActor* MovedActor = Subjects[Index].Actor.Get())
+		{
+			SubjectIndex.Add(MovedActor, Index);
+		}
+	}
+}
+
+void UGrimRailSignificanceSubsystem::SetHasWork(AActor* Actor, bool bHasWork)
+{
+	if (const int32* Index = SubjectIndex.Find(Actor))
+	{
+		Subjects[*Index].bHasWork = bHasWork;
+		ApplyTickState(Subjects[*Index]);
+	}
+}
+
+void UGrimRailSignificanceSubsystem::RegisterListener(AActor* Actor, FName Tag, FGrimRailSignificanceDelegate OnSignificanceChanged)
+{
+	if (!Actor || !OnSignificanceChanged.IsBound() || Listeners.Contains(Actor))
+	{
+		return;
+	}
+
+	USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld());
+
+	if (!SignificanceManager)
+	{
+		// without a significance manager, everything counts as fully significant
+		OnSignificanceChanged.Execute(1.0f);
+		return;
+	}
+
+	Listeners.Add(Actor, MoveTemp(OnSignificanceChanged));
+
+	// runs on worker threads, only reads the actor
+	auto SignificanceFunction = [this](USignificanceManager::FManagedObjectInfo* Info, const FTransform& Viewpoint) -> float
+	{
+		return CalculateSignificance(Cast<AActor>(Info->GetObject()), Viewpoint);
+	};
+
+	// runs on the game thread once significance is known
+	auto PostSignificanceFunction = [this](USignificanceManager::FManagedObjectInfo* Info, float OldSignificance, float Significance, bool bFinal)
+	{
+		if (const FGrimRailSignificanceDelegate* Listener = Listeners.Find(Cast<AActor>(Info->GetObject())))
+		{
+			Listener->ExecuteIfBound(Significance);
+		}
+	};
+
+	SignificanceManager->RegisterObject(Actor, Tag, SignificanceFunction, USignificanceManager::EPostSignificanceType::Sequential, PostSignificanceFunction);
+}
+
+void UGrimRailSignificanceSubsystem::UnregisterListener(AActor* Actor)
+{
+	if (Listeners.Remove(Actor) == 0)
+	{
+		return;
+	}
+
+	if (USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld()))
+	{
+		SignificanceManager->UnregisterObject(Actor);
+	}
+}
+
+float UGrimRailSignificanceSubsystem::CalculateSignificance(const AActor* Actor, const FTransform& Viewpoint) const
+{
+	if (!Actor || !Actor->WasRecentlyRendered(RecentlyRenderedTime))
+	{
+		return 0.0f;
+	}
+
+	const float Distance = FVector::Dist(Actor->GetActorLocation(), Viewpoint.GetLocation());
+	return FMath::Max(1.0f - Distance / FMath::Max(SignificanceRadius, KINDA_SMALL_NUMBER), 0.0f);
+}
+
+void UGrimRailSignificanceSubsystem::ApplyTickState(FTickSubject& Subject)
+{
+	const bool bShouldTick = Subject.bHasWork && (Subject.bSignificant || !Subject.bNeedsSignificance);
+
+	if (bShouldTick == Subject.bTicking)
+	{
+		return;
+	}
+
+	Subject.bTicking = bShouldTick;
+
+	if (Subject.OnTickStateChanged.IsBound())
+	{
+		Subject.OnTickStateChanged.Execute(bShouldTick);
+
+	} else if (AActor* Actor = Subject.Actor.Get()) {
+
+		Actor->SetActorTickEnabled(bShouldTick);
+	}
+}
+
+void UGrimRailSignificanceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// run from the tick scheduler instead of ticking on our own
+	if (UGrimRailTickScheduler* Scheduler = Collection.InitializeDependency<UGrimRailTickScheduler>())
+	{
+		TickTaskID = Scheduler->RegisterTask(TEXT("Significance"), EGrimRailTickLane::Deferrable, FGrimRailTickDelegate::CreateUObject(this, &UGrimRailSignificanceSubsystem::ScheduledTick));
+	}
+}
+
+void UGrimRailSignificanceSubsystem::Deinitialize()
+{
+	if (UGrimRailTickScheduler* Scheduler = GetWorld()->GetSubsystem<UGrimRailTickScheduler>())
+	{
+		Scheduler->UnregisterTask(TickTaskID);
+	}
+
+	TickTaskID = INDEX_NONE;
+
+	Super::Deinitialize();
+}
+
+void UGrimRailSignificanceSubsystem::ScheduledTick(float DeltaTime)
+{
+	// evaluate significance from every local player's view
+	if (USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld()))
+	{
+		TArray<FTransform, TInlineAllocator<4>> Viewpoints;
+
+		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+		{
+			const APlayerController* PC = It->Get();
+
+			if (PC && PC->IsLocalController())
+			{
+				FVector ViewLocation;
+				FRotator ViewRotation;
+				PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+				Viewpoints.Emplace(ViewRotation, ViewLocation);
+			}
+		}
+
+		SignificanceManager->Update(Viewpoints);
+	}
+
+	if (GGrimRailTickReport > 0)
+	{
+		TArray<FString> Lines;
+		BuildReport(Lines);
+
+		for (const FString& Line : Lines)
+		{
+			if (GEngine)
+			{
+				GEngine->AddOnScreenDebugMessage(INDEX_NONE, 0.0f, FColor::Cyan, Line);
+			}
+
+			if (GGrimRailTickReport > 1)
+			{
+				UE_LOG(LogGrimRailDemo, Log, TEXT("GrimRailSignificanceSubsystem: %s"), *Line);
+			}
+		}
+	}
+}
+
+void UGrimRailSignificanceSubsystem::BuildReport(TArray<FString>& OutLines) const
+{
+	struct FTagCounts
+	{
+		int32 Ticking = 0;
+		int32 Idle = 0;
+		int32 Insignificant = 0;
+	};
+
+	TMap<FName, FTagCounts> CountsByTag;
+	FTagCounts Total;
+
+	for (const FTickSubject& Subject : Subjects)
+	{
+		FTagCounts& Counts = CountsByTag.FindOrAdd(Subject.Tag);
+
+		if (Subject.bTicking)
+		{
+			++Counts.Ticking;
+			++Total.Ticking;
+
+		} else if (!Subject.bHasWork) {
+
+			++Counts.Idle;
+			++Total.Idle;
+
+		} else {
+
+			// has work but nobody is near enough to see it
+			++Counts.Insignificant;
+			++Total.Insignificant;
+		}
+	}
+
+	OutLines.Add(FString::Printf(TEXT("%d of %d actors ticking, %d idle, %d far or unseen"), Total.Ticking, Subjects.Num(), Total.Idle, Total.Insignificant));
+
+	for (const TPair<FName, FTagCounts>& Pair : CountsByTag)
+	{
+		OutLines.Add(FString::Printf(TEXT("  %s: %d ticking (has work), %d idle (no work), %d far or unseen"), *Pair.Key.ToString(), Pair.Value.Ticking, Pair.Value.Idle, Pair.Value.Insignificant));
+	}
+}
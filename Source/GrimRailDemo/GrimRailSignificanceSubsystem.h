@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GrimRailSignificanceSubsystem.generated.h"
+
+/** Called instead of toggling the actor tick, for actors whose work runs somewhere else */
+DECLARE_DELEGATE_OneParam(FGrimRailTickStateDelegate, bool /*bShouldTick*/);
+
+/** Called with an actor's significance every time it's evaluated, 0 when far or unseen and up to 1 right next to the view */
+DECLARE_DELEGATE_OneParam(FGrimRailSignificanceDelegate, float /*Significance*/);
+
+/**
+ *  Turns actor ticking on and off so GrimRail actors only tick while they have work to do
+ *  Actors report when they start and stop having work, e.g. a room starting to rotate. Actors that only animate
+ *  for the player's benefit also need to be significant: near a local player's view and recently rendered.
+ *  Significance is evaluated by the significance manager, which this subsystem feeds the local viewpoints.
+ *  Actors that scale their own work, e.g. their animation rate, can listen for their significance instead
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UGrimRailSignificanceSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Distance from a local player's view within which animated actors keep ticking */
+	UPROPERTY(Config, EditAnywhere, Category="Significance", meta = (ClampMin = 0, Units = "cm"))
+	float SignificanceRadius = 3000.0f;
+
+	/** How long after its last render an actor still counts as visible */
+	UPROPERTY(Config, EditAnywhere, Category="Significance", meta = (ClampMin = 0, ClampMax = 2, Units = "s"))
+	float RecentlyRenderedTime = 0.25f;
+
+	/** A registered actor */
+	struct FTickSubject
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FName Tag;
+		FGrimRailTickStateDelegate OnTickStateChanged;
+		bool bNeedsSignificance = false;
+		bool bHasWork = false;
+		bool bSignificant = false;
+		bool bTicking = false;
+	};
+
+	/** All registered actors */
+	TArray<FTickSubject> Subjects;
+
+	/** Index into Subjects by actor */
+	TMap<TObjectKey<AActor>, int32> SubjectIndex;
+
+	/** Actors listening for their significance, their tick is left alone */
+	TMap<TObjectKey<AActor>, FGrimRailSignificanceDelegate> Listeners;
+
+	/** Tick scheduler task running the significance update */
+	int32 TickTaskID = INDEX_NONE;
+
+public:
+
+	/**
+	 * Registers an actor. Its tick is disabled until it reports work
+	 * @param Actor Actor to manage the tick of
+	 * @param Tag Groups the actor in the tick report, usually its class
+	 * @param bNeedsSignificance If true, the actor also has to be near and visible to a local player to tick
+	 * @param OnTickStateChanged If bound, called instead of toggling the actor tick, e.g. to pause a tick scheduler task
+	 */
+	void RegisterActor(AActor* Actor, FName Tag, bool bNeedsSignificance, FGrimRailTickStateDelegate OnTickStateChanged = FGrimRailTickStateDelegate());
+
+	/** Unregisters an actor, leaving its tick as it is */
+	void UnregisterActor(AActor* Actor);
+
+	/** Tells the subsystem whether the actor has work to do, and updates its tick right away */
+	void SetHasWork(AActor* Actor, bool bHasWork);
+
+	/**
+	 * Registers an actor that only wants to know its significance. Its tick isn't managed
+	 * @param Actor Actor to evaluate
+	 * @param Tag Groups the actor in the significance manager
+	 * @param OnSignificanceChanged Called with the actor's significance every time it's evaluated
+	 */
+	void RegisterListener(AActor* Actor, FName Tag, FGrimRailSignificanceDelegate OnSignificanceChanged);
+
+	/** Unregisters a significance listener */
+	void UnregisterListener(AActor* Actor);
+
+	//~Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem Interface
+
+	/** Runs the significance update from the tick scheduler's deferrable lane */
+	void ScheduledTick(float DeltaTime);
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem Interface
+
+	/** Returns how significant the actor is from the given viewpoint. Runs on worker threads */
+	float CalculateSignificance(const AActor* Actor, const FTransform& Viewpoint) const;
+
+	/** Enables or disables the subject's tick if it should change */
+	void ApplyTickState(FTickSubject& Subject);
+
+	/** Builds one line per tag with tick counts and reasons */
+	void BuildReport(TArray<FString>& OutLines) const;
+};
@@ -0,0 +1,242 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrimRailStartupSubsystem.h"
+#include "CoreGlobals.h"
+#include "Engine/DataTable.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Parse.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "UObject/UObjectGlobals.h"
+#include "GrimRailDemo.h"
+
+static FAutoConsoleCommandWithWorld GGrimRailStartupReportCommand(
+	TEXT("GrimRail.Startup.Report"),
+	TEXT("Logs how long each phase of the boot took, up to the first interactive frame"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+
+		if (const UGrimRailStartupSubsystem* Startup = GameInstance ? GameInstance->GetSubsystem<UGrimRailStartupSubsystem>() : nullptr)
+		{
+			Startup->LogReport();
+		}
+	}));
+
+bool UGrimRailStartupSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// the editor is booted long before PIE, there's nothing to time or preload
+	return Super::ShouldCreateSubsystem(Outer) && !GIsEditor;
+}
+
+void UGrimRailStartupSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// everything before the game instance came up
+	EndPhase(TEXT("Engine init"));
+
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UGrimRailStartupSubsystem::OnPreLoadMap);
+	ActorsInitializedHandle = FWorldDelegates::OnWorldInitializedActors.AddUObject(this, &UGrimRailStartupSubsystem::OnActorsInitialized);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UGrimRailStartupSubsystem::OnPostLoadMap);
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UGrimRailStartupSubsystem::OnEndFrame);
+
+	// stream the preload list while the map loads, instead of loading it on first use
+	TArray<FSoftObjectPath> AssetsToLoad;
+
+	for (const FSoftObjectPath& Path : PreloadAssets)
+	{
+		if (!Path.IsNull())
+		{
+			AssetsToLoad.Add(Path);
+		}
+	}
+
+	for (const FSoftObjectPath& Path : PreloadTables)
+	{
+		if (!Path.IsNull())
+		{
+			AssetsToLoad.Add(Path);
+		}
+	}
+
+	if (AssetsToLoad.Num() > 0)
+	{
+		NumPreloadAssets = AssetsToLoad.Num();
+		PreloadStartTime = FPlatformTime::Seconds();
+		PreloadHandle = StreamableManager.RequestAsyncLoad(AssetsToLoad, FStreamableDelegate::CreateUObject(this, &UGrimRailStartupSubsystem::OnPreloadDone), FStreamableManager::AsyncLoadHighPriority);
+	}
+}
+
+void UGrimRailStartupSubsystem::Deinitialize()
+{
+	FinishTimeline();
+
+	if (PreloadHandle.IsValid())
+	{
+		PreloadHandle->CancelHandle();
+		PreloadHandle.Reset();
+	}
+
+	if (TableReferencesHandle.IsValid())
+	{
+		TableReferencesHandle->CancelHandle();
+		TableReferencesHandle.Reset();
+	}
+
+	Super::Deinitialize();
+}
+
+void UGrimRailStartupSubsystem::EndPhase(const TCHAR* Name)
+{
+	Phases.Add({ Name, FPlatformTime::Seconds() });
+
+	TRACE_BOOKMARK(TEXT("GrimRail boot: %s done"), Name);
+}
+
+void UGrimRailStartupSubsystem::FinishTimeline()
+{
+	FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+	FWorldDelegates::OnWorldInitializedActors.Remove(ActorsInitializedHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+	bTimelineDone = true;
+}
+
+void UGrimRailStartupSubsystem::OnPreLoadMap(const FString& MapName)
+{
+	EndPhase(TEXT("Game instance start"));
+}
+
+void UGrimRailStartupSubsystem::OnActorsInitialized(const FActorsInitializedParams& Params)
+{
+	// loading the level and initializing its actors, up to BeginPlay
+	if (Params.World && Params.World->IsGameWorld())
+	{
+		EndPhase(TEXT("Map load"));
+	}
+}
+
+void UGrimRailStartupSubsystem::OnPostLoadMap(UWorld* World)
+{
+	// BeginPlay of every actor, including possession and the player's HUD
+	EndPhase(TEXT("Begin play"));
+
+	bWaitingForFirstFrame = true;
+}
+
+void UGrimRailStartupSubsystem::OnEndFrame()
+{
+	if (!bWaitingForFirstFrame)
+	{
+		return;
+	}
+
+	// the first full tick and render of the loaded map
+	EndPhase(TEXT("First frame"));
+
+	FinishTimeline();
+
+	const bool bBenchmark = FParse::Param(FCommandLine::Get(), TEXT("GrimRailBootBenchmark"));
+
+	if (bBenchmark)
+	{
+		LogReport();
+		FPlatformMisc::RequestExitWithStatus(false, 0);
+
+	} else {
+
+		UE_LOG(LogGrimRailDemo, Log, TEXT("GrimRailStartupSubsystem: First interactive frame %.0f ms after process start"), (Phases.Last().EndTime - GStartTime) * 1000.0);
+	}
+}
+
+void UGrimRailStartupSubsystem::OnPreloadDone()
+{
+	// the tables are in, stream what their rows point at before calling the preload done
+	TArray<FSoftObjectPath> References;
+	GatherTableReferences(References);
+
+	if (References.Num() > 0)
+	{
+		NumPreloadAssets += References.Num();
+		TableReferencesHandle = StreamableManager.RequestAsyncLoad(References, FStreamableDelegate::CreateUObject(this, &UGrimRailStartupSubsystem::FinishPreload), FStreamableManager::AsyncLoadHighPriority);
+		return;
+	}
+
+	FinishPreload();
+}
+
+void UGrimRailStartupSubsystem::FinishPreload()
+{
+	PreloadEndTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogGrimRailDemo, Log, TEXT("GrimRailStartupSubsystem: Preloaded %d assets in %.0f ms"), NumPreloadAssets, (PreloadEndTime - PreloadStartTime) * 1000.0);
+}
+
+void UGrimRailStartupSubsystem::GatherTableReferences(TArray<FSoftObjectPath>& OutReferences) const
+{
+	for (const FSoftObjectPath& TablePath : PreloadTables)
+	{
+		const UDataTable* Table = Cast<UDataTable>(TablePath.ResolveObject());
+
+		if (!Table || !Table->GetRowStruct())
+		{
+			continue;
+		}
+
+		// every soft object and soft class reference in every row
+		for (TFieldIterator<FSoftObjectProperty> It(Table->GetRowStruct()); It; ++It)
+		{
+			for (const TPair<FName, uint8*>& Row : Table->GetRowMap())
+			{
+				const FSoftObjectPtr& Reference = It->GetPropertyValue_InContainer(Row.Value);
+
+				if (!Reference.IsNull())
+				{
+					OutReferences.AddUnique(Reference.ToSoftObjectPath());
+				}
+			}
+		}
+	}
+}
+
+void UGrimRailStartupSubsystem::LogReport() const
+{
+	if (!bTimelineDone)
+	{
+		UE_LOG(LogGrimRailDemo, Display, TEXT("GrimRailStartupSubsystem: Boot still in progress"));
+		return;
+	}
+
+	double PhaseStartTime = GStartTime;
+
+	for (const FStartupPhase& Phase : Phases)
+	{
+		UE_LOG(LogGrimRailDemo, Display, TEXT("GrimRailStartupSubsystem: %-20s %8.1f ms (at %8.1f ms)"), Phase.Name, (Phase.EndTime - PhaseStartTime) * 1000.0, (Phase.EndTime - GStartTime) * 1000.0);
+		PhaseStartTime = Phase.EndTime;
+	}
+
+	if (PreloadStartTime <= 0.0)
+	{
+		UE_LOG(LogGrimRailDemo, Display, TEXT("GrimRailStartupSubsystem: Nothing to preload"));
+
+	} else if (PreloadEndTime <= 0.0) {
+
+		UE_LOG(LogGrimRailDemo, Display, TEXT("GrimRailStartupSubsystem: Preload of %d assets still running"), NumPreloadAssets);
+
+	} else {
+
+		// a preload finishing after the first frame is still racing the player
+		const bool bInTime = Phases.Num() > 0 && PreloadEndTime <= Phases.Last().EndTime;
+
+		UE_LOG(LogGrimRailDemo, Display, TEXT("GrimRailStartupSubsystem: Preload of %d assets took %.1f ms, %s the first frame"),
+			NumPreloadAssets, (PreloadEndTime - PreloadStartTime) * 1000.0, bInTime ? TEXT("done before") : TEXT("done after"));
+	}
+}
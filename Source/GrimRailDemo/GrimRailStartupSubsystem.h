@@ -0,0 +1,104 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "GrimRailStartupSubsystem.generated.h"
+
+struct FActorsInitializedParams;
+
+/**
+ *  Times the boot up to the first interactive frame and preloads assets in the background while it runs
+ *  The boot is split into engine init, game instance start, map load, begin play and first frame. Each
+ *  boundary is also an Insights bookmark. Run with -GrimRailBootBenchmark, e.g. together with -nullrhi,
+ *  to log the timeline and quit once the first frame is done
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UGrimRailStartupSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Assets loaded in the background from game instance start, e.g. meshes and widgets needed soon after the map opens */
+	UPROPERTY(Config, EditAnywhere, Category="Startup")
+	TArray<FSoftObjectPath> PreloadAssets;
+
+	/** Data tables loaded in the background along with every asset their rows softly reference, e.g. the weapon table and its pickup meshes */
+	UPROPERTY(Config, EditAnywhere, Category="Startup", meta = (AllowedClasses = "/Script/Engine.DataTable"))
+	TArray<FSoftObjectPath> PreloadTables;
+
+	/** A finished phase of the boot */
+	struct FStartupPhase
+	{
+		const TCHAR* Name;
+		double EndTime;
+	};
+
+	/** Finished phases, in order */
+	TArray<FStartupPhase> Phases;
+
+	/** Time the background preload started and finished, zero until it did */
+	double PreloadStartTime = 0.0;
+	double PreloadEndTime = 0.0;
+
+	/** Keeps the preloaded assets and tables resident */
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+
+	/** Keeps the assets referenced by the preloaded tables resident */
+	TSharedPtr<FStreamableHandle> TableReferencesHandle;
+
+	/** Number of assets preloaded, including the ones referenced by the tables */
+	int32 NumPreloadAssets = 0;
+
+	/** Async loader for the preload */
+	FStreamableManager StreamableManager;
+
+	/** True once the first map finished loading, so the next frame is the first interactive one */
+	bool bWaitingForFirstFrame = false;
+
+	/** True once the timeline is complete */
+	bool bTimelineDone = false;
+
+	/** Delegate handles */
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle ActorsInitializedHandle;
+	FDelegateHandle PostLoadMapHandle;
+	FDelegateHandle EndFrameHandle;
+
+public:
+
+	//~Begin USubsystem Interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem Interface
+
+	/** Logs the boot timeline */
+	void LogReport() const;
+
+protected:
+
+	/** Ends the current phase */
+	void EndPhase(const TCHAR* Name);
+
+	/** Stops listening to the boot once the first frame is done */
+	void FinishTimeline();
+
+	/** Boot callbacks */
+	void OnPreLoadMap(const FString& MapName);
+	void OnActorsInitialized(const FActorsInitializedParams& Params);
+	void OnPostLoadMap(UWorld* World);
+	void OnEndFrame();
+
+	/** Called when the preload assets and tables are loaded. Starts loading what the tables reference */
+	void OnPreloadDone();
+
+	/** Called when the whole background preload is done */
+	void FinishPreload();
+
+	/** Gathers the soft references in every row of the preloaded tables */
+	void GatherTableReferences(TArray<FSoftObjectPath>& OutReferences) const;
+};
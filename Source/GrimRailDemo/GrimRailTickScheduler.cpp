@@ -0,0 +1,478 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrimRailTickScheduler.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "GrimRailDemo.h"
+
+TRACE_DECLARE_FLOAT_COUNTER(GrimRailTickCriticalMs, TEXT("GrimRail/Tick/Critical (ms)"));
+TRACE_DECLARE_FLOAT_COUNTER(GrimRailTickNormalMs, TEXT("GrimRail/Tick/Normal (ms)"));
+TRACE_DECLARE_FLOAT_COUNTER(GrimRailTickDeferrableMs, TEXT("GrimRail/Tick/Deferrable (ms)"));
+TRACE_DECLARE_INT_COUNTER(GrimRailTickDeferred, TEXT("GrimRail/Tick/Deferred Tasks"));
+TRACE_DECLARE_FLOAT_COUNTER(GrimRailJobWaitMs, TEXT("GrimRail/Jobs/Wait (ms)"));
+TRACE_DECLARE_FLOAT_COUNTER(GrimRailJobCommitMs, TEXT("GrimRail/Jobs/Commit (ms)"));
+
+static bool GGrimRailParallelJobs = true;
+static FAutoConsoleVariableRef CVarGrimRailParallelJobs(
+	TEXT("GrimRail.Jobs.Parallel"),
+	GGrimRailParallelJobs,
+	TEXT("If true, GrimRail jobs prepare on worker threads while the tick lanes run. If false, they prepare on the game thread one after the other"));
+
+static FAutoConsoleCommandWithWorld GGrimRailSchedulerReportCommand(
+	TEXT("GrimRail.Scheduler.Report"),
+	TEXT("Logs the tasks registered with the GrimRail tick scheduler and last frame's lane times"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UGrimRailTickScheduler* Scheduler = World ? World->GetSubsystem<UGrimRailTickScheduler>() : nullptr)
+		{
+			Scheduler->LogReport();
+		}
+	}));
+
+namespace GrimRailTickScheduler
+{
+	static const TCHAR* GetLaneName(EGrimRailTickLane Lane)
+	{
+		switch (Lane)
+		{
+		case EGrimRailTickLane::Critical:
+			return TEXT("Critical");
+		case EGrimRailTickLane::Normal:
+			return TEXT("Normal");
+		case EGrimRailTickLane::Deferrable:
+			return TEXT("Deferrable");
+		default:
+			return TEXT("Unknown");
+		}
+	}
+}
+
+bool UGrimRailTickScheduler::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UGrimRailTickScheduler::RegisterTask(FName Name, EGrimRailTickLane Lane, FGrimRailTickDelegate Delegate, bool bEnabled)
+{
+	if (!Delegate.IsBound() || Lane >= EGrimRailTickLane::Num)
+	{
+		return INDEX_NONE;
+	}
+
+	TArray<FScheduledTask>& Tasks = Lanes[static_cast<int32>(Lane)];
+
+	FScheduledTask& Task = Tasks.AddDefaulted_GetRef();
+	Task.ID = NextID++;
+	Task.Name = Name;
+	Task.Delegate = MoveTemp(Delegate);
+	Task.bEnabled = bEnabled;
+
+	TaskLocations.Add(Task.ID, { Lane, Tasks.Num() - 1 });
+
+	return Task.ID;
+}
+
+void UGrimRailTickScheduler::UnregisterTask(int32 TaskID)
+{
+	const FTaskLocation* Location = TaskLocations.Find(TaskID);
+
+	if (!Location)
+	{
+		return;
+	}
+
+	// don't reorder a lane while it's being walked, just stop the task from running again
+	if (bRunning)
+	{
+		Lanes[static_cast<int32>(Location->Lane)][Location->Index].bEnabled = false;
+
+		PendingRemovals.AddUnique(TaskID);
+		return;
+	}
+
+	RemoveTask(TaskID);
+}
+
+void UGrimRailTickScheduler::SetTaskEnabled(int32 TaskID, bool bEnabled)
+{
+	if (const FTaskLocation* Location = TaskLocations.Find(TaskID))
+	{
+		FScheduledTask& Task = Lanes[static_cast<int32>(Location->Lane)][Location->Index];
+
+		if (Task.bEnabled != bEnabled)
+		{
+			Task.bEnabled = bEnabled;
+			Task.PendingDeltaTime = 0.0f;
+		}
+	}
+}
+
+void UGrimRailTickScheduler::RemoveTask(int32 TaskID)
+{
+	FTaskLocation Location;
+
+	if (!TaskLocations.RemoveAndCopyValue(TaskID, Location))
+	{
+		return;
+	}
+
+	TArray<FScheduledTask>& Tasks = Lanes[static_cast<int32>(Location.Lane)];
+
+	// swap the last task into the hole and fix up its location
+	Tasks.RemoveAtSwap(Location.Index, EAllowShrinking::No);
+
+	if (Tasks.IsValidIndex(Location.Index))
+	{
+		TaskLocations.Add(Tasks[Location.Index].ID, Location);
+	}
+}
+
+int32 UGrimRailTickScheduler::RegisterJob(FName Name, IGrimRailJob* Job, UObject* Owner, EGrimRailJobData Reads, EGrimRailJobData Writes)
+{
+	if (!Job || !Owner)
+	{
+		return INDEX_NONE;
+	}
+
+	FScheduledJob& ScheduledJob = Jobs.AddDefaulted_GetRef();
+	ScheduledJob.ID = NextID++;
+	ScheduledJob.Name = Name;
+	ScheduledJob.Job = Job;
+	ScheduledJob.Owner = Owner;
+	ScheduledJob.Reads = Reads;
+	ScheduledJob.Writes = Writes;
+
+	bJobGraphDirty = true;
+
+	return ScheduledJob.ID;
+}
+
+void UGrimRailTickScheduler::UnregisterJob(int32 JobID)
+{
+	const int32 Index = Jobs.IndexOfByPredicate([JobID](const FScheduledJob& ScheduledJob)
+	{
+		return ScheduledJob.ID == JobID;
+	});
+
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	// its prepare phase may still be running, skip the commit and drop it once the frame is done
+	if (bRunning)
+	{
+		Jobs[Index].bGathered = false;
+
+		PendingJobRemovals.AddUnique(JobID);
+		return;
+	}
+
+	// keep registration order, later jobs depend on it
+	Jobs.RemoveAt(Index, EAllowShrinking::No);
+
+	bJobGraphDirty = true;
+}
+
+void UGrimRailTickScheduler::RebuildJobGraph()
+{
+	for (int32 Index = 0; Index < Jobs.Num(); ++Index)
+	{
+		FScheduledJob& ScheduledJob = Jobs[Index];
+		ScheduledJob.Prerequisites.Reset();
+
+		// wait for every earlier job writing what this one touches, or reading what this one writes
+		for (int32 EarlierIndex = 0; EarlierIndex < Index; ++EarlierIndex)
+		{
+			const FScheduledJob& EarlierJob = Jobs[EarlierIndex];
+
+			if (EnumHasAnyFlags(EarlierJob.Writes, ScheduledJob.Reads | ScheduledJob.Writes) || EnumHasAnyFlags(EarlierJob.Reads, ScheduledJob.Writes))
+			{
+				ScheduledJob.Prerequisites.Add(EarlierIndex);
+			}
+		}
+	}
+
+	bJobGraphDirty = false;
+}
+
+void UGrimRailTickScheduler::LaunchJobs(float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(GrimRailJobs_Gather);
+
+	if (bJobGraphDirty)
+	{
+		RebuildJobGraph();
+	}
+
+	// jobs registered along the way are left for the next frame
+	const int32 NumJobs = Jobs.Num();
+
+	for (int32 Index = 0; Index < NumJobs; ++Index)
+	{
+		FScheduledJob& ScheduledJob = Jobs[Index];
+		ScheduledJob.PrepareTask = UE::Tasks::FTask();
+		ScheduledJob.bGathered = ScheduledJob.Owner.IsValid() && ScheduledJob.Job->GatherJob(DeltaTime);
+
+		if (!ScheduledJob.bGathered)
+		{
+			continue;
+		}
+
+		IGrimRailJob* Job = ScheduledJob.Job;
+
+		if (!GGrimRailParallelJobs)
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(GrimRailJob_Prepare);
+			Job->PrepareJob();
+			continue;
+		}
+
+		TArray<UE::Tasks::FTask, TInlineAllocator<8>> Prerequisites;
+
+		for (int32 PrerequisiteIndex : ScheduledJob.Prerequisites)
+		{
+			if (Jobs[PrerequisiteIndex].PrepareTask.IsValid())
+			{
+				Prerequisites.Add(Jobs[PrerequisiteIndex].PrepareTask);
+			}
+		}
+
+		ScheduledJob.PrepareTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Job]()
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(GrimRailJob_Prepare);
+			Job->PrepareJob();
+
+		}, Prerequisites);
+	}
+}
+
+void UGrimRailTickScheduler::CommitJobs()
+{
+	double StartTime = FPlatformTime::Seconds();
+
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(GrimRailJobs_Wait);
+
+		// commits may touch anything, so every prepare phase has to be done first
+		for (FScheduledJob& ScheduledJob : Jobs)
+		{
+			if (ScheduledJob.PrepareTask.IsValid())
+			{
+				ScheduledJob.PrepareTask.Wait();
+				ScheduledJob.PrepareTask = UE::Tasks::FTask();
+			}
+		}
+	}
+
+	double EndTime = FPlatformTime::Seconds();
+	JobWaitMs = static_cast<float>((EndTime - StartTime) * 1000.0);
+	StartTime = EndTime;
+
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(GrimRailJobs_Commit);
+
+		for (int32 Index = 0; Index < Jobs.Num(); ++Index)
+		{
+			if (Jobs[Index].bGathered)
+			{
+				Jobs[Index].bGathered = false;
+				Jobs[Index].Job->CommitJob();
+			}
+		}
+	}
+
+	JobCommitMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void UGrimRailTickScheduler::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(GrimRailTickScheduler);
+
+	const double FrameStartTime = FPlatformTime::Seconds();
+
+	// deferrable tasks catch up on every frame they miss
+	for (FScheduledTask& Task : Lanes[static_cast<int32>(EGrimRailTickLane::Deferrable)])
+	{
+		if (Task.bEnabled)
+		{
+			Task.PendingDeltaTime += DeltaTime;
+		}
+	}
+
+	bRunning = true;
+
+	// jobs prepare on worker threads while the critical and normal lanes run
+	LaunchJobs(DeltaTime);
+
+	double LaneStartTime = FPlatformTime::Seconds();
+
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(GrimRailTick_Critical);
+		RunLane(EGrimRailTickLane::Critical, DeltaTime);
+	}
+
+	double LaneEndTime = FPlatformTime::Seconds();
+	LaneTimeMs[static_cast<int32>(EGrimRailTickLane::Critical)] = static_cast<float>((LaneEndTime - LaneStartTime) * 1000.0);
+	LaneStartTime = LaneEndTime;
+
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(GrimRailTick_Normal);
+		RunLane(EGrimRailTickLane::Normal, DeltaTime);
+	}
+
+	LaneEndTime = FPlatformTime::Seconds();
+	LaneTimeMs[static_cast<int32>(EGrimRailTickLane::Normal)] = static_cast<float>((LaneEndTime - LaneStartTime) * 1000.0);
+
+	CommitJobs();
+
+	LaneStartTime = FPlatformTime::Seconds();
+
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(GrimRailTick_Deferrable);
+		RunDeferrableLane(FrameStartTime);
+	}
+
+	LaneEndTime = FPlatformTime::Seconds();
+	LaneTimeMs[static_cast<int32>(EGrimRailTickLane::Deferrable)] = static_cast<float>((LaneEndTime - LaneStartTime) * 1000.0);
+
+	bRunning = false;
+
+	// now it's safe to drop the tasks unregistered along the way
+	for (int32 TaskID : PendingRemovals)
+	{
+		RemoveTask(TaskID);
+	}
+
+	PendingRemovals.Reset();
+
+	for (int32 JobID : PendingJobRemovals)
+	{
+		UnregisterJob(JobID);
+	}
+
+	PendingJobRemovals.Reset();
+
+	TRACE_COUNTER_SET(GrimRailTickCriticalMs, LaneTimeMs[static_cast<int32>(EGrimRailTickLane::Critical)]);
+	TRACE_COUNTER_SET(GrimRailTickNormalMs, LaneTimeMs[static_cast<int32>(EGrimRailTickLane::Normal)]);
+	TRACE_COUNTER_SET(GrimRailTickDeferrableMs, LaneTimeMs[static_cast<int32>(EGrimRailTickLane::Deferrable)]);
+	TRACE_COUNTER_SET(GrimRailTickDeferred, NumDeferred);
+	TRACE_COUNTER_SET(GrimRailJobWaitMs, JobWaitMs);
+	TRACE_COUNTER_SET(GrimRailJobCommitMs, JobCommitMs);
+}
+
+TStatId UGrimRailTickScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGrimRailTickScheduler, STATGROUP_Tickables);
+}
+
+void UGrimRailTickScheduler::RunLane(EGrimRailTickLane Lane, float DeltaTime)
+{
+	TArray<FScheduledTask>& Tasks = Lanes[static_cast<int32>(Lane)];
+
+	// tasks registered along the way run this frame too
+	for (int32 Index = 0; Index < Tasks.Num(); ++Index)
+	{
+		if (Tasks[Index].bEnabled)
+		{
+			Tasks[Index].Delegate.ExecuteIfBound(DeltaTime);
+		}
+	}
+}
+
+void UGrimRailTickScheduler::RunDeferrableLane(double FrameStartTime)
+{
+	TArray<FScheduledTask>& Tasks = Lanes[static_cast<int32>(EGrimRailTickLane::Deferrable)];
+	const int32 NumTasks = Tasks.Num();
+	const double BudgetEndTime = FrameStartTime + FrameBudgetMs / 1000.0;
+
+	NumDeferred = 0;
+
+	if (NumTasks == 0)
+	{
+		return;
+	}
+
+	// start where the last frame ran out, so every task gets its turn
+	const int32 StartIndex = DeferrableCursor % NumTasks;
+	int32 FirstDeferredIndex = INDEX_NONE;
+
+	for (int32 Step = 0; Step < NumTasks; ++Step)
+	{
+		const int32 Index = (StartIndex + Step) % NumTasks;
+
+		if (!Tasks[Index].bEnabled)
+		{
+			continue;
+		}
+
+		// over budget, push it back unless it has waited too long already
+		if (FPlatformTime::Seconds() >= BudgetEndTime && Tasks[Index].PendingDeltaTime < MaxDeferTime)
+		{
+			if (FirstDeferredIndex == INDEX_NONE)
+			{
+				FirstDeferredIndex = Index;
+			}
+
+			++NumDeferred;
+			continue;
+		}
+
+		const float DeltaTime = Tasks[Index].PendingDeltaTime;
+		Tasks[Index].PendingDeltaTime = 0.0f;
+
+		Tasks[Index].Delegate.ExecuteIfBound(DeltaTime);
+	}
+
+	DeferrableCursor = FirstDeferredIndex != INDEX_NONE ? FirstDeferredIndex : 0;
+}
+
+void UGrimRailTickScheduler::LogReport() const
+{
+	UE_LOG(LogGrimRailDemo, Log, TEXT("GrimRailTickScheduler: %.1f ms budget, %d deferred last frame"), FrameBudgetMs, NumDeferred);
+
+	for (int32 LaneIndex = 0; LaneIndex < static_cast<int32>(EGrimRailTickLane::Num); ++LaneIndex)
+	{
+		const TArray<FScheduledTask>& Tasks = Lanes[LaneIndex];
+
+		// group the tasks by name, many actors share one
+		TMap<FName, int32> EnabledByName;
+		TMap<FName, int32> TotalByName;
+
+		for (const FScheduledTask& Task : Tasks)
+		{
+			++TotalByName.FindOrAdd(Task.Name);
+
+			if (Task.bEnabled)
+			{
+				++EnabledByName.FindOrAdd(Task.Name);
+			}
+		}
+
+		UE_LOG(LogGrimRailDemo, Log, TEXT("GrimRailTickScheduler:   %s lane: %d tasks, %.3f ms"), GrimRailTickScheduler::GetLaneName(static_cast<EGrimRailTickLane>(LaneIndex)), Tasks.Num(), LaneTimeMs[LaneIndex]);
+
+		for (const TPair<FName, int32>& Pair : TotalByName)
+		{
+			UE_LOG(LogGrimRailDemo, Log, TEXT("GrimRailTickScheduler:     %s: %d of %d running"), *Pair.Key.ToString(), EnabledByName.FindRef(Pair.Key), Pair.Value);
+		}
+	}
+
+	UE_LOG(LogGrimRailDemo, Log, TEXT("GrimRailTickScheduler:   %d jobs, %s, %.3f ms waiting, %.3f ms committing"), Jobs.Num(), GGrimRailParallelJobs ? TEXT("parallel") : TEXT("inline"), JobWaitMs, JobCommitMs);
+
+	for (const FScheduledJob& ScheduledJob : Jobs)
+	{
+		TArray<FString> PrerequisiteNames;
+
+		for (int32 PrerequisiteIndex : ScheduledJob.Prerequisites)
+		{
+			PrerequisiteNames.Add(Jobs[PrerequisiteIndex].Name.ToString());
+		}
+
+		UE_LOG(LogGrimRailDemo, Log, TEXT("GrimRailTickScheduler:     %s: waits for [%s]"), *ScheduledJob.Name.ToString(), *FString::Join(PrerequisiteNames, TEXT(", ")));
+	}
+}
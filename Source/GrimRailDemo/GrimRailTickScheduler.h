@@ -0,0 +1,233 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "GrimRailTickScheduler.generated.h"
+
+/** Per frame gameplay work, receives the time since the task last ran */
+DECLARE_DELEGATE_OneParam(FGrimRailTickDelegate, float /*DeltaTime*/);
+
+/** How urgently a scheduled task has to run */
+enum class EGrimRailTickLane : uint8
+{
+	/** Runs every frame before anything else, e.g. movement and anything the player is attached to */
+	Critical,
+
+	/** Runs every frame */
+	Normal,
+
+	/** Runs while there's frame budget left, otherwise slides to a later frame, e.g. cosmetics */
+	Deferrable,
+
+	Num
+};
+
+/** Data a job's prepare phase reads or writes, used to decide which jobs may prepare at the same time */
+enum class EGrimRailJobData : uint32
+{
+	None = 0,
+
+	/** Character stamina values */
+	Stamina = 1 << 0,
+
+	/** Light exposure values */
+	LightExposure = 1 << 1,
+
+	/** Collectible locations and rotations */
+	CollectibleTransforms = 1 << 2
+};
+
+ENUM_CLASS_FLAGS(EGrimRailJobData);
+
+/**
+ *  Per frame work split so the bulk of it can run on worker threads
+ *  Gather and commit run on the game thread. Prepare runs on a worker, overlapping the tick lanes, and may
+ *  only touch what gather copied out and the data declared when the job was registered
+ */
+class IGrimRailJob
+{
+public:
+
+	virtual ~IGrimRailJob() = default;
+
+	/**
+	 * Copies what the prepare phase needs. Game thread
+	 * @param DeltaTime Frame time
+	 * @return False to skip the job this frame
+	 */
+	virtual bool GatherJob(float DeltaTime) = 0;
+
+	/** Does the work on the gathered copy. Worker thread */
+	virtual void PrepareJob() = 0;
+
+	/** Applies the prepared results. Game thread */
+	virtual void CommitJob() = 0;
+};
+
+/**
+ *  Runs GrimRail's per frame gameplay work from one place
+ *  Systems register tasks on a lane instead of ticking themselves. Critical and normal tasks always run.
+ *  Deferrable tasks run round robin while the frame budget lasts and catch up on the time they missed.
+ *  Jobs are gathered at the start of the frame, prepare on worker threads while the critical and normal lanes
+ *  run, and commit after them. Jobs whose declared data overlaps prepare one after the other.
+ *  Each lane's time is traced for Insights
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UGrimRailTickScheduler : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Time per frame all lanes together may use before deferrable tasks are pushed to later frames */
+	UPROPERTY(Config, EditAnywhere, Category="Scheduler", meta = (ClampMin = 0, Units = "ms"))
+	float FrameBudgetMs = 2.0f;
+
+	/** Longest a deferrable task can be pushed back before it runs regardless of the budget */
+	UPROPERTY(Config, EditAnywhere, Category="Scheduler", meta = (ClampMin = 0, Units = "s"))
+	float MaxDeferTime = 0.25f;
+
+	/** A registered task */
+	struct FScheduledTask
+	{
+		int32 ID = INDEX_NONE;
+		FName Name;
+		FGrimRailTickDelegate Delegate;
+		float PendingDeltaTime = 0.0f;
+		bool bEnabled = true;
+	};
+
+	/** A registered job */
+	struct FScheduledJob
+	{
+		int32 ID = INDEX_NONE;
+		FName Name;
+		IGrimRailJob* Job = nullptr;
+		TWeakObjectPtr<UObject> Owner;
+		EGrimRailJobData Reads = EGrimRailJobData::None;
+		EGrimRailJobData Writes = EGrimRailJobData::None;
+
+		/** Earlier jobs that must finish preparing first */
+		TArray<int32> Prerequisites;
+
+		/** True if the job was gathered this frame */
+		bool bGathered = false;
+
+		/** Prepare phase this frame */
+		UE::Tasks::FTask PrepareTask;
+	};
+
+	/** Where a task lives */
+	struct FTaskLocation
+	{
+		EGrimRailTickLane Lane;
+		int32 Index;
+	};
+
+	/** Registered tasks of each lane */
+	TArray<FScheduledTask> Lanes[static_cast<int32>(EGrimRailTickLane::Num)];
+
+	/** Task location by ID */
+	TMap<int32, FTaskLocation> TaskLocations;
+
+	/** Tasks unregistered while the lanes were running, removed once they're done */
+	TArray<int32> PendingRemovals;
+
+	/** Registered jobs, in registration order */
+	TArray<FScheduledJob> Jobs;
+
+	/** Jobs unregistered while they were running, removed once the frame is done */
+	TArray<int32> PendingJobRemovals;
+
+	/** True if the job prerequisites need to be worked out again */
+	bool bJobGraphDirty = false;
+
+	/** Deferrable task the next frame starts with */
+	int32 DeferrableCursor = 0;
+
+	/** Next task ID */
+	int32 NextID = 0;
+
+	/** True while the lanes are running */
+	bool bRunning = false;
+
+	/** Time each lane took last frame, in milliseconds */
+	float LaneTimeMs[static_cast<int32>(EGrimRailTickLane::Num)] = {};
+
+	/** Number of deferrable tasks pushed to a later frame last frame */
+	int32 NumDeferred = 0;
+
+	/** Time the game thread waited for job prepare phases and spent committing last frame, in milliseconds */
+	float JobWaitMs = 0.0f;
+	float JobCommitMs = 0.0f;
+
+public:
+
+	/**
+	 * Registers a task
+	 * @param Name Name shown in the scheduler report
+	 * @param Lane How urgently the task has to run
+	 * @param Delegate Work to run
+	 * @param bEnabled Whether the task starts out running
+	 * @return ID used to refer to the task
+	 */
+	int32 RegisterTask(FName Name, EGrimRailTickLane Lane, FGrimRailTickDelegate Delegate, bool bEnabled = true);
+
+	/** Unregisters a task. Safe to call from inside a task */
+	void UnregisterTask(int32 TaskID);
+
+	/** Pauses or resumes a task. A resumed task doesn't catch up on the time it was paused */
+	void SetTaskEnabled(int32 TaskID, bool bEnabled);
+
+	/**
+	 * Registers a job
+	 * @param Name Name shown in the scheduler report and traces
+	 * @param Job Job to run every frame
+	 * @param Owner Object owning the job, the job is skipped once it's destroyed
+	 * @param Reads Data the prepare phase reads besides its own copy
+	 * @param Writes Data the prepare phase writes
+	 * @return ID used to refer to the job
+	 */
+	int32 RegisterJob(FName Name, IGrimRailJob* Job, UObject* Owner, EGrimRailJobData Reads, EGrimRailJobData Writes);
+
+	/** Unregisters a job. Safe to call from inside a job's game thread phases */
+	void UnregisterJob(int32 JobID);
+
+	/** Logs the registered tasks and last frame's lane times */
+	void LogReport() const;
+
+	/** Returns the time a lane took last frame, in milliseconds */
+	float GetLaneTimeMs(EGrimRailTickLane Lane) const { return LaneTimeMs[static_cast<int32>(Lane)]; }
+
+	//~Begin UTickableWorldSubsystem Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End UTickableWorldSubsystem Interface
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem Interface
+
+	/** Runs every enabled task of a lane */
+	void RunLane(EGrimRailTickLane Lane, float DeltaTime);
+
+	/** Runs deferrable tasks until the frame budget runs out */
+	void RunDeferrableLane(double FrameStartTime);
+
+	/** Removes a task right away */
+	void RemoveTask(int32 TaskID);
+
+	/** Gathers the jobs and launches their prepare phases */
+	void LaunchJobs(float DeltaTime);
+
+	/** Waits for the prepare phases and commits the jobs */
+	void CommitJobs();
+
+	/** Works out which jobs have to wait for which */
+	void RebuildJobGraph();
+};
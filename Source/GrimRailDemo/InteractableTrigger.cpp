@@ -3,6 +3,9 @@
 #include "InteractableTrigger.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/BoxComponent.h"
+#include "Engine/World.h"
+#include "InteractionSubsystem.h"
+#include "SignalSubsystem.h"
 
 AInteractableTrigger::AInteractableTrigger()
 {
@@ -34,6 +37,22 @@ AInteractableTrigger::AInteractableTrigger()
 void AInteractableTrigger::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// Register for interaction focus scoring
+	if (UInteractionSubsystem* InteractionSubsystem = GetWorld()->GetSubsystem<UInteractionSubsystem>())
+	{
+		InteractionSubsystem->RegisterInteractable(this, InteractionPriority);
+	}
+}
+
+void AInteractableTrigger::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UInteractionSubsystem* InteractionSubsystem = GetWorld()->GetSubsystem<UInteractionSubsystem>())
+	{
+		InteractionSubsystem->UnregisterInteractable(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AInteractableTrigger::OnInteractionFocus_Implementation(APlayerController* PlayerController)
@@ -63,11 +82,29 @@ bool AInteractableTrigger::OnInteract_Implementation(APlayerController* PlayerCo
 	if (bSingleUse)
 	{
 		bHasBeenUsed = true;
+
+		// Let focus checks know this is no longer interactable
+		if (UInteractionSubsystem* InteractionSubsystem = GetWorld()->GetSubsystem<UInteractionSubsystem>())
+		{
+			InteractionSubsystem->NotifyInteractableChanged(this);
+		}
 	}
 
 	// Call Blueprint event
 	BP_OnTriggered(PlayerController);
 
+	// Activate everything listening to our signals
+	if (EmittedSignals.Num() > 0)
+	{
+		if (USignalSubsystem* SignalSubsystem = GetWorld()->GetSubsystem<USignalSubsystem>())
+		{
+			for (const FName& Signal : EmittedSignals)
+			{
+				SignalSubsystem->EmitSignal(Signal, this);
+			}
+		}
+	}
+
 	UE_LOG(LogTemp, Log, TEXT("InteractableTrigger '%s' triggered by player"), *GetName());
 
 	return true;
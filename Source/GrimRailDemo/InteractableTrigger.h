@@ -33,6 +33,10 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
 	FText InteractionPromptText;
 
+	/** Focus priority over other nearby interactables */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction", meta = (ClampMin = 0.1, ClampMax = 10))
+	float InteractionPriority = 1.0f;
+
 	/** Whether this trigger can currently be interacted with */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
 	bool bCanInteract = true;
@@ -45,6 +49,10 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "Interaction")
 	bool bHasBeenUsed = false;
 
+	/** Signals emitted when the trigger is used. Receivers listening to them are activated */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Signals")
+	TArray<FName> EmittedSignals;
+
 public:
 
 	AInteractableTrigger();
@@ -52,6 +60,7 @@ public:
 protected:
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 
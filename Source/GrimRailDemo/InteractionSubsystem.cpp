@@ -0,0 +1,342 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "InteractionSubsystem.h"
+#include "GrimRailTickScheduler.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Interactable.h"
+
+namespace InteractionSubsystem
+{
+	/** Number of top scoring candidates checked for line of sight before giving up */
+	static constexpr int32 MaxLineOfSightChecks = 3;
+}
+
+void UInteractionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// run from the tick scheduler instead of ticking on our own
+	if (UGrimRailTickScheduler* Scheduler = Collection.InitializeDependency<UGrimRailTickScheduler>())
+	{
+		TickTaskID = Scheduler->RegisterTask(TEXT("Interaction"), EGrimRailTickLane::Normal, FGrimRailTickDelegate::CreateUObject(this, &UInteractionSubsystem::ScheduledTick));
+	}
+}
+
+void UInteractionSubsystem::Deinitialize()
+{
+	if (UGrimRailTickScheduler* Scheduler = GetWorld()->GetSubsystem<UGrimRailTickScheduler>())
+	{
+		Scheduler->UnregisterTask(TickTaskID);
+	}
+
+	TickTaskID = INDEX_NONE;
+
+	Super::Deinitialize();
+}
+
+void UInteractionSubsystem::ScheduledTick(float DeltaTime)
+{
+	// nobody asked this frame
+	if (PendingViewers.Num() == 0)
+	{
+		return;
+	}
+
+	// take the queue, viewers may queue themselves again while receiving their result
+	TArray<FPendingViewer, TInlineAllocator<4>> Viewers;
+	TArray<FInteractionQuery, TInlineAllocator<4>> Queries;
+
+	for (const FPendingViewer& Pending : PendingViewers)
+	{
+		FInteractionQuery Query;
+
+		if (Pending.Owner.IsValid() && Pending.Viewer->BuildInteractionQuery(Query))
+		{
+			Viewers.Add(Pending);
+			Queries.Add(Query);
+		}
+	}
+
+	PendingViewers.Reset();
+
+	TArray<AActor*, TInlineAllocator<4>> Results;
+	Results.SetNumZeroed(Queries.Num());
+
+	FindBestInteractables(Queries, Results);
+
+	for (int32 Index = 0; Index < Viewers.Num(); ++Index)
+	{
+		// an earlier result may have ended play for a later viewer
+		if (Viewers[Index].Owner.IsValid())
+		{
+			Viewers[Index].Viewer->ReceiveInteractionResult(Results[Index]);
+		}
+	}
+}
+
+bool UInteractionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UInteractionSubsystem::RegisterInteractable(AActor* Actor, float Priority)
+{
+	if (!Actor || InteractableIndex.Contains(Actor))
+	{
+		return;
+	}
+
+	FRegisteredInteractable& Entry = Interactables.AddDefaulted_GetRef();
+	Entry.Actor = Actor;
+	Entry.Priority = FMath::Max(Priority, KINDA_SMALL_NUMBER);
+
+	InteractableIndex.Add(Actor, Interactables.Num() - 1);
+	++Revision;
+}
+
+void UInteractionSubsystem::UnregisterInteractable(AActor* Actor)
+{
+	int32 Index = INDEX_NONE;
+
+	if (!InteractableIndex.RemoveAndCopyValue(Actor, Index))
+	{
+		return;
+	}
+
+	// swap the last entry into the hole and fix up its index
+	Interactables.RemoveAtSwap(Index, EAllowShrinking::No);
+	++Revision;
+
+	if (Interactables.IsValidIndex(Index))
+	{
+		if (AActor* MovedActor = Interactables[Index].Actor.Get())
+		{
+			InteractableIndex.Add(MovedActor, Index);
+		}
+	}
+}
+
+void UInteractionSubsystem::NotifyInteractableChanged(AActor* Actor)
+{
+	InvalidatePrompt(Actor);
+	++Revision;
+}
+
+bool UInteractionSubsystem::HasInteractableWithin(const FVector& Location, float Radius) const
+{
+	const float RadiusSquared = FMath::Square(Radius);
+
+	for (const FRegisteredInteractable& Entry : Interactables)
+	{
+		const AActor* Actor = Entry.Actor.Get();
+
+		if (Actor && FVector::DistSquared(Actor->GetActorLocation(), Location) <= RadiusSquared)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+AActor* UInteractionSubsystem::FindBestInteractable(const FInteractionQuery& Query) const
+{
+	AActor* Result = nullptr;
+	FindBestInteractables(MakeArrayView(&Query, 1), MakeArrayView(&Result, 1));
+
+	return Result;
+}
+
+void UInteractionSubsystem::FindBestInteractables(TConstArrayView<FInteractionQuery> Queries, TArrayView<AActor*> OutResults) const
+{
+	check(Queries.Num() == OutResults.Num());
+
+	struct FCandidate
+	{
+		AActor* Actor;
+		float Score;
+	};
+
+	// per query limits, worked out once for the whole pass
+	struct FQueryLimits
+	{
+		float MaxDistanceSquared;
+		float MinCosAngle;
+		TArray<FCandidate, TInlineAllocator<16>> Candidates;
+	};
+
+	TArray<FQueryLimits, TInlineAllocator<4>> Limits;
+	Limits.SetNum(Queries.Num());
+
+	for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+	{
+		Limits[QueryIndex].MaxDistanceSquared = FMath::Square(Queries[QueryIndex].MaxDistance);
+		Limits[QueryIndex].MinCosAngle = FMath::Cos(FMath::DegreesToRadians(Queries[QueryIndex].MaxAngle));
+	}
+
+	// walk the interactables once, scoring each against every viewpoint
+	for (const FRegisteredInteractable& Entry : Interactables)
+	{
+		AActor* Actor = Entry.Actor.Get();
+
+		if (!Actor)
+		{
+			continue;
+		}
+
+		const FVector ActorLocation = Actor->GetActorLocation();
+
+		for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+		{
+			const FInteractionQuery& Query = Queries[QueryIndex];
+			FQueryLimits& Limit = Limits[QueryIndex];
+
+			// cheap rejections first
+			const FVector ToActor = ActorLocation - Query.ViewLocation;
+			const float DistanceSquared = ToActor.SizeSquared();
+
+			if (DistanceSquared > Limit.MaxDistanceSquared)
+			{
+				continue;
+			}
+
+			const float Distance = FMath::Sqrt(DistanceSquared);
+			const float CosAngle = Distance > KINDA_SMALL_NUMBER ? FVector::DotProduct(ToActor / Distance, Query.ViewDirection) : 1.0f;
+
+			if (CosAngle < Limit.MinCosAngle)
+			{
+				continue;
+			}
+
+			// centered and close score highest, weighted by priority
+			const float AngleScore = (CosAngle - Limit.MinCosAngle) / FMath::Max(1.0f - Limit.MinCosAngle, KINDA_SMALL_NUMBER);
+			const float DistanceScore = 1.0f - Distance / FMath::Max(Query.MaxDistance, KINDA_SMALL_NUMBER);
+			float Score = Entry.Priority * (0.65f * AngleScore + 0.35f * DistanceScore);
+
+			// the current focus has to be beaten by a margin before it changes
+			if (Actor == Query.CurrentFocus)
+			{
+				Score *= 1.0f + Query.Hysteresis;
+			}
+
+			Limit.Candidates.Add({ Actor, Score });
+		}
+	}
+
+	for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+	{
+		const FInteractionQuery& Query = Queries[QueryIndex];
+		TArray<FCandidate, TInlineAllocator<16>>& Candidates = Limits[QueryIndex].Candidates;
+
+		OutResults[QueryIndex] = nullptr;
+
+		Candidates.Sort([](const FCandidate& A, const FCandidate& B)
+		{
+			return A.Score > B.Score;
+		});
+
+		// only trace the best few, most of the time the winner is the first one
+		const int32 NumChecks = FMath::Min(Candidates.Num(), InteractionSubsystem::MaxLineOfSightChecks);
+
+		for (int32 CandidateIndex = 0; CandidateIndex < NumChecks; ++CandidateIndex)
+		{
+			AActor* Actor = Candidates[CandidateIndex].Actor;
+
+			if (IInteractable::Execute_CanInteract(Actor, Query.PlayerController) && HasLineOfSight(Query, Actor))
+			{
+				OutResults[QueryIndex] = Actor;
+				break;
+			}
+		}
+	}
+}
+
+void UInteractionSubsystem::QueueViewer(IInteractionViewer* Viewer, UObject* Owner)
+{
+	if (!Viewer || !Owner)
+	{
+		return;
+	}
+
+	const bool bQueued = PendingViewers.ContainsByPredicate([Viewer](const FPendingViewer& Pending)
+	{
+		return Pending.Viewer == Viewer;
+	});
+
+	if (!bQueued)
+	{
+		PendingViewers.Add({ Viewer, Owner });
+	}
+}
+
+void UInteractionSubsystem::CancelViewer(IInteractionViewer* Viewer)
+{
+	PendingViewers.RemoveAll([Viewer](const FPendingViewer& Pending)
+	{
+		return Pending.Viewer == Viewer;
+	});
+}
+
+void UInteractionSubsystem::ResolveViewerNow(IInteractionViewer* Viewer)
+{
+	if (!Viewer)
+	{
+		return;
+	}
+
+	// answered now, don't answer again with the batch
+	CancelViewer(Viewer);
+
+	FInteractionQuery Query;
+
+	if (Viewer->BuildInteractionQuery(Query))
+	{
+		Viewer->ReceiveInteractionResult(FindBestInteractable(Query));
+	}
+}
+
+FText UInteractionSubsystem::GetInteractionPrompt(AActor* Actor)
+{
+	const int32* Index = InteractableIndex.Find(Actor);
+
+	// unregistered interactables build their prompt every time
+	if (!Index)
+	{
+		return IInteractable::Execute_GetInteractionPrompt(Actor);
+	}
+
+	FRegisteredInteractable& Entry = Interactables[*Index];
+
+	if (!Entry.bPromptCached)
+	{
+		Entry.CachedPrompt = IInteractable::Execute_GetInteractionPrompt(Actor);
+		Entry.bPromptCached = true;
+	}
+
+	return Entry.CachedPrompt;
+}
+
+void UInteractionSubsystem::InvalidatePrompt(AActor* Actor)
+{
+	if (const int32* Index = InteractableIndex.Find(Actor))
+	{
+		Interactables[*Index].bPromptCached = false;
+	}
+}
+
+bool UInteractionSubsystem::HasLineOfSight(const FInteractionQuery& Query, const AActor* Actor) const
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(InteractionLineOfSight));
+	QueryParams.AddIgnoredActor(Query.IgnoredActor);
+
+	FHitResult HitResult;
+
+	// anything but the interactable itself in the way blocks it
+	if (GetWorld()->LineTraceSingleByChannel(HitResult, Query.ViewLocation, Actor->GetActorLocation(), ECC_Visibility, QueryParams))
+	{
+		return HitResult.GetActor() == Actor;
+	}
+
+	return true;
+}
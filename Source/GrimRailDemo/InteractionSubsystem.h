@@ -0,0 +1,172 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InteractionSubsystem.generated.h"
+
+class APlayerController;
+
+/** View and tuning used to pick the interactable a player focuses */
+struct FInteractionQuery
+{
+	/** Viewpoint location */
+	FVector ViewLocation = FVector::ZeroVector;
+
+	/** Viewpoint forward direction */
+	FVector ViewDirection = FVector::ForwardVector;
+
+	/** Maximum distance from the viewpoint */
+	float MaxDistance = 120.0f;
+
+	/** Maximum angle from the view direction, in degrees */
+	float MaxAngle = 25.0f;
+
+	/** Score bonus for the current focus, as a fraction of its score, so focus doesn't flicker between close candidates */
+	float Hysteresis = 0.25f;
+
+	/** Currently focused interactable, if any */
+	AActor* CurrentFocus = nullptr;
+
+	/** Player asking, passed to CanInteract */
+	APlayerController* PlayerController = nullptr;
+
+	/** Actor ignored by the line of sight trace, usually the player pawn */
+	const AActor* IgnoredActor = nullptr;
+};
+
+/**
+ *  Anything that asks the interaction subsystem for a focus, usually a local player's character
+ *  Queued viewers are resolved together once per frame, so splitscreen players share one pass over the interactables
+ */
+class IInteractionViewer
+{
+public:
+
+	virtual ~IInteractionViewer() = default;
+
+	/**
+	 * Fills in the query for this viewer
+	 * @param OutQuery Query to fill in
+	 * @return False to skip the query this time
+	 */
+	virtual bool BuildInteractionQuery(FInteractionQuery& OutQuery) = 0;
+
+	/** Receives the winning interactable of the query, or nullptr if there was none */
+	virtual void ReceiveInteractionResult(AActor* BestInteractable) = 0;
+};
+
+/**
+ *  Registry of interactable actors in the world
+ *  Picks the best interactable for a viewpoint by scoring the registered ones by view angle, distance and priority,
+ *  and only traces line of sight for the best candidates. Also caches interaction prompts, shared by all local players
+ */
+UCLASS()
+class GRIMRAILDEMO_API UInteractionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** A registered interactable */
+	struct FRegisteredInteractable
+	{
+		TWeakObjectPtr<AActor> Actor;
+		float Priority = 1.0f;
+		FText CachedPrompt;
+		bool bPromptCached = false;
+	};
+
+	/** All registered interactables */
+	TArray<FRegisteredInteractable> Interactables;
+
+	/** Index into Interactables by actor */
+	TMap<TObjectKey<AActor>, int32> InteractableIndex;
+
+	/** Bumped whenever an interactable is added, removed or changes state */
+	uint32 Revision = 0;
+
+	/** A viewer waiting for its query to be resolved */
+	struct FPendingViewer
+	{
+		IInteractionViewer* Viewer = nullptr;
+		TWeakObjectPtr<UObject> Owner;
+	};
+
+	/** Viewers queued for the next batch */
+	TArray<FPendingViewer> PendingViewers;
+
+	/** Tick scheduler task running the batched interaction queries */
+	int32 TickTaskID = INDEX_NONE;
+
+public:
+
+	/** Registers an interactable. Higher priority interactables win over closer, better centered ones */
+	void RegisterInteractable(AActor* Actor, float Priority = 1.0f);
+
+	/** Unregisters an interactable */
+	void UnregisterInteractable(AActor* Actor);
+
+	/** Returns the number of registered interactables */
+	int32 GetNumInteractables() const { return Interactables.Num(); }
+
+	/** Returns a counter that changes whenever the set of interactables or their state changes */
+	uint32 GetRevision() const { return Revision; }
+
+	/** Tells focus checks that an interactable changed state, e.g. it can no longer be interacted with */
+	void NotifyInteractableChanged(AActor* Actor);
+
+	/** Returns true if any registered interactable is within the given radius */
+	bool HasInteractableWithin(const FVector& Location, float Radius) const;
+
+	/**
+	 * Picks the best interactable for a viewpoint
+	 * @param Query Viewpoint and tuning
+	 * @return The winning interactable, or nullptr if none is in range, in view and interactable
+	 */
+	AActor* FindBestInteractable(const FInteractionQuery& Query) const;
+
+	/**
+	 * Picks the best interactable for several viewpoints in one pass over the interactables
+	 * @param Queries Viewpoints and tuning
+	 * @param OutResults Receives the winner of each query, or nullptr. Must be as long as Queries
+	 */
+	void FindBestInteractables(TConstArrayView<FInteractionQuery> Queries, TArrayView<AActor*> OutResults) const;
+
+	/**
+	 * Queues a viewer for the next batched check. Queuing an already queued viewer does nothing
+	 * @param Viewer Viewer to query
+	 * @param Owner Object owning the viewer, the query is dropped if it's destroyed first
+	 */
+	void QueueViewer(IInteractionViewer* Viewer, UObject* Owner);
+
+	/** Removes a viewer from the queue, e.g. when it ends play */
+	void CancelViewer(IInteractionViewer* Viewer);
+
+	/** Resolves a viewer's query right away instead of waiting for the batch */
+	void ResolveViewerNow(IInteractionViewer* Viewer);
+
+	/** Returns the interaction prompt for an interactable, building it only the first time */
+	FText GetInteractionPrompt(AActor* Actor);
+
+	/** Forgets the cached prompt of an interactable, e.g. after its prompt text changed */
+	void InvalidatePrompt(AActor* Actor);
+
+protected:
+
+	//~Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem Interface
+
+	/** Runs the batched interaction queries from the tick scheduler's normal lane */
+	void ScheduledTick(float DeltaTime);
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem Interface
+
+	/** Returns true if nothing blocks the view between the viewpoint and the interactable */
+	bool HasLineOfSight(const FInteractionQuery& Query, const AActor* Actor) const;
+};
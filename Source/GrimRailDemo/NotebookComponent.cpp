@@ -2,6 +2,9 @@
 
 #include "NotebookComponent.h"
 #include "GameFramework/PlayerController.h"
+#include "GrimRailSaveSubsystem.h"
+#include "NotebookContentSubsystem.h"
+#include "GrimRailMemorySubsystem.h"
 
 UNotebookComponent::UNotebookComponent()
 {
@@ -12,6 +15,16 @@ UNotebookComponent::UNotebookComponent()
 void UNotebookComponent::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// Build the clue graph before restoring, so restored entries count towards objectives
+	ClueGraph.Build(ClueGraphAsset);
+	RebuildClueGraphState();
+
+	// Pick up the entries collected in earlier sessions
+	if (UGrimRailSaveSubsystem* SaveSubsystem = UGrimRailSaveSubsystem::Get(this))
+	{
+		SaveSubsystem->RestoreNotebook(this);
+	}
 }
 
 bool UNotebookComponent::AddEntry(const FNotebookEntry& Entry)
@@ -23,13 +36,17 @@ bool UNotebookComponent::AddEntry(const FNotebookEntry& Entry)
 		return false;
 	}
 
+	LLM_SCOPE_BYTAG(GrimRail_Notebook);
+
 	// Create a new entry with current timestamp
 	FNotebookEntry NewEntry = Entry;
 	NewEntry.Timestamp = GetWorld()->GetTimeSeconds();
 	NewEntry.bHasBeenRead = false;
 
-	// Add to entries array
-	Entries.Add(NewEntry);
+	// Add to entries array and the search index
+	const int32 EntryIndex = Entries.Add(NewEntry);
+	EntryIndexByID.Add(NewEntry.EntryID, EntryIndex);
+	SearchIndex.AddEntry(EntryIndex, NewEntry.Title.ToString(), NewEntry.Body.ToString());
 
 	// Update unread count
 	UnreadCount++;
@@ -37,24 +54,38 @@ bool UNotebookComponent::AddEntry(const FNotebookEntry& Entry)
 	// Broadcast delegate
 	OnNotebookEntryAdded.Broadcast(NewEntry, UnreadCount);
 
+	// Persist the new entry
+	if (UGrimRailSaveSubsystem* SaveSubsystem = UGrimRailSaveSubsystem::Get(this))
+	{
+		SaveSubsystem->RecordNotebookEntry(NewEntry);
+	}
+
 	UE_LOG(LogTemp, Log, TEXT("NotebookComponent: Added entry '%s' - %s"), *Entry.EntryID.ToString(), *Entry.Title.ToString());
 
+	// Only the objectives that depend on this entry are re-evaluated
+	TArray<const FClueObjective*> Unlocked;
+	ClueGraph.SatisfyEntry(NewEntry.EntryID, Unlocked);
+	HandleUnlockedObjectives(Unlocked, true);
+
 	return true;
 }
 
 void UNotebookComponent::MarkEntryAsRead(FName EntryID)
 {
-	for (FNotebookEntry& Entry : Entries)
+	FNotebookEntry* Entry = FindEntry(EntryID);
+	if (Entry && !Entry->bHasBeenRead)
 	{
-		if (Entry.EntryID == EntryID && !Entry.bHasBeenRead)
-		{
-			Entry.bHasBeenRead = true;
-			UpdateUnreadCount();
-			OnNotebookEntryRead.Broadcast(Entry);
+		Entry->bHasBeenRead = true;
+		UnreadCount--;
+		OnNotebookEntryRead.Broadcast(*Entry);
 
-			UE_LOG(LogTemp, Log, TEXT("NotebookComponent: Marked entry '%s' as read"), *EntryID.ToString());
-			return;
+		// Persist the read flag
+		if (UGrimRailSaveSubsystem* SaveSubsystem = UGrimRailSaveSubsystem::Get(this))
+		{
+			SaveSubsystem->RecordNotebookEntryRead(EntryID);
 		}
+
+		UE_LOG(LogTemp, Log, TEXT("NotebookComponent: Marked entry '%s' as read"), *EntryID.ToString());
 	}
 }
 
@@ -73,40 +104,171 @@ TArray<FNotebookEntry> UNotebookComponent::GetEntriesByCategory(ENotebookCategor
 	return FilteredEntries;
 }
 
-bool UNotebookComponent::GetEntryByID(FName EntryID, FNotebookEntry& OutEntry) const
+void UNotebookComponent::GetEntryHandlesByCategory(ENotebookCategory Category, TArray<FNotebookEntryHandle>& OutHandles) const
 {
-	for (const FNotebookEntry& Entry : Entries)
+	OutHandles.Reset();
+
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
 	{
-		if (Entry.EntryID == EntryID)
+		if (Entries[Index].Category == Category)
 		{
-			OutEntry = Entry;
-			return true;
+			OutHandles.Add(MakeEntryHandle(Index));
 		}
 	}
+}
+
+void UNotebookComponent::GetAllEntryHandles(TArray<FNotebookEntryHandle>& OutHandles) const
+{
+	OutHandles.Reset(Entries.Num());
+
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		OutHandles.Add(MakeEntryHandle(Index));
+	}
+}
+
+void UNotebookComponent::SearchEntries(const FString& Query, int32 MaxResults, TArray<FNotebookEntryHandle>& OutHandles) const
+{
+	TArray<int32> EntryIndices;
+	SearchIndex.Search(Query, MaxResults, EntryIndices);
+
+	OutHandles.Reset(EntryIndices.Num());
+	for (const int32 Index : EntryIndices)
+	{
+		OutHandles.Add(MakeEntryHandle(Index));
+	}
+}
+
+bool UNotebookComponent::GetEntryByHandle(const FNotebookEntryHandle& Handle, FNotebookEntry& OutEntry) const
+{
+	if (const FNotebookEntry* Entry = ResolveEntryHandle(Handle))
+	{
+		OutEntry = *Entry;
+		return true;
+	}
 
 	return false;
 }
 
-bool UNotebookComponent::HasEntry(FName EntryID) const
+const FNotebookEntry* UNotebookComponent::ResolveEntryHandle(const FNotebookEntryHandle& Handle) const
 {
-	for (const FNotebookEntry& Entry : Entries)
+	if (Handle.Generation != EntryGeneration || !Entries.IsValidIndex(Handle.Index))
 	{
-		if (Entry.EntryID == EntryID)
-		{
-			return true;
-		}
+		return nullptr;
+	}
+
+	return &Entries[Handle.Index];
+}
+
+bool UNotebookComponent::GetEntryByID(FName EntryID, FNotebookEntry& OutEntry) const
+{
+	if (const FNotebookEntry* Entry = FindEntry(EntryID))
+	{
+		OutEntry = *Entry;
+		return true;
 	}
 
 	return false;
 }
 
+bool UNotebookComponent::HasEntry(FName EntryID) const
+{
+	return EntryIndexByID.Contains(EntryID);
+}
+
 void UNotebookComponent::ClearAllEntries()
 {
 	Entries.Empty();
+	EntryIndexByID.Empty();
+	SearchIndex.Reset();
+	EntryGeneration++;
 	UnreadCount = 0;
+
+	if (UGrimRailSaveSubsystem* SaveSubsystem = UGrimRailSaveSubsystem::Get(this))
+	{
+		SaveSubsystem->RecordNotebookCleared();
+	}
+
+	// Objectives without requirements unlock again
+	RebuildClueGraphState();
+
 	UE_LOG(LogTemp, Log, TEXT("NotebookComponent: Cleared all entries"));
 }
 
+void UNotebookComponent::RestoreEntries(TArray<FNotebookEntry>&& SavedEntries)
+{
+	LLM_SCOPE_BYTAG(GrimRail_Notebook);
+
+	Entries = MoveTemp(SavedEntries);
+
+	// Rebuild the lookup and search indices in one pass
+	EntryIndexByID.Empty(Entries.Num());
+	SearchIndex.Reset();
+	EntryGeneration++;
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		EntryIndexByID.Add(Entries[Index].EntryID, Index);
+		SearchIndex.AddEntry(Index, Entries[Index].Title.ToString(), Entries[Index].Body.ToString());
+	}
+
+	UpdateUnreadCount();
+	RebuildClueGraphState();
+
+	UE_LOG(LogTemp, Log, TEXT("NotebookComponent: Restored %d saved entries (%d unread)"), Entries.Num(), UnreadCount);
+}
+
+bool UNotebookComponent::IsObjectiveUnlocked(FName ObjectiveID) const
+{
+	return ClueGraph.IsObjectiveUnlocked(ObjectiveID);
+}
+
+void UNotebookComponent::RebuildClueGraphState()
+{
+	if (ClueGraph.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<const FClueObjective*> Unlocked;
+	ClueGraph.Reset(Unlocked);
+
+	for (const FNotebookEntry& Entry : Entries)
+	{
+		ClueGraph.SatisfyEntry(Entry.EntryID, Unlocked);
+	}
+
+	// These were unlocked in an earlier session, only make sure their entries are granted
+	HandleUnlockedObjectives(Unlocked, false);
+}
+
+void UNotebookComponent::HandleUnlockedObjectives(const TArray<const FClueObjective*>& Unlocked, bool bBroadcast)
+{
+	for (const FClueObjective* Objective : Unlocked)
+	{
+		if (bBroadcast)
+		{
+			OnObjectiveUnlocked.Broadcast(Objective->ObjectiveID);
+			UE_LOG(LogTemp, Log, TEXT("NotebookComponent: Unlocked objective '%s'"), *Objective->ObjectiveID.ToString());
+		}
+
+		// Grant the objective's own entry, which may unlock further objectives in turn
+		if (!Objective->GrantedEntryID.IsNone() && !HasEntry(Objective->GrantedEntryID))
+		{
+			FNotebookEntry GrantedEntry;
+			UNotebookContentSubsystem* ContentSubsystem = UNotebookContentSubsystem::Get(this);
+
+			if (ContentSubsystem && ContentSubsystem->MakeNotebookEntry(Objective->GrantedEntryID, GrantedEntry))
+			{
+				AddEntry(GrantedEntry);
+			}
+			else
+			{
+				UE_LOG(LogTemp, Warning, TEXT("NotebookComponent: Objective '%s' grants unregistered entry '%s'"), *Objective->ObjectiveID.ToString(), *Objective->GrantedEntryID.ToString());
+			}
+		}
+	}
+}
+
 void UNotebookComponent::UpdateUnreadCount()
 {
 	UnreadCount = 0;
@@ -118,3 +280,23 @@ void UNotebookComponent::UpdateUnreadCount()
 		}
 	}
 }
+
+FNotebookEntryHandle UNotebookComponent::MakeEntryHandle(int32 Index) const
+{
+	FNotebookEntryHandle Handle;
+	Handle.Index = Index;
+	Handle.Generation = EntryGeneration;
+	return Handle;
+}
+
+FNotebookEntry* UNotebookComponent::FindEntry(FName EntryID)
+{
+	const int32* Index = EntryIndexByID.Find(EntryID);
+	return Index ? &Entries[*Index] : nullptr;
+}
+
+const FNotebookEntry* UNotebookComponent::FindEntry(FName EntryID) const
+{
+	const int32* Index = EntryIndexByID.Find(EntryID);
+	return Index ? &Entries[*Index] : nullptr;
+}
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "NotebookSearchIndex.h"
+#include "ClueGraph.h"
 #include "NotebookComponent.generated.h"
 
 /** Categories for organizing notebook entries */
@@ -60,12 +62,31 @@ struct FNotebookEntry
 	{}
 };
 
+/** Lightweight reference to an entry in a notebook, valid until the notebook is cleared or restored */
+USTRUCT(BlueprintType)
+struct FNotebookEntryHandle
+{
+	GENERATED_BODY()
+
+	/** Index of the entry in the notebook */
+	int32 Index = INDEX_NONE;
+
+	/** Notebook generation the handle was made in */
+	uint32 Generation = 0;
+
+	/** Returns true if the handle points at an entry */
+	bool IsValid() const { return Index != INDEX_NONE; }
+};
+
 /** Delegate called when a new entry is added to the notebook */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnNotebookEntryAdded, const FNotebookEntry&, Entry, int32, UnreadCount);
 
 /** Delegate called when an entry is marked as read */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnNotebookEntryRead, const FNotebookEntry&, Entry);
 
+/** Delegate called when a clue objective unlocks */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnClueObjectiveUnlocked, FName, ObjectiveID);
+
 /**
  * Component that manages the player's notebook system
  * Tracks clues, objectives, lore, and character information discovered during gameplay
@@ -81,6 +102,22 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "Notebook")
 	TArray<FNotebookEntry> Entries;
 
+	/** Index into Entries by entry ID */
+	TMap<FName, int32> EntryIndexByID;
+
+	/** Word index over entry titles and bodies for search */
+	FNotebookSearchIndex SearchIndex;
+
+	/** Objectives unlocked by combinations of collected entries */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Notebook")
+	TObjectPtr<UClueGraphAsset> ClueGraphAsset;
+
+	/** Runtime clue graph built from ClueGraphAsset */
+	FClueGraph ClueGraph;
+
+	/** Bumped whenever entry indices change, so stale handles stop resolving */
+	uint32 EntryGeneration = 0;
+
 	/** Cached count of unread entries for UI updates */
 	int32 UnreadCount = 0;
 
@@ -94,6 +131,10 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Notebook")
 	FOnNotebookEntryRead OnNotebookEntryRead;
 
+	/** Delegate broadcast when a clue objective unlocks */
+	UPROPERTY(BlueprintAssignable, Category = "Notebook")
+	FOnClueObjectiveUnlocked OnObjectiveUnlocked;
+
 public:
 
 	UNotebookComponent();
@@ -134,6 +175,47 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Notebook")
 	TArray<FNotebookEntry> GetEntriesByCategory(ENotebookCategory Category) const;
 
+	/**
+	 * Gets handles to all entries in a specific category, without copying the entries
+	 * @param Category The category to filter by
+	 * @param OutHandles Handles to the entries in the specified category
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Notebook")
+	void GetEntryHandlesByCategory(ENotebookCategory Category, TArray<FNotebookEntryHandle>& OutHandles) const;
+
+	/**
+	 * Gets handles to all entries, in the order they were added, without copying the entries
+	 * @param OutHandles Handles to every entry
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Notebook")
+	void GetAllEntryHandles(TArray<FNotebookEntryHandle>& OutHandles) const;
+
+	/**
+	 * Searches entry titles and bodies. Every query word must match the start of a word in the entry
+	 * Results are ranked with title matches above body matches, and whole words above prefixes
+	 * @param Query The words to search for
+	 * @param MaxResults Maximum number of results, zero for all
+	 * @param OutHandles Handles to the matching entries, best match first
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Notebook")
+	void SearchEntries(const FString& Query, int32 MaxResults, TArray<FNotebookEntryHandle>& OutHandles) const;
+
+	/**
+	 * Gets the entry a handle points at
+	 * @param Handle Handle returned by a search or category query
+	 * @param OutEntry The found entry (output parameter)
+	 * @return True if the handle is still valid
+	 */
+	UFUNCTION(BlueprintPure, Category = "Notebook")
+	bool GetEntryByHandle(const FNotebookEntryHandle& Handle, FNotebookEntry& OutEntry) const;
+
+	/**
+	 * Resolves a handle without copying the entry
+	 * @param Handle Handle returned by a search or category query
+	 * @return The entry, or nullptr if the handle is stale
+	 */
+	const FNotebookEntry* ResolveEntryHandle(const FNotebookEntryHandle& Handle) const;
+
 	/**
 	 * Gets a specific entry by its ID
 	 * @param EntryID The unique ID of the entry
@@ -151,6 +233,14 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Notebook")
 	bool HasEntry(FName EntryID) const;
 
+	/**
+	 * Checks if a clue objective has been unlocked
+	 * @param ObjectiveID The objective ID to check
+	 * @return True if the objective is unlocked
+	 */
+	UFUNCTION(BlueprintPure, Category = "Notebook")
+	bool IsObjectiveUnlocked(FName ObjectiveID) const;
+
 	/**
 	 * Gets the number of unread entries
 	 * @return Count of unread entries
@@ -171,8 +261,28 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Notebook")
 	void ClearAllEntries();
 
+	/**
+	 * Replaces all entries with previously saved ones in a single pass
+	 * Rebuilds the lookup index and unread count without broadcasting per entry
+	 * @param SavedEntries The entries to restore
+	 */
+	void RestoreEntries(TArray<FNotebookEntry>&& SavedEntries);
+
 protected:
 
 	/** Updates the unread entry count */
 	void UpdateUnreadCount();
+
+	/** Resets the clue graph and feeds it every entry already in the notebook, without broadcasting unlocks */
+	void RebuildClueGraphState();
+
+	/** Broadcasts unlocked objectives and grants their notebook entries */
+	void HandleUnlockedObjectives(const TArray<const FClueObjective*>& Unlocked, bool bBroadcast);
+
+	/** Makes a handle to the entry at the given index */
+	FNotebookEntryHandle MakeEntryHandle(int32 Index) const;
+
+	/** Finds an entry by its ID, or nullptr if it is not in the notebook */
+	FNotebookEntry* FindEntry(FName EntryID);
+	const FNotebookEntry* FindEntry(FName EntryID) const;
 };
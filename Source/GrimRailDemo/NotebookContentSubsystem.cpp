@@ -0,0 +1,197 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NotebookContentSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/GameInstance.h"
+#include "Misc/CoreDelegates.h"
+#include "HAL/PlatformTime.h"
+#include "GrimRailDemo.h"
+
+void UNotebookContentSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// the registry only holds text and soft references, so it is cheap to keep resident
+	Registry = RegistryAsset.LoadSynchronous();
+
+	if (!Registry && !RegistryAsset.IsNull())
+	{
+		UE_LOG(LogGrimRailDemo, Warning, TEXT("NotebookContentSubsystem: Could not load registry '%s'"), *RegistryAsset.ToString());
+	}
+
+	MemoryTrimHandle = FCoreDelegates::GetMemoryTrimDelegate().AddUObject(this, &UNotebookContentSubsystem::OnMemoryTrim);
+}
+
+void UNotebookContentSubsystem::Deinitialize()
+{
+	FCoreDelegates::GetMemoryTrimDelegate().Remove(MemoryTrimHandle);
+
+	for (TPair<FName, FResidentContent>& Pair : ResidentContent)
+	{
+		if (Pair.Value.Handle.IsValid())
+		{
+			Pair.Value.Handle->CancelHandle();
+		}
+	}
+
+	ResidentContent.Empty();
+	PendingCallbacks.Empty();
+
+	Super::Deinitialize();
+}
+
+UNotebookContentSubsystem* UNotebookContentSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+
+	return GameInstance ? GameInstance->GetSubsystem<UNotebookContentSubsystem>() : nullptr;
+}
+
+const FNotebookEntryDefinition* UNotebookContentSubsystem::FindDefinition(FName EntryID) const
+{
+	return Registry ? Registry->FindDefinition(EntryID) : nullptr;
+}
+
+bool UNotebookContentSubsystem::MakeNotebookEntry(FName EntryID, FNotebookEntry& OutEntry) const
+{
+	const FNotebookEntryDefinition* Definition = FindDefinition(EntryID);
+
+	if (!Definition)
+	{
+		return false;
+	}
+
+	// the notebook only holds the light fields. Images and long text come from the content asset when the page is viewed
+	OutEntry = FNotebookEntry();
+	OutEntry.EntryID = EntryID;
+	OutEntry.Title = Definition->Title;
+	OutEntry.Body = Definition->Summary;
+	OutEntry.Category = Definition->Category;
+
+	return true;
+}
+
+void UNotebookContentSubsystem::RequestEntryContent(FName EntryID, const FOnNotebookContentLoaded& OnLoaded)
+{
+	const FNotebookEntryDefinition* Definition = FindDefinition(EntryID);
+
+	// nothing to load
+	if (!Definition || Definition->Content.IsNull())
+	{
+		OnLoaded.ExecuteIfBound(EntryID, nullptr);
+		return;
+	}
+
+	FResidentContent& Resident = ResidentContent.FindOrAdd(EntryID);
+	Resident.LastUseTime = FPlatformTime::Seconds();
+
+	// already loaded
+	if (UNotebookEntryContent* Content = Definition->Content.Get())
+	{
+		// keep the content alive through a handle so it survives until trimmed
+		if (!Resident.Handle.IsValid())
+		{
+			Resident.Handle = StreamableManager.RequestAsyncLoad(Definition->Content.ToSoftObjectPath());
+		}
+
+		// this entry is now the most recently used, so trimming drops older content first
+		TrimToBudget();
+
+		OnLoaded.ExecuteIfBound(EntryID, Content);
+		return;
+	}
+
+	PendingCallbacks.FindOrAdd(EntryID).Add(OnLoaded);
+
+	// start the load unless one is already in flight
+	if (!Resident.Handle.IsValid())
+	{
+		Resident.Handle = StreamableManager.RequestAsyncLoad(Definition->Content.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &UNotebookContentSubsystem::OnContentLoaded, EntryID));
+	}
+
+	TrimToBudget();
+}
+
+UNotebookEntryContent* UNotebookContentSubsystem::GetLoadedEntryContent(FName EntryID) const
+{
+	const FNotebookEntryDefinition* Definition = FindDefinition(EntryID);
+	return Definition ? Definition->Content.Get() : nullptr;
+}
+
+void UNotebookContentSubsystem::ReleaseAllContent()
+{
+	for (TMap<FName, FResidentContent>::TIterator It = ResidentContent.CreateIterator(); It; ++It)
+	{
+		// leave loads in flight alone, someone is waiting on them
+		if (PendingCallbacks.Contains(It.Key()))
+		{
+			continue;
+		}
+
+		if (It.Value().Handle.IsValid())
+		{
+			It.Value().Handle->ReleaseHandle();
+		}
+
+		It.RemoveCurrent();
+	}
+}
+
+void UNotebookContentSubsystem::OnContentLoaded(FName EntryID)
+{
+	TArray<FOnNotebookContentLoaded> Callbacks;
+	PendingCallbacks.RemoveAndCopyValue(EntryID, Callbacks);
+
+	UNotebookEntryContent* Content = GetLoadedEntryContent(EntryID);
+
+	if (!Content)
+	{
+		UE_LOG(LogGrimRailDemo, Warning, TEXT("NotebookContentSubsystem: Could not load content for entry '%s'"), *EntryID.ToString());
+	}
+
+	for (const FOnNotebookContentLoaded& Callback : Callbacks)
+	{
+		Callback.ExecuteIfBound(EntryID, Content);
+	}
+}
+
+void UNotebookContentSubsystem::TrimToBudget()
+{
+	while (ResidentContent.Num() > MaxResidentContent)
+	{
+		// find the least recently used content that isn't still loading
+		FName OldestID = NAME_None;
+		double OldestTime = TNumericLimits<double>::Max();
+
+		for (const TPair<FName, FResidentContent>& Pair : ResidentContent)
+		{
+			if (Pair.Value.LastUseTime < OldestTime && !PendingCallbacks.Contains(Pair.Key))
+			{
+				OldestID = Pair.Key;
+				OldestTime = Pair.Value.LastUseTime;
+			}
+		}
+
+		if (OldestID.IsNone())
+		{
+			return;
+		}
+
+		// the content unloads on the next garbage collection unless a widget still shows it
+		FResidentContent Oldest;
+		ResidentContent.RemoveAndCopyValue(OldestID, Oldest);
+
+		if (Oldest.Handle.IsValid())
+		{
+			Oldest.Handle->ReleaseHandle();
+		}
+	}
+}
+
+void UNotebookContentSubsystem::OnMemoryTrim()
+{
+	UE_LOG(LogGrimRailDemo, Log, TEXT("NotebookContentSubsystem: Releasing %d loaded entries on memory trim"), ResidentContent.Num() - PendingCallbacks.Num());
+
+	ReleaseAllContent();
+}
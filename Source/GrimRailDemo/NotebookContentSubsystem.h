@@ -0,0 +1,109 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "NotebookEntryRegistry.h"
+#include "NotebookContentSubsystem.generated.h"
+
+/** Delegate called when an entry's heavy content finishes loading. Content is null if the entry has none */
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FOnNotebookContentLoaded, FName, EntryID, UNotebookEntryContent*, Content);
+
+/**
+ * Serves notebook entry definitions from the registry and streams their heavy content on demand
+ * Loaded content is kept around for a while so paging back and forth is instant,
+ * and released least recently used first when over budget or when the platform asks to trim memory
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UNotebookContentSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Registry holding every notebook entry */
+	UPROPERTY(Config, EditAnywhere, Category="Notebook")
+	TSoftObjectPtr<UNotebookEntryRegistry> RegistryAsset;
+
+	/** Maximum number of entries whose content is kept loaded once nothing else references it */
+	UPROPERTY(Config, EditAnywhere, Category="Notebook", meta = (ClampMin = 1))
+	int32 MaxResidentContent = 16;
+
+	/** Loaded registry */
+	UPROPERTY(Transient)
+	TObjectPtr<UNotebookEntryRegistry> Registry;
+
+	/** Streamable handle and last use of an entry's content */
+	struct FResidentContent
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		double LastUseTime = 0.0;
+	};
+
+	/** Content requested or loaded, by entry ID */
+	TMap<FName, FResidentContent> ResidentContent;
+
+	/** Callbacks waiting on content still loading, by entry ID */
+	TMap<FName, TArray<FOnNotebookContentLoaded>> PendingCallbacks;
+
+	/** Async loader for the content */
+	FStreamableManager StreamableManager;
+
+	/** Memory trim delegate handle */
+	FDelegateHandle MemoryTrimHandle;
+
+public:
+
+	//~Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem Interface
+
+	/** Returns the content subsystem for the given world context object */
+	static UNotebookContentSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Returns the definition for the given entry ID, or nullptr if it isn't registered */
+	const FNotebookEntryDefinition* FindDefinition(FName EntryID) const;
+
+	/**
+	 * Builds a notebook entry from its registry definition
+	 * @param EntryID ID of the registered entry
+	 * @param OutEntry The notebook entry (output parameter)
+	 * @return True if the entry is registered
+	 */
+	UFUNCTION(BlueprintCallable, Category="Notebook")
+	bool MakeNotebookEntry(FName EntryID, FNotebookEntry& OutEntry) const;
+
+	/**
+	 * Loads an entry's heavy content in the background. Calls back right away if it is already loaded
+	 * @param EntryID ID of the registered entry
+	 * @param OnLoaded Called once the content is loaded
+	 */
+	UFUNCTION(BlueprintCallable, Category="Notebook")
+	void RequestEntryContent(FName EntryID, const FOnNotebookContentLoaded& OnLoaded);
+
+	/**
+	 * Returns an entry's heavy content if it is already loaded
+	 * @param EntryID ID of the registered entry
+	 * @return The content, or null if it isn't loaded
+	 */
+	UFUNCTION(BlueprintPure, Category="Notebook")
+	UNotebookEntryContent* GetLoadedEntryContent(FName EntryID) const;
+
+	/** Releases all content that is not currently referenced elsewhere */
+	UFUNCTION(BlueprintCallable, Category="Notebook")
+	void ReleaseAllContent();
+
+protected:
+
+	/** Called when an entry's content finishes loading */
+	void OnContentLoaded(FName EntryID);
+
+	/** Releases the least recently used content until within budget */
+	void TrimToBudget();
+
+	/** Releases content when the platform runs low on memory */
+	void OnMemoryTrim();
+};
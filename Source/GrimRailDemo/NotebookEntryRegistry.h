@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "NotebookComponent.h"
+#include "NotebookEntryRegistry.generated.h"
+
+class UTexture2D;
+class USoundBase;
+
+/**
+ * Heavy content for a notebook entry
+ * Only loaded when the entry's page is viewed
+ */
+UCLASS(BlueprintType)
+class GRIMRAILDEMO_API UNotebookEntryContent : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Full text shown on the entry's page */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Notebook", meta = (MultiLine = true))
+	FText LongText;
+
+	/** Image shown on the entry's page */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Notebook")
+	TObjectPtr<UTexture2D> Image;
+
+	/** Audio log played from the entry's page */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Notebook")
+	TObjectPtr<USoundBase> AudioLog;
+};
+
+/** Lightweight definition of a notebook entry, always resident */
+USTRUCT(BlueprintType)
+struct FNotebookEntryDefinition
+{
+	GENERATED_BODY()
+
+	/** Display title of the entry */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Notebook")
+	FText Title;
+
+	/** Short text shown in lists and search results */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Notebook")
+	FText Summary;
+
+	/** Category this entry belongs to */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Notebook")
+	ENotebookCategory Category = ENotebookCategory::Clue;
+
+	/** Heavy content, loaded on demand */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Notebook")
+	TSoftObjectPtr<UNotebookEntryContent> Content;
+};
+
+/**
+ * Central list of every notebook entry in the game, keyed by entry ID
+ * Collectibles reference entries by ID, so levels don't carry copies of the text or hard references to the content
+ */
+UCLASS(BlueprintType)
+class GRIMRAILDEMO_API UNotebookEntryRegistry : public UDataAsset
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Entry definitions by entry ID */
+	UPROPERTY(EditAnywhere, Category = "Notebook")
+	TMap<FName, FNotebookEntryDefinition> Entries;
+
+public:
+
+	/** Returns the definition for the given entry ID, or nullptr if it isn't registered */
+	const FNotebookEntryDefinition* FindDefinition(FName EntryID) const { return Entries.Find(EntryID); }
+
+	/** Returns the number of registered entries */
+	int32 GetNumEntries() const { return Entries.Num(); }
+};
@@ -0,0 +1,314 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NotebookSearchIndex.h"
+#include "Algo/Sort.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "GrimRailDemo.h"
+
+static FAutoConsoleCommand GNotebookSearchBenchmarkCommand(
+	TEXT("GrimRail.Notebook.SearchBenchmark"),
+	TEXT("Builds a search index over synthetic notebook entries and times prefix queries against it. Usage: GrimRail.Notebook.SearchBenchmark [NumEntries=20000] [NumQueries=2000]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumEntries = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 20000;
+		const int32 NumQueries = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 2000;
+
+		// fixed seed so runs are comparable
+		FRandomStream Random(0x6E6F7465);
+
+		// build a vocabulary of made up words out of syllables
+		static const TCHAR* Syllables[] = { TEXT("ra"), TEXT("il"), TEXT("gri"), TEXT("mor"), TEXT("ven"), TEXT("tha"), TEXT("lo"), TEXT("cke"), TEXT("sta"), TEXT("ni"), TEXT("os"), TEXT("bel"), TEXT("dru"), TEXT("ka"), TEXT("wen"), TEXT("pho") };
+		TArray<FString> Vocabulary;
+		Vocabulary.Reserve(4000);
+
+		for (int32 WordIndex = 0; WordIndex < 4000; ++WordIndex)
+		{
+			FString Word;
+			const int32 NumSyllables = Random.RandRange(1, 4);
+
+			for (int32 Syllable = 0; Syllable < NumSyllables; ++Syllable)
+			{
+				Word += Syllables[Random.RandRange(0, static_cast<int32>(UE_ARRAY_COUNT(Syllables)) - 1)];
+			}
+
+			Vocabulary.Add(MoveTemp(Word));
+		}
+
+		auto MakeText = [&Random, &Vocabulary](int32 MinWords, int32 MaxWords)
+		{
+			FString Text;
+			const int32 NumWords = Random.RandRange(MinWords, MaxWords);
+
+			for (int32 Word = 0; Word < NumWords; ++Word)
+			{
+				Text += Vocabulary[Random.RandRange(0, Vocabulary.Num() - 1)];
+				Text += TEXT(' ');
+			}
+
+			return Text;
+		};
+
+		TArray<FString> Titles;
+		TArray<FString> Bodies;
+		Titles.Reserve(NumEntries);
+		Bodies.Reserve(NumEntries);
+
+		for (int32 Entry = 0; Entry < NumEntries; ++Entry)
+		{
+			Titles.Add(MakeText(2, 6));
+			Bodies.Add(MakeText(30, 80));
+		}
+
+		// time the index build
+		FNotebookSearchIndex Index;
+		const double BuildStart = FPlatformTime::Seconds();
+
+		for (int32 Entry = 0; Entry < NumEntries; ++Entry)
+		{
+			Index.AddEntry(Entry, Titles[Entry], Bodies[Entry]);
+		}
+
+		const double BuildSeconds = FPlatformTime::Seconds() - BuildStart;
+
+		// make queries out of word prefixes, a quarter of them with two words
+		TArray<FString> Queries;
+		Queries.Reserve(NumQueries);
+
+		for (int32 Query = 0; Query < NumQueries; ++Query)
+		{
+			const FString& Word = Vocabulary[Random.RandRange(0, Vocabulary.Num() - 1)];
+			FString Text = Word.Left(Random.RandRange(FMath::Min(3, Word.Len()), Word.Len()));
+
+			if (Random.FRand() < 0.25f)
+			{
+				Text += TEXT(' ');
+				Text += Vocabulary[Random.RandRange(0, Vocabulary.Num() - 1)].Left(3);
+			}
+
+			Queries.Add(MoveTemp(Text));
+		}
+
+		// time the top 20 queries
+		TArray<int32> Results;
+		double TotalSeconds = 0.0;
+		double MaxSeconds = 0.0;
+		int64 TotalMatches = 0;
+
+		for (const FString& Query : Queries)
+		{
+			const double QueryStart = FPlatformTime::Seconds();
+			Index.Search(Query, 20, Results);
+			const double QuerySeconds = FPlatformTime::Seconds() - QueryStart;
+
+			TotalSeconds += QuerySeconds;
+			MaxSeconds = FMath::Max(MaxSeconds, QuerySeconds);
+			TotalMatches += Results.Num();
+		}
+
+		// compare against scanning every entry's text, which is what a UI filter would do without the index
+		const int32 NumScanQueries = FMath::Min(NumQueries, 50);
+		const double ScanStart = FPlatformTime::Seconds();
+		int64 ScanMatches = 0;
+
+		for (int32 Query = 0; Query < NumScanQueries; ++Query)
+		{
+			for (int32 Entry = 0; Entry < NumEntries; ++Entry)
+			{
+				if (Titles[Entry].Contains(Queries[Query]) || Bodies[Entry].Contains(Queries[Query]))
+				{
+					++ScanMatches;
+				}
+			}
+		}
+
+		const double ScanSeconds = (FPlatformTime::Seconds() - ScanStart) / NumScanQueries;
+
+		UE_LOG(LogGrimRailDemo, Display, TEXT("NotebookSearchIndex: %d entries, %d words, built in %.1f ms"), NumEntries, Index.GetNumWords(), BuildSeconds * 1000.0);
+		UE_LOG(LogGrimRailDemo, Display, TEXT("NotebookSearchIndex: %d queries, avg %.1f us, max %.1f us, avg %.1f results"),
+			NumQueries, TotalSeconds * 1000000.0 / NumQueries, MaxSeconds * 1000000.0, static_cast<double>(TotalMatches) / NumQueries);
+		UE_LOG(LogGrimRailDemo, Display, TEXT("NotebookSearchIndex: Linear text scan avg %.1f us per query (%lld matches)"), ScanSeconds * 1000000.0, ScanMatches);
+	}));
+
+void FNotebookSearchIndex::AddEntry(int32 EntryIndex, const FString& Title, const FString& Body)
+{
+	TArray<FString> EntryWords;
+
+	// collect where each distinct word appears, bit 0 for the title and bit 1 for the body
+	TMap<int32, uint8, TInlineSetAllocator<64>> WordFlags;
+
+	Tokenize(Title, EntryWords);
+	for (const FString& Word : EntryWords)
+	{
+		WordFlags.FindOrAdd(FindOrAddWord(Word)) |= 1;
+	}
+
+	Tokenize(Body, EntryWords);
+	for (const FString& Word : EntryWords)
+	{
+		WordFlags.FindOrAdd(FindOrAddWord(Word)) |= 2;
+	}
+
+	for (const TPair<int32, uint8>& Pair : WordFlags)
+	{
+		const int32 Weight = ((Pair.Value & 1) ? TitleWeight : 0) + ((Pair.Value & 2) ? BodyWeight : 0);
+		Postings[Pair.Key].Add({ EntryIndex, Weight });
+	}
+}
+
+void FNotebookSearchIndex::Reset()
+{
+	Words.Reset();
+	Postings.Reset();
+	SortedWordIDs.Reset();
+	WordIDs.Reset();
+}
+
+void FNotebookSearchIndex::Search(FStringView Query, int32 MaxResults, TArray<int32>& OutEntryIndices) const
+{
+	OutEntryIndices.Reset();
+
+	TArray<FString> QueryWords;
+	Tokenize(Query, QueryWords);
+
+	// score by entry index. Every query word must match, so the set only shrinks after the first word
+	TMap<int32, int32> Scores;
+	TMap<int32, int32> WordScores;
+
+	for (int32 QueryWord = 0; QueryWord < QueryWords.Num(); ++QueryWord)
+	{
+		const FString& Prefix = QueryWords[QueryWord];
+		WordScores.Reset();
+
+		// walk the sorted words that start with the prefix
+		for (int32 Position = LowerBound(Prefix); Position < SortedWordIDs.Num(); ++Position)
+		{
+			const int32 WordID = SortedWordIDs[Position];
+			const FString& Word = Words[WordID];
+
+			if (!Word.StartsWith(Prefix, ESearchCase::CaseSensitive))
+			{
+				break;
+			}
+
+			// whole word matches rank above prefix matches
+			const int32 Multiplier = Word.Len() == Prefix.Len() ? 2 : 1;
+
+			for (const FPosting& Posting : Postings[WordID])
+			{
+				int32& Score = WordScores.FindOrAdd(Posting.EntryIndex);
+				Score = FMath::Max(Score, Posting.Weight * Multiplier);
+			}
+		}
+
+		if (QueryWord == 0)
+		{
+			Swap(Scores, WordScores);
+
+		} else {
+
+			for (TMap<int32, int32>::TIterator It = Scores.CreateIterator(); It; ++It)
+			{
+				if (const int32* WordScore = WordScores.Find(It.Key()))
+				{
+					It.Value() += *WordScore;
+
+				} else {
+
+					It.RemoveCurrent();
+				}
+			}
+		}
+
+		if (Scores.IsEmpty())
+		{
+			return;
+		}
+	}
+
+	TArray<TPair<int32, int32>> Ranked;
+	Ranked.Reserve(Scores.Num());
+
+	for (const TPair<int32, int32>& Pair : Scores)
+	{
+		Ranked.Emplace(Pair.Key, Pair.Value);
+	}
+
+	// best score first, newest entry first on ties
+	Algo::Sort(Ranked, [](const TPair<int32, int32>& A, const TPair<int32, int32>& B)
+	{
+		return A.Value != B.Value ? A.Value > B.Value : A.Key > B.Key;
+	});
+
+	const int32 NumResults = MaxResults > 0 ? FMath::Min(MaxResults, Ranked.Num()) : Ranked.Num();
+	OutEntryIndices.Reserve(NumResults);
+
+	for (int32 Result = 0; Result < NumResults; ++Result)
+	{
+		OutEntryIndices.Add(Ranked[Result].Key);
+	}
+}
+
+void FNotebookSearchIndex::Tokenize(FStringView Text, TArray<FString>& OutWords)
+{
+	OutWords.Reset();
+
+	int32 WordStart = INDEX_NONE;
+
+	for (int32 CharIndex = 0; CharIndex <= Text.Len(); ++CharIndex)
+	{
+		const bool bWordChar = CharIndex < Text.Len() && FChar::IsAlnum(Text[CharIndex]);
+
+		if (bWordChar && WordStart == INDEX_NONE)
+		{
+			WordStart = CharIndex;
+
+		} else if (!bWordChar && WordStart != INDEX_NONE) {
+
+			OutWords.Add(FString(Text.Mid(WordStart, CharIndex - WordStart)).ToLower());
+			WordStart = INDEX_NONE;
+		}
+	}
+}
+
+int32 FNotebookSearchIndex::FindOrAddWord(const FString& Word)
+{
+	if (const int32* WordID = WordIDs.Find(Word))
+	{
+		return *WordID;
+	}
+
+	const int32 WordID = Words.Add(Word);
+	Postings.AddDefaulted();
+	WordIDs.Add(Word, WordID);
+
+	// keep the sorted list sorted. New words get rare quickly, since vocabularies saturate
+	SortedWordIDs.Insert(WordID, LowerBound(Word));
+
+	return WordID;
+}
+
+int32 FNotebookSearchIndex::LowerBound(FStringView Text) const
+{
+	int32 First = 0;
+	int32 Count = SortedWordIDs.Num();
+
+	while (Count > 0)
+	{
+		const int32 Step = Count / 2;
+		const int32 Middle = First + Step;
+
+		if (FStringView(Words[SortedWordIDs[Middle]]).Compare(Text, ESearchCase::CaseSensitive) < 0)
+		{
+			First = Middle + 1;
+			Count -= Step + 1;
+
+		} else {
+
+			Count = Step;
+		}
+	}
+
+	return First;
+}
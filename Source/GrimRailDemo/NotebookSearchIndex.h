@@ -0,0 +1,74 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Inverted index over the title and body words of notebook entries
+ * Words are kept in a sorted array so prefix queries are a binary search plus a short scan.
+ * Postings are appended in entry order, so results for every word stay sorted by entry index
+ */
+class GRIMRAILDEMO_API FNotebookSearchIndex
+{
+public:
+
+	/** Ranking weight of a word found in the title */
+	static constexpr int32 TitleWeight = 3;
+
+	/** Ranking weight of a word found in the body */
+	static constexpr int32 BodyWeight = 1;
+
+	/**
+	 * Indexes an entry. Entries must be added in increasing index order
+	 * @param EntryIndex Index of the entry in the notebook
+	 * @param Title Title text of the entry
+	 * @param Body Body text of the entry
+	 */
+	void AddEntry(int32 EntryIndex, const FString& Title, const FString& Body);
+
+	/** Removes all entries */
+	void Reset();
+
+	/**
+	 * Finds the entries matching every word of the query, where each query word may be a prefix
+	 * Results are ranked by weight, exact words count double, ties go to the newest entry
+	 * @param Query Words to search for
+	 * @param MaxResults Maximum number of results, zero for all
+	 * @param OutEntryIndices Matching entry indices, best first
+	 */
+	void Search(FStringView Query, int32 MaxResults, TArray<int32>& OutEntryIndices) const;
+
+	/** Returns the number of distinct words in the index */
+	int32 GetNumWords() const { return Words.Num(); }
+
+	/** Splits text into lowercase alphanumeric words */
+	static void Tokenize(FStringView Text, TArray<FString>& OutWords);
+
+private:
+
+	/** A single entry containing a word */
+	struct FPosting
+	{
+		int32 EntryIndex;
+		int32 Weight;
+	};
+
+	/** Distinct words, by word ID */
+	TArray<FString> Words;
+
+	/** Entries containing each word, by word ID, sorted by entry index */
+	TArray<TArray<FPosting>> Postings;
+
+	/** Word IDs sorted alphabetically by word, for prefix lookups */
+	TArray<int32> SortedWordIDs;
+
+	/** Word ID by word */
+	TMap<FString, int32> WordIDs;
+
+	/** Returns the ID of a word, adding it if needed */
+	int32 FindOrAddWord(const FString& Word);
+
+	/** Returns the first position in SortedWordIDs whose word is not less than the given text */
+	int32 LowerBound(FStringView Text) const;
+};
@@ -5,10 +5,16 @@
 #include "GameFramework/Pawn.h"
 #include "Curves/CurveFloat.h"
 #include "Kismet/GameplayStatics.h"
+#include "GrimRailSaveSubsystem.h"
+#include "SignalSubsystem.h"
+#include "GrimRailSignificanceSubsystem.h"
+#include "GrimRailTickScheduler.h"
+#include "Engine/World.h"
 
 ARoomFlipActor::ARoomFlipActor()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// The rotation runs from the tick scheduler
+	PrimaryActorTick.bCanEverTick = false;
 
 	// Create root component for rotation
 	RoomRoot = CreateDefaultSubobject<USceneComponent>(TEXT("RoomRoot"));
@@ -17,8 +23,6 @@ ARoomFlipActor::ARoomFlipActor()
 	// Default values
 	CurrentState = ERoomFlipState::Idle;
 	RotationProgress = 0.0f;
-	AttachedPlayer = nullptr;
-	PlayerController = nullptr;
 	FlipCount = 0;
 }
 
@@ -28,19 +32,99 @@ void ARoomFlipActor::BeginPlay()
 
 	// Store the initial rotation
 	StartRotation = RoomRoot->GetComponentRotation();
+
+	// Restore the room state from earlier sessions
+	if (UGrimRailSaveSubsystem* SaveSubsystem = UGrimRailSaveSubsystem::Get(this))
+	{
+		if (const FGrimRailSavedRoomFlip* SavedFlip = SaveSubsystem->FindRoomFlip(this))
+		{
+			RestoreFlipState(SavedFlip->FlipCount, static_cast<ERoomFlipState>(SavedFlip->State), SavedFlip->RotationAngle, SavedFlip->Rotation);
+		}
+	}
+
+	// Listen to our flip signals
+	if (USignalSubsystem* SignalSubsystem = GetWorld()->GetSubsystem<USignalSubsystem>())
+	{
+		SignalSubsystem->RegisterReceiver(this);
+	}
+
+	// Rotate on the critical lane, players may be attached to the room
+	if (UGrimRailTickScheduler* Scheduler = GetWorld()->GetSubsystem<UGrimRailTickScheduler>())
+	{
+		RotationTaskID = Scheduler->RegisterTask(TEXT("RoomFlip"), EGrimRailTickLane::Critical, FGrimRailTickDelegate::CreateUObject(this, &ARoomFlipActor::ScheduledTick), false);
+	}
+
+	// Let the significance subsystem report the task, it runs whenever the room rotates
+	if (UGrimRailSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UGrimRailSignificanceSubsystem>())
+	{
+		Significance->RegisterActor(this, TEXT("RoomFlip"), false, FGrimRailTickStateDelegate::CreateUObject(this, &ARoomFlipActor::SetRotationTaskEnabled));
+	}
+
+	UpdateTickWork();
 }
 
-void ARoomFlipActor::Tick(float DeltaTime)
+void ARoomFlipActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
+	if (USignalSubsystem* SignalSubsystem = GetWorld()->GetSubsystem<USignalSubsystem>())
+	{
+		SignalSubsystem->UnregisterReceiver(this);
+	}
 
+	if (UGrimRailSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UGrimRailSignificanceSubsystem>())
+	{
+		Significance->UnregisterActor(this);
+	}
+
+	if (UGrimRailTickScheduler* Scheduler = GetWorld()->GetSubsystem<UGrimRailTickScheduler>())
+	{
+		Scheduler->UnregisterTask(RotationTaskID);
+	}
+
+	RotationTaskID = INDEX_NONE;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ARoomFlipActor::ScheduledTick(float DeltaTime)
+{
 	if (CurrentState == ERoomFlipState::Rotating)
 	{
 		UpdateRotation(DeltaTime);
 	}
 }
 
+void ARoomFlipActor::GetSubscribedSignals(TArray<FName>& OutSignals) const
+{
+	OutSignals.Append(FlipSignals);
+}
+
+void ARoomFlipActor::ReceiveSignal(FName Signal, AActor* Sender)
+{
+	TriggerFlip();
+}
+
+void ARoomFlipActor::ReceiveSignalBatch(FName Signal, AActor* Sender, TConstArrayView<ISignalReceiver*> Receivers)
+{
+	// Look the local players up once for the whole batch
+	TArray<APlayerController*> LocalPlayers;
+	GetLocalPlayerControllers(GetWorld(), LocalPlayers);
+
+	for (ISignalReceiver* Receiver : Receivers)
+	{
+		// Batches only hold receivers of our class
+		static_cast<ARoomFlipActor*>(Receiver)->StartFlip(LocalPlayers);
+	}
+}
+
 bool ARoomFlipActor::TriggerFlip()
+{
+	TArray<APlayerController*> LocalPlayers;
+	GetLocalPlayerControllers(GetWorld(), LocalPlayers);
+
+	return StartFlip(LocalPlayers);
+}
+
+bool ARoomFlipActor::StartFlip(TConstArrayView<APlayerController*> LocalPlayers)
 {
 	if (!CanFlip())
 	{
@@ -52,6 +136,7 @@ bool ARoomFlipActor::TriggerFlip()
 	CurrentState = ERoomFlipState::Rotating;
 	RotationProgress = 0.0f;
 	FlipCount++;
+	UpdateTickWork();
 
 	// Store starting rotation
 	StartRotation = RoomRoot->GetComponentRotation();
@@ -59,27 +144,56 @@ bool ARoomFlipActor::TriggerFlip()
 	// Calculate target rotation
 	TargetRotation = CalculateTargetRotation();
 
-	// Attach player if configured
+	// Attach every player standing in the room if configured
 	if (bAttachPlayer)
 	{
-		AttachPlayerToRoom();
+		for (APlayerController* LocalPlayer : LocalPlayers)
+		{
+			const APawn* Pawn = LocalPlayer ? LocalPlayer->GetPawn() : nullptr;
+
+			// Skip players already riding another room flipping in the same batch
+			if (Pawn && !Cast<ARoomFlipActor>(Pawn->GetAttachParentActor()) && IsInsideRoom(Pawn->GetActorLocation()))
+			{
+				AttachPlayerToRoom(LocalPlayer);
+			}
+		}
 	}
 
-	// Disable player input if configured
-	if (bDisablePlayerInput && PlayerController)
+	// Disable input for the attached players if configured
+	if (bDisablePlayerInput)
 	{
-		PlayerController->DisableInput(PlayerController);
+		for (APawn* Pawn : AttachedPlayers)
+		{
+			if (APlayerController* PC = Cast<APlayerController>(Pawn->GetController()))
+			{
+				PC->DisableInput(PC);
+				BlockedControllers.Add(PC);
+			}
+		}
 	}
 
 	// Broadcast started event
 	OnRoomFlipStarted.Broadcast(this);
 	BP_OnFlipStarted();
 
-	UE_LOG(LogTemp, Log, TEXT("RoomFlipActor: Flip started (Flip #%d)"), FlipCount);
+	UE_LOG(LogTemp, Log, TEXT("RoomFlipActor: Flip started (Flip #%d, %d players attached)"), FlipCount, AttachedPlayers.Num());
 
 	return true;
 }
 
+void ARoomFlipActor::GetLocalPlayerControllers(const UWorld* World, TArray<APlayerController*>& OutPlayers)
+{
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+
+		if (PC && PC->IsLocalController())
+		{
+			OutPlayers.Add(PC);
+		}
+	}
+}
+
 bool ARoomFlipActor::CanFlip() const
 {
 	// Cannot flip if already rotating
@@ -97,19 +211,38 @@ bool ARoomFlipActor::CanFlip() const
 	return true;
 }
 
+void ARoomFlipActor::RestoreFlipState(int32 InFlipCount, ERoomFlipState InState, float InRotationAngle, const FRotator& InRotation)
+{
+	// A flip in progress is restored as finished
+	CurrentState = InState == ERoomFlipState::Rotating ? ERoomFlipState::Completed : InState;
+	FlipCount = InFlipCount;
+	RotationAngle = InRotationAngle;
+	RotationProgress = CurrentState == ERoomFlipState::Completed ? 1.0f : 0.0f;
+
+	RoomRoot->SetWorldRotation(InRotation);
+	UpdateTickWork();
+
+	UE_LOG(LogTemp, Log, TEXT("RoomFlipActor: Restored saved state (Flip #%d)"), FlipCount);
+}
+
 void ARoomFlipActor::ResetRoom()
 {
 	CurrentState = ERoomFlipState::Idle;
 	RotationProgress = 0.0f;
 	FlipCount = 0;
+	UpdateTickWork();
 
 	// Reset rotation to original
 	RoomRoot->SetWorldRotation(StartRotation);
 
-	// Detach player if attached
-	if (AttachedPlayer)
+	// Detach players if attached
+	DetachPlayersFromRoom();
+	UnblockPlayerInput();
+
+	// Persist the reset
+	if (UGrimRailSaveSubsystem* SaveSubsystem = UGrimRailSaveSubsystem::Get(this))
 	{
-		DetachPlayerFromRoom();
+		SaveSubsystem->RecordRoomFlip(this);
 	}
 
 	UE_LOG(LogTemp, Log, TEXT("RoomFlipActor: Room reset to initial state"));
@@ -145,18 +278,13 @@ void ARoomFlipActor::UpdateRotation(float DeltaTime)
 	if (RotationProgress >= 1.0f)
 	{
 		CurrentState = ERoomFlipState::Completed;
+		UpdateTickWork();
 
-		// Detach player
-		if (AttachedPlayer)
-		{
-			DetachPlayerFromRoom();
-		}
+		// Detach players
+		DetachPlayersFromRoom();
 
 		// Re-enable player input
-		if (bDisablePlayerInput && PlayerController)
-		{
-			PlayerController->EnableInput(PlayerController);
-		}
+		UnblockPlayerInput();
 
 		// Broadcast completed event
 		OnRoomFlipCompleted.Broadcast(this);
@@ -174,59 +302,87 @@ void ARoomFlipActor::UpdateRotation(float DeltaTime)
 			}
 		}
 
+		// Persist the new room state
+		if (UGrimRailSaveSubsystem* SaveSubsystem = UGrimRailSaveSubsystem::Get(this))
+		{
+			SaveSubsystem->RecordRoomFlip(this);
+		}
+
 		UE_LOG(LogTemp, Log, TEXT("RoomFlipActor: Flip completed"));
 	}
 }
 
-void ARoomFlipActor::AttachPlayerToRoom()
+void ARoomFlipActor::AttachPlayerToRoom(APlayerController* InPlayerController)
 {
 	// Get player pawn
-	PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
-	if (!PlayerController)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("RoomFlipActor: No player controller found"));
-		return;
-	}
-
-	AttachedPlayer = PlayerController->GetPawn();
-	if (!AttachedPlayer)
+	APawn* Pawn = InPlayerController ? InPlayerController->GetPawn() : nullptr;
+	if (!Pawn)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("RoomFlipActor: No player pawn found"));
 		return;
 	}
 
 	// Attach pawn to room root with KeepWorld rules to maintain current position
-	AttachedPlayer->AttachToComponent(
+	Pawn->AttachToComponent(
 		RoomRoot,
 		FAttachmentTransformRules::KeepWorldTransform
 	);
 
+	AttachedPlayers.Add(Pawn);
+
 	UE_LOG(LogTemp, Log, TEXT("RoomFlipActor: Player attached to room"));
 }
 
-void ARoomFlipActor::DetachPlayerFromRoom()
+void ARoomFlipActor::DetachPlayersFromRoom()
 {
-	if (AttachedPlayer)
+	for (APawn* Pawn : AttachedPlayers)
 	{
+		// Pawns may have been destroyed mid flip
+		if (!IsValid(Pawn))
+		{
+			continue;
+		}
+
 		// Store current location
-		FVector CurrentLocation = AttachedPlayer->GetActorLocation();
+		FVector CurrentLocation = Pawn->GetActorLocation();
 
 		// Detach player
-		AttachedPlayer->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+		Pawn->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
 
 		// Reset player rotation to upright (only keep yaw for facing direction)
-		FRotator CurrentRotation = AttachedPlayer->GetActorRotation();
+		FRotator CurrentRotation = Pawn->GetActorRotation();
 		FRotator UprightRotation = FRotator(0.0f, CurrentRotation.Yaw, 0.0f);
-		AttachedPlayer->SetActorRotation(UprightRotation);
+		Pawn->SetActorRotation(UprightRotation);
 
 		// Ensure player stays at current location
-		AttachedPlayer->SetActorLocation(CurrentLocation);
+		Pawn->SetActorLocation(CurrentLocation);
 
-		AttachedPlayer = nullptr;
 		UE_LOG(LogTemp, Log, TEXT("RoomFlipActor: Player detached from room and reset to upright"));
 	}
 
-	PlayerController = nullptr;
+	AttachedPlayers.Reset();
+}
+
+void ARoomFlipActor::UnblockPlayerInput()
+{
+	for (APlayerController* PC : BlockedControllers)
+	{
+		if (IsValid(PC))
+		{
+			PC->EnableInput(PC);
+		}
+	}
+
+	BlockedControllers.Reset();
+}
+
+bool ARoomFlipActor::IsInsideRoom(const FVector& Location) const
+{
+	FVector Origin;
+	FVector Extent;
+	GetActorBounds(true, Origin, Extent);
+
+	return FBox::BuildAABB(Origin, Extent).IsInsideOrOn(Location);
 }
 
 FRotator ARoomFlipActor::CalculateTargetRotation() const
@@ -263,3 +419,25 @@ FVector ARoomFlipActor::GetRotationAxisVector() const
 		return FVector::ForwardVector;
 	}
 }
+
+void ARoomFlipActor::UpdateTickWork()
+{
+	const bool bHasWork = CurrentState == ERoomFlipState::Rotating;
+
+	if (UGrimRailSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UGrimRailSignificanceSubsystem>())
+	{
+		Significance->SetHasWork(this, bHasWork);
+	}
+	else
+	{
+		SetRotationTaskEnabled(bHasWork);
+	}
+}
+
+void ARoomFlipActor::SetRotationTaskEnabled(bool bEnabled)
+{
+	if (UGrimRailTickScheduler* Scheduler = GetWorld()->GetSubsystem<UGrimRailTickScheduler>())
+	{
+		Scheduler->SetTaskEnabled(RotationTaskID, bEnabled);
+	}
+}
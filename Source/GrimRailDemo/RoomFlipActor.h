@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "SignalReceiver.h"
 #include "RoomFlipActor.generated.h"
 
 /** Current state of the room flip */
@@ -39,7 +40,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnRoomFlipProgress, ARoomFlipActor
  * Core mechanic for GrimRail-style environmental puzzles
  */
 UCLASS()
-class GRIMRAILDEMO_API ARoomFlipActor : public AActor
+class GRIMRAILDEMO_API ARoomFlipActor : public AActor, public ISignalReceiver
 {
 	GENERATED_BODY()
 
@@ -85,6 +86,10 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Room Flip")
 	bool bReverseEachFlip = true;
 
+	/** Signals that flip the room. Rooms listening to the same signal flip together */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Room Flip")
+	TArray<FName> FlipSignals;
+
 	/** Starting rotation of the room */
 	FRotator StartRotation;
 
@@ -94,15 +99,18 @@ protected:
 	/** Current rotation progress (0 to 1) */
 	float RotationProgress = 0.0f;
 
-	/** Player pawn attached during rotation */
-	TObjectPtr<APawn> AttachedPlayer;
+	/** Player pawns attached during rotation */
+	TArray<TObjectPtr<APawn>> AttachedPlayers;
 
-	/** Original player controller for re-enabling input */
-	TObjectPtr<APlayerController> PlayerController;
+	/** Player controllers whose input was disabled during rotation */
+	TArray<TObjectPtr<APlayerController>> BlockedControllers;
 
 	/** Number of times this room has been flipped */
 	int32 FlipCount = 0;
 
+	/** Tick scheduler task running the rotation */
+	int32 RotationTaskID = INDEX_NONE;
+
 public:
 
 	/** Delegate broadcast when flip starts */
@@ -124,10 +132,16 @@ public:
 protected:
 
 	virtual void BeginPlay() override;
-	virtual void Tick(float DeltaTime) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 
+	//~Begin ISignalReceiver Interface
+	virtual void GetSubscribedSignals(TArray<FName>& OutSignals) const override;
+	virtual void ReceiveSignal(FName Signal, AActor* Sender) override;
+	virtual void ReceiveSignalBatch(FName Signal, AActor* Sender, TConstArrayView<ISignalReceiver*> Receivers) override;
+	//~End ISignalReceiver Interface
+
 	/**
 	 * Triggers the room flip sequence
 	 * @return True if the flip was started, false if it cannot flip right now
@@ -163,6 +177,22 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Room Flip")
 	int32 GetFlipCount() const { return FlipCount; }
 
+	/**
+	 * Gets the angle the next flip will rotate by
+	 * @return Rotation angle in degrees
+	 */
+	UFUNCTION(BlueprintPure, Category = "Room Flip")
+	float GetRotationAngle() const { return RotationAngle; }
+
+	/**
+	 * Restores the room to a previously saved state without playing the flip
+	 * @param InFlipCount Number of flips done so far
+	 * @param InState Flip state to restore
+	 * @param InRotationAngle Angle the next flip will rotate by
+	 * @param InRotation World rotation of the room
+	 */
+	void RestoreFlipState(int32 InFlipCount, ERoomFlipState InState, float InRotationAngle, const FRotator& InRotation);
+
 	/**
 	 * Resets the room to its original rotation (for testing/debugging)
 	 */
@@ -192,14 +222,47 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent, Category = "Room Flip", meta = (DisplayName = "On Flip Progress"))
 	void BP_OnFlipProgress(float Progress);
 
+	/**
+	 * Starts the flip sequence
+	 * @param LocalPlayers Local players whose pawns are taken along if they stand inside the room
+	 * @return True if the flip was started
+	 */
+	bool StartFlip(TConstArrayView<APlayerController*> LocalPlayers);
+
+	/**
+	 * Gets the player controllers of every local player
+	 * @param World World to look in
+	 * @param OutPlayers Array to add the player controllers to
+	 */
+	static void GetLocalPlayerControllers(const UWorld* World, TArray<APlayerController*>& OutPlayers);
+
+	/**
+	 * Checks whether a location is inside the room
+	 * @param Location World location to check
+	 * @return True if the location is within the room's bounds
+	 */
+	bool IsInsideRoom(const FVector& Location) const;
+
 	/** Handles the rotation update each tick */
 	void UpdateRotation(float DeltaTime);
 
-	/** Attaches the player pawn to the room */
-	void AttachPlayerToRoom();
+	/** Attaches a player's pawn to the room */
+	void AttachPlayerToRoom(APlayerController* InPlayerController);
+
+	/** Detaches all player pawns from the room */
+	void DetachPlayersFromRoom();
+
+	/** Re-enables input for the players blocked during the flip */
+	void UnblockPlayerInput();
+
+	/** Runs the rotation from the tick scheduler's critical lane */
+	void ScheduledTick(float DeltaTime);
+
+	/** Turns the rotation task on while rotating and off otherwise */
+	void UpdateTickWork();
 
-	/** Detaches the player pawn from the room */
-	void DetachPlayerFromRoom();
+	/** Pauses or resumes the rotation task */
+	void SetRotationTaskEnabled(bool bEnabled);
 
 	/** Calculates the target rotation based on axis and angle */
 	FRotator CalculateTargetRotation() const;
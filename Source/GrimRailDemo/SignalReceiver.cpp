@@ -0,0 +1,11 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SignalReceiver.h"
+
+void ISignalReceiver::ReceiveSignalBatch(FName Signal, AActor* Sender, TConstArrayView<ISignalReceiver*> Receivers)
+{
+	for (ISignalReceiver* Receiver : Receivers)
+	{
+		Receiver->ReceiveSignal(Signal, Sender);
+	}
+}
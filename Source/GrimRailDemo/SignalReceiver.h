@@ -0,0 +1,48 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "SignalReceiver.generated.h"
+
+// This class does not need to be modified.
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class USignalReceiver : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Interface for objects that react to signals emitted by triggers
+ * Receivers register with the signal subsystem, which resolves who listens to which signal once
+ * and dispatches every receiver of the same class in a single batch
+ */
+class GRIMRAILDEMO_API ISignalReceiver
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 * Gets the signals this receiver listens to
+	 * @param OutSignals Array to add the signal names to
+	 */
+	virtual void GetSubscribedSignals(TArray<FName>& OutSignals) const = 0;
+
+	/**
+	 * Called when a subscribed signal is emitted
+	 * @param Signal Name of the signal
+	 * @param Sender Actor that emitted the signal, if any
+	 */
+	virtual void ReceiveSignal(FName Signal, AActor* Sender) = 0;
+
+	/**
+	 * Called once per signal for all its receivers of the same class, on the first one of them
+	 * Override to activate the receivers together. By default calls ReceiveSignal on each
+	 * @param Signal Name of the signal
+	 * @param Sender Actor that emitted the signal, if any
+	 * @param Receivers All receivers of this class listening to the signal, including this one
+	 */
+	virtual void ReceiveSignalBatch(FName Signal, AActor* Sender, TConstArrayView<ISignalReceiver*> Receivers);
+};
@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SignalReceiverComponent.h"
+#include "SignalSubsystem.h"
+#include "Engine/World.h"
+
+USignalReceiverComponent::USignalReceiverComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void USignalReceiverComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (USignalSubsystem* SignalSubsystem = GetWorld()->GetSubsystem<USignalSubsystem>())
+	{
+		SignalSubsystem->RegisterReceiver(this);
+	}
+}
+
+void USignalReceiverComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (USignalSubsystem* SignalSubsystem = GetWorld()->GetSubsystem<USignalSubsystem>())
+	{
+		SignalSubsystem->UnregisterReceiver(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USignalReceiverComponent::GetSubscribedSignals(TArray<FName>& OutSignals) const
+{
+	OutSignals.Append(Signals);
+}
+
+void USignalReceiverComponent::ReceiveSignal(FName Signal, AActor* Sender)
+{
+	OnSignalReceived.Broadcast(Signal, Sender);
+}
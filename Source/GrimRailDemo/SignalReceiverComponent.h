@@ -0,0 +1,52 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SignalReceiver.h"
+#include "SignalReceiverComponent.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSignalReceived, FName, Signal, AActor*, Sender);
+
+/**
+ * Lets any actor react to trigger signals, e.g. doors and lights set up in Blueprint
+ * Listens to a list of signals and broadcasts a delegate when one of them is emitted
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class GRIMRAILDEMO_API USignalReceiverComponent : public UActorComponent, public ISignalReceiver
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Signals this component listens to */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Signals")
+	TArray<FName> Signals;
+
+public:
+
+	/** Called when one of the signals is emitted */
+	UPROPERTY(BlueprintAssignable, Category = "Signals")
+	FOnSignalReceived OnSignalReceived;
+
+public:
+
+	/** Constructor */
+	USignalReceiverComponent();
+
+protected:
+
+	/** Registers with the signal subsystem */
+	virtual void BeginPlay() override;
+
+	/** Unregisters from the signal subsystem */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+
+	//~Begin ISignalReceiver Interface
+	virtual void GetSubscribedSignals(TArray<FName>& OutSignals) const override;
+	virtual void ReceiveSignal(FName Signal, AActor* Sender) override;
+	//~End ISignalReceiver Interface
+};
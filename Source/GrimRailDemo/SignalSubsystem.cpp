@@ -0,0 +1,173 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SignalSubsystem.h"
+#include "SignalReceiver.h"
+#include "GrimRailDemo.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "Algo/StableSort.h"
+
+bool USignalSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USignalSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// receivers register in their BeginPlay, which runs after this. Resolve everything the level
+	// registered on the next tick, so the first interaction doesn't pay for it
+	InWorld.GetTimerManager().SetTimerForNextTick(this, &USignalSubsystem::RebuildDirtySignals);
+}
+
+void USignalSubsystem::RegisterReceiver(ISignalReceiver* Receiver)
+{
+	UObject* Object = Receiver ? Receiver->_getUObject() : nullptr;
+
+	if (!Object)
+	{
+		return;
+	}
+
+	TArray<FName> Signals;
+	Receiver->GetSubscribedSignals(Signals);
+
+	for (const FName& Signal : Signals)
+	{
+		if (Signal.IsNone())
+		{
+			continue;
+		}
+
+		Subscribers.FindOrAdd(Signal).AddUnique(Object);
+		DirtySignals.Add(Signal);
+	}
+}
+
+void USignalSubsystem::UnregisterReceiver(ISignalReceiver* Receiver)
+{
+	UObject* Object = Receiver ? Receiver->_getUObject() : nullptr;
+
+	if (!Object)
+	{
+		return;
+	}
+
+	TArray<FName> Signals;
+	Receiver->GetSubscribedSignals(Signals);
+
+	for (const FName& Signal : Signals)
+	{
+		if (TArray<TWeakObjectPtr<UObject>>* SignalSubscribers = Subscribers.Find(Signal))
+		{
+			if (SignalSubscribers->Remove(Object) > 0)
+			{
+				DirtySignals.Add(Signal);
+			}
+		}
+	}
+}
+
+int32 USignalSubsystem::EmitSignal(FName Signal, AActor* Sender)
+{
+	// a receiver emitting its own signal must not rebuild the list we're walking
+	if (DispatchDepth == 0)
+	{
+		RebuildDirtySignals();
+	}
+
+	const FSignalDispatchList* DispatchList = DispatchLists.Find(Signal);
+
+	if (!DispatchList)
+	{
+		UE_LOG(LogGrimRailDemo, Verbose, TEXT("SignalSubsystem: Signal %s has no receivers"), *Signal.ToString());
+		return 0;
+	}
+
+	++DispatchDepth;
+
+	int32 NumReceived = 0;
+
+	for (const FSignalBatch& Batch : DispatchList->Batches)
+	{
+		// skip receivers that were destroyed since the list was built
+		TArray<ISignalReceiver*, TInlineAllocator<16>> Receivers;
+
+		for (int32 Index = 0; Index < Batch.Objects.Num(); ++Index)
+		{
+			if (Batch.Objects[Index].IsValid())
+			{
+				Receivers.Add(Batch.Receivers[Index]);
+			}
+		}
+
+		if (Receivers.Num() > 0)
+		{
+			Receivers[0]->ReceiveSignalBatch(Signal, Sender, Receivers);
+			NumReceived += Receivers.Num();
+		}
+	}
+
+	--DispatchDepth;
+
+	return NumReceived;
+}
+
+void USignalSubsystem::RebuildDirtySignals()
+{
+	for (const FName& Signal : DirtySignals)
+	{
+		TArray<TWeakObjectPtr<UObject>>* SignalSubscribers = Subscribers.Find(Signal);
+
+		// forget destroyed receivers
+		if (SignalSubscribers)
+		{
+			SignalSubscribers->RemoveAll([](const TWeakObjectPtr<UObject>& Object)
+			{
+				return !Object.IsValid();
+			});
+		}
+
+		if (!SignalSubscribers || SignalSubscribers->Num() == 0)
+		{
+			Subscribers.Remove(Signal);
+			DispatchLists.Remove(Signal);
+			continue;
+		}
+
+		// group the receivers by class so each class gets one batch call
+		TArray<UObject*> Objects;
+		Objects.Reserve(SignalSubscribers->Num());
+
+		for (const TWeakObjectPtr<UObject>& Object : *SignalSubscribers)
+		{
+			Objects.Add(Object.Get());
+		}
+
+		Algo::StableSortBy(Objects, [](const UObject* Object)
+		{
+			return Object->GetClass()->GetFName();
+		}, FNameLexicalLess());
+
+		FSignalDispatchList& DispatchList = DispatchLists.FindOrAdd(Signal);
+		DispatchList.Batches.Reset();
+
+		const UClass* BatchClass = nullptr;
+
+		for (UObject* Object : Objects)
+		{
+			if (Object->GetClass() != BatchClass)
+			{
+				BatchClass = Object->GetClass();
+				DispatchList.Batches.AddDefaulted();
+			}
+
+			FSignalBatch& Batch = DispatchList.Batches.Last();
+			Batch.Objects.Add(Object);
+			Batch.Receivers.Add(CastChecked<ISignalReceiver>(Object));
+		}
+	}
+
+	DirtySignals.Reset();
+}
@@ -0,0 +1,77 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SignalSubsystem.generated.h"
+
+class ISignalReceiver;
+
+/**
+ *  Routes named signals from triggers to the receivers listening to them
+ *  Subscriptions are resolved into flat dispatch lists, grouped by receiver class, when play starts
+ *  and again only for signals whose receivers changed. Emitting a signal never searches for actors
+ */
+UCLASS()
+class GRIMRAILDEMO_API USignalSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Receivers of the same class listening to a signal */
+	struct FSignalBatch
+	{
+		/** Receiver objects, used to skip the ones that were destroyed */
+		TArray<TWeakObjectPtr<UObject>> Objects;
+
+		/** Receiver interfaces, in the same order */
+		TArray<ISignalReceiver*> Receivers;
+	};
+
+	/** Everything a signal dispatches to */
+	struct FSignalDispatchList
+	{
+		TArray<FSignalBatch> Batches;
+	};
+
+	/** Receivers listening to each signal */
+	TMap<FName, TArray<TWeakObjectPtr<UObject>>> Subscribers;
+
+	/** Resolved dispatch lists */
+	TMap<FName, FSignalDispatchList> DispatchLists;
+
+	/** Signals whose dispatch list needs to be rebuilt */
+	TSet<FName> DirtySignals;
+
+	/** Number of signals being dispatched. Dispatch lists aren't rebuilt while this is above zero */
+	int32 DispatchDepth = 0;
+
+public:
+
+	/** Subscribes a receiver to the signals it listens to */
+	void RegisterReceiver(ISignalReceiver* Receiver);
+
+	/** Unsubscribes a receiver from all its signals */
+	void UnregisterReceiver(ISignalReceiver* Receiver);
+
+	/**
+	 * Emits a signal to every receiver listening to it
+	 * @param Signal Name of the signal
+	 * @param Sender Actor emitting the signal, passed to the receivers
+	 * @return Number of receivers the signal reached
+	 */
+	UFUNCTION(BlueprintCallable, Category="Signals")
+	int32 EmitSignal(FName Signal, AActor* Sender);
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	//~End UWorldSubsystem Interface
+
+	/** Rebuilds the dispatch lists of the dirty signals */
+	void RebuildDirtySignals();
+};
@@ -11,8 +11,15 @@
 #include "InputAction.h"
 #include "NotebookComponent.h"
 #include "Interactable.h"
+#include "InteractionSubsystem.h"
+#include "CharacterStatSubsystem.h"
+#include "LightExposureSubsystem.h"
 #include "DrawDebugHelpers.h"
 
+DECLARE_STATS_GROUP(TEXT("GrimRail Interaction"), STATGROUP_GrimRailInteraction, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Interaction Checks"), STAT_InteractionChecks, STATGROUP_GrimRailInteraction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Interaction Checks Skipped"), STAT_InteractionChecksSkipped, STATGROUP_GrimRailInteraction);
+
 AHorrorCharacter::AHorrorCharacter()
 {
 	// create the spotlight
@@ -34,28 +41,59 @@ void AHorrorCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// initialize sprint meter to max
-	SprintMeter = SprintTime;
-
 	// Initialize the walk speed
 	GetCharacterMovement()->MaxWalkSpeed = WalkSpeed;
 
-	// start the sprint tick timer
-	GetWorld()->GetTimerManager().SetTimer(SprintTimer, this, &AHorrorCharacter::SprintFixedTick, SprintFixedTickTime, true);
+	// hand stamina over to the character stat subsystem. It starts with a full meter
+	if (UCharacterStatSubsystem* CharacterStats = GetWorld()->GetSubsystem<UCharacterStatSubsystem>())
+	{
+		FStaminaSettings StaminaSettings;
+		StaminaSettings.MaxStamina = SprintTime;
+		StaminaSettings.RecoveryTime = RecoveryTime;
+		StaminaSettings.WalkSpeed = WalkSpeed;
+		StaminaSettings.SprintSpeed = SprintSpeed;
+		StaminaSettings.RecoveringWalkSpeed = RecoveringWalkSpeed;
+		StaminaSettings.OnMeterChanged.BindUObject(this, &AHorrorCharacter::HandleSprintMeterChanged);
+		StaminaSettings.OnSprintStateChanged.BindUObject(this, &AHorrorCharacter::HandleSprintStateChanged);
+
+		StaminaID = CharacterStats->RegisterStamina(this, StaminaSettings);
+	}
+
+	// start the interaction checks. They reschedule themselves depending on how the view moves
+	GetWorld()->GetTimerManager().SetTimer(InteractionCheckTimer, this, &AHorrorCharacter::UpdateInteractionCheck, InteractionCheckRate, false);
 
-	// start the interaction check timer
-	GetWorld()->GetTimerManager().SetTimer(InteractionCheckTimer, this, &AHorrorCharacter::CheckForInteractables, InteractionCheckRate, true);
+	// let the flashlight light up exposure receivers
+	if (ULightExposureSubsystem* LightExposure = GetWorld()->GetSubsystem<ULightExposureSubsystem>())
+	{
+		LightExposure->RegisterLight(SpotLight);
+	}
 }
 
 void AHorrorCharacter::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
-	// clear the sprint timer
-	GetWorld()->GetTimerManager().ClearTimer(SprintTimer);
+	// stop stamina updates
+	if (UCharacterStatSubsystem* CharacterStats = GetWorld()->GetSubsystem<UCharacterStatSubsystem>())
+	{
+		CharacterStats->UnregisterStamina(StaminaID);
+	}
+
+	StaminaID = INDEX_NONE;
 
-	// clear the interaction check timer
+	// clear the interaction check timer and any check still waiting for the batch
 	GetWorld()->GetTimerManager().ClearTimer(InteractionCheckTimer);
+
+	if (UInteractionSubsystem* InteractionSubsystem = GetWorld()->GetSubsystem<UInteractionSubsystem>())
+	{
+		InteractionSubsystem->CancelViewer(this);
+	}
+
+	// unregister the flashlight
+	if (ULightExposureSubsystem* LightExposure = GetWorld()->GetSubsystem<ULightExposureSubsystem>())
+	{
+		LightExposure->UnregisterLight(SpotLight);
+	}
 }
 
 void AHorrorCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -87,82 +125,30 @@ void AHorrorCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCom
 
 void AHorrorCharacter::DoStartSprint()
 {
-	// set the sprinting flag
-	bSprinting = true;
-
-	// are we out of recovery mode?
-	if (!bRecovering)
+	// the stat subsystem switches to the sprint speed unless we're recovering
+	if (UCharacterStatSubsystem* CharacterStats = GetWorld()->GetSubsystem<UCharacterStatSubsystem>())
 	{
-		// set the sprint walk speed
-		GetCharacterMovement()->MaxWalkSpeed = SprintSpeed;
-
-		// call the sprint state changed delegate
-		OnSprintStateChanged.Broadcast(true);
+		CharacterStats->SetWantsToSprint(StaminaID, true);
 	}
-
 }
 
 void AHorrorCharacter::DoEndSprint()
 {
-	// set the sprinting flag
-	bSprinting = false;
-
-	// are we out of recovery mode?
-	if (!bRecovering)
+	// the stat subsystem switches back to the walk speed unless we're recovering
+	if (UCharacterStatSubsystem* CharacterStats = GetWorld()->GetSubsystem<UCharacterStatSubsystem>())
 	{
-		// set the default walk speed
-		GetCharacterMovement()->MaxWalkSpeed = WalkSpeed;
-
-		// call the sprint state changed delegate
-		OnSprintStateChanged.Broadcast(false);
+		CharacterStats->SetWantsToSprint(StaminaID, false);
 	}
 }
 
-void AHorrorCharacter::SprintFixedTick()
+void AHorrorCharacter::HandleSprintMeterChanged(float Percent)
 {
-	// are we out of recovery, still have stamina and are moving faster than our walk speed?
-	if (bSprinting && !bRecovering && GetVelocity().Length() > WalkSpeed)
-	{
-
-		// do we still have meter to burn?
-		if (SprintMeter > 0.0f)
-		{
-			// update the sprint meter
-			SprintMeter = FMath::Max(SprintMeter - SprintFixedTickTime, 0.0f);
-
-			// have we run out of stamina?
-			if (SprintMeter <= 0.0f)
-			{
-				// raise the recovering flag
-				bRecovering = true;
-
-				// set the recovering walk speed
-				GetCharacterMovement()->MaxWalkSpeed = RecoveringWalkSpeed;
-			}
-		}
-		
-	} else {
-
-		// recover stamina
-		SprintMeter = FMath::Min(SprintMeter + SprintFixedTickTime, SprintTime);
-
-		if (SprintMeter >= SprintTime)
-		{
-			// lower the recovering flag
-			bRecovering = false;
-
-			// set the walk or sprint speed depending on whether the sprint button is down
-			GetCharacterMovement()->MaxWalkSpeed = bSprinting ? SprintSpeed : WalkSpeed;
-
-			// update the sprint state depending on whether the button is down or not
-			OnSprintStateChanged.Broadcast(bSprinting);
-		}
-
-	}
-
-	// broadcast the sprint meter updated delegate
-	OnSprintMeterUpdated.Broadcast(SprintMeter / SprintTime);
+	OnSprintMeterUpdated.Broadcast(Percent);
+}
 
+void AHorrorCharacter::HandleSprintStateChanged(bool bSprinting)
+{
+	OnSprintStateChanged.Broadcast(bSprinting);
 }
 
 void AHorrorCharacter::DoInteract()
@@ -190,6 +176,79 @@ void AHorrorCharacter::DoToggleNotebook()
 	OnNotebookToggled.Broadcast(bIsNotebookOpen);
 
 	UE_LOG(LogTemp, Log, TEXT("HorrorCharacter: Notebook %s"), bIsNotebookOpen ? TEXT("opened") : TEXT("closed"));
+
+	// drop or regain focus right away instead of waiting for the next check
+	RequestInteractionCheck();
+}
+
+void AHorrorCharacter::UpdateInteractionCheck()
+{
+	const UCameraComponent* Camera = GetFirstPersonCameraComponent();
+	const FVector ViewLocation = Camera->GetComponentLocation();
+	const FQuat ViewRotation = Camera->GetComponentQuat();
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	UInteractionSubsystem* InteractionSubsystem = GetWorld()->GetSubsystem<UInteractionSubsystem>();
+	const uint32 Revision = InteractionSubsystem ? InteractionSubsystem->GetRevision() : 0;
+
+	// how much has the view moved since the last real check?
+	const float TimeSinceCheck = FMath::Max(static_cast<float>(Now - LastInteractionCheckTime), KINDA_SMALL_NUMBER);
+	const float TurnAngle = FMath::RadiansToDegrees(ViewRotation.AngularDistance(LastInteractionViewRotation));
+	const float MoveDistance = FVector::Dist(ViewLocation, LastInteractionViewLocation);
+
+	// the last result still holds if neither the view nor the interactables changed
+	const bool bUnchanged = LastInteractionCheckTime >= 0.0
+		&& TurnAngle < 0.5f
+		&& MoveDistance < 1.0f
+		&& Revision == LastInteractionRevision
+		&& TimeSinceCheck < InteractionMaxSkipTime;
+
+	if (bUnchanged)
+	{
+		INC_DWORD_STAT(STAT_InteractionChecksSkipped);
+
+	} else {
+
+		INC_DWORD_STAT(STAT_InteractionChecks);
+
+		CheckForInteractables();
+
+		LastInteractionViewLocation = ViewLocation;
+		LastInteractionViewRotation = ViewRotation;
+		LastInteractionRevision = Revision;
+		LastInteractionCheckTime = Now;
+	}
+
+	// back off when nothing registered is in reach, looking ahead by how far we can walk until the next check
+	const float ReachAhead = InteractionDistance + GetVelocity().Size() * InteractionIdleCheckRate;
+	const bool bAnythingNearby = CurrentInteractable || (InteractionSubsystem && InteractionSubsystem->HasInteractableWithin(ViewLocation, ReachAhead));
+
+	float NextCheckDelay = InteractionCheckRate;
+
+	if (!bAnythingNearby)
+	{
+		NextCheckDelay = InteractionIdleCheckRate;
+
+	} else if (!bUnchanged && TurnAngle / TimeSinceCheck > InteractionFastTurnRate) {
+
+		// the view is sweeping across things, keep up with it
+		NextCheckDelay = InteractionFastCheckRate;
+	}
+
+	GetWorld()->GetTimerManager().SetTimer(InteractionCheckTimer, this, &AHorrorCharacter::UpdateInteractionCheck, FMath::Max(NextCheckDelay, 0.01f), false);
+}
+
+void AHorrorCharacter::RequestInteractionCheck()
+{
+	// forget the last check so this one can't be skipped
+	LastInteractionCheckTime = -1.0;
+	UpdateInteractionCheck();
+
+	// and answer it now instead of with the next batch
+	if (UInteractionSubsystem* InteractionSubsystem = GetWorld()->GetSubsystem<UInteractionSubsystem>())
+	{
+		InteractionSubsystem->ResolveViewerNow(this);
+	}
 }
 
 void AHorrorCharacter::CheckForInteractables()
@@ -204,6 +263,54 @@ void AHorrorCharacter::CheckForInteractables()
 		return;
 	}
 
+	// Score the registered interactables together with the other local players' views
+	if (UInteractionSubsystem* InteractionSubsystem = GetWorld()->GetSubsystem<UInteractionSubsystem>())
+	{
+		InteractionSubsystem->QueueViewer(this, this);
+	}
+	else
+	{
+		ReceiveInteractionResult(nullptr);
+	}
+}
+
+bool AHorrorCharacter::BuildInteractionQuery(FInteractionQuery& OutQuery)
+{
+	// The notebook may have opened since the check was queued
+	if (bIsNotebookOpen)
+	{
+		return false;
+	}
+
+	OutQuery.ViewLocation = GetFirstPersonCameraComponent()->GetComponentLocation();
+	OutQuery.ViewDirection = GetFirstPersonCameraComponent()->GetForwardVector();
+	OutQuery.MaxDistance = InteractionDistance;
+	OutQuery.MaxAngle = InteractionMaxAngle;
+	OutQuery.Hysteresis = InteractionFocusHysteresis;
+	OutQuery.CurrentFocus = CurrentInteractable;
+	OutQuery.PlayerController = Cast<APlayerController>(GetController());
+	OutQuery.IgnoredActor = this;
+
+	return true;
+}
+
+void AHorrorCharacter::ReceiveInteractionResult(AActor* BestInteractable)
+{
+	// Fall back to the center ray for interactables that aren't registered
+	if (!BestInteractable)
+	{
+		BestInteractable = TraceForInteractable();
+	}
+
+	// Only change focus when the winner actually changes
+	if (BestInteractable != CurrentInteractable)
+	{
+		SetCurrentInteractable(BestInteractable);
+	}
+}
+
+AActor* AHorrorCharacter::TraceForInteractable() const
+{
 	// Get camera location and forward vector
 	FVector CameraLocation = GetFirstPersonCameraComponent()->GetComponentLocation();
 	FVector CameraForward = GetFirstPersonCameraComponent()->GetForwardVector();
@@ -241,21 +348,13 @@ void AHorrorCharacter::CheckForInteractables()
 			IInteractable* Interactable = Cast<IInteractable>(HitResult.GetActor());
 			if (Interactable && Interactable->Execute_CanInteract(HitResult.GetActor(), Cast<APlayerController>(GetController())))
 			{
-				// Set this as the new interactable if it's different
-				if (CurrentInteractable != HitResult.GetActor())
-				{
-					SetCurrentInteractable(HitResult.GetActor());
-				}
-				return;
+				return HitResult.GetActor();
 			}
 		}
 	}
 
 	// No valid interactable found
-	if (CurrentInteractable)
-	{
-		SetCurrentInteractable(nullptr);
-	}
+	return nullptr;
 }
 
 void AHorrorCharacter::SetCurrentInteractable(AActor* NewInteractable)
@@ -281,7 +380,9 @@ void AHorrorCharacter::SetCurrentInteractable(AActor* NewInteractable)
 		{
 			Interactable->Execute_OnInteractionFocus(CurrentInteractable.Get(), Cast<APlayerController>(GetController()));
 
-			FText Prompt = Interactable->Execute_GetInteractionPrompt(CurrentInteractable.Get());
+			// Registered interactables build their prompt once
+			UInteractionSubsystem* InteractionSubsystem = GetWorld()->GetSubsystem<UInteractionSubsystem>();
+			FText Prompt = InteractionSubsystem ? InteractionSubsystem->GetInteractionPrompt(CurrentInteractable.Get()) : Interactable->Execute_GetInteractionPrompt(CurrentInteractable.Get());
 			OnInteractableDetected.Broadcast(CurrentInteractable.Get(), Prompt);
 		}
 	}
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GrimRailDemoCharacter.h"
+#include "InteractionSubsystem.h"
 #include "HorrorCharacter.generated.h"
 
 class USpotLightComponent;
@@ -22,7 +23,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnNotebookToggled, bool, bIsOpen);
  *  Provides stamina-based sprinting
  */
 UCLASS(abstract)
-class GRIMRAILDEMO_API AHorrorCharacter : public AGrimRailDemoCharacter
+class GRIMRAILDEMO_API AHorrorCharacter : public AGrimRailDemoCharacter, public IInteractionViewer
 {
 	GENERATED_BODY()
 
@@ -48,23 +49,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category ="Input")
 	UInputAction* ToggleNotebookAction;
 
-	/** If true, we're sprinting */
-	bool bSprinting = false;
-
-	/** If true, we're recovering stamina */
-	bool bRecovering = false;
-
 	/** Default walk speed when not sprinting or recovering */
 	UPROPERTY(EditAnywhere, Category="Walk")
 	float WalkSpeed = 250.0f;
 
-	/** Time interval for sprinting stamina ticks */
-	UPROPERTY(EditAnywhere, Category="Sprint", meta = (ClampMin = 0, ClampMax = 1, Units = "s"))
-	float SprintFixedTickTime = 0.03333f;
-
-	/** Sprint stamina amount. Maxes at SprintTime */
-	float SprintMeter = 0.0f;
-
 	/** How long we can sprint for, in seconds */
 	UPROPERTY(EditAnywhere, Category="Sprint", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
 	float SprintTime = 3.0f;
@@ -77,21 +65,45 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Recovery", meta = (ClampMin = 0, ClampMax = 10, Units = "cm/s"))
 	float RecoveringWalkSpeed = 150.0f;
 
-	/** Time it takes for the sprint meter to recover */
+	/** Time it takes for the sprint meter to recover. Zero recovers one second of sprint per second */
 	UPROPERTY(EditAnywhere, Category="Recovery", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
 	float RecoveryTime = 0.0f;
 
-	/** Sprint tick timer */
-	FTimerHandle SprintTimer;
+	/** Stamina ID in the character stat subsystem */
+	int32 StaminaID = INDEX_NONE;
 
 	/** Max distance for interaction raycasts */
 	UPROPERTY(EditAnywhere, Category="Interaction", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
 	float InteractionDistance = 120.0f;
 
+	/** Max angle from the view direction for registered interactables to be considered */
+	UPROPERTY(EditAnywhere, Category="Interaction", meta = (ClampMin = 0, ClampMax = 90, Units = "Degrees"))
+	float InteractionMaxAngle = 25.0f;
+
+	/** Score bonus the focused interactable keeps over challengers, so focus doesn't flicker between close candidates */
+	UPROPERTY(EditAnywhere, Category="Interaction", meta = (ClampMin = 0, ClampMax = 2))
+	float InteractionFocusHysteresis = 0.25f;
+
 	/** How often to check for interactable objects (seconds) */
 	UPROPERTY(EditAnywhere, Category="Interaction", meta = (ClampMin = 0, ClampMax = 1, Units = "s"))
 	float InteractionCheckRate = 0.1f;
 
+	/** How often to check for interactable objects while the view turns quickly */
+	UPROPERTY(EditAnywhere, Category="Interaction", meta = (ClampMin = 0, ClampMax = 1, Units = "s"))
+	float InteractionFastCheckRate = 0.033f;
+
+	/** How often to check for interactable objects while no registered interactable is nearby */
+	UPROPERTY(EditAnywhere, Category="Interaction", meta = (ClampMin = 0, ClampMax = 2, Units = "s"))
+	float InteractionIdleCheckRate = 0.3f;
+
+	/** View turn rate above which the fast check rate is used */
+	UPROPERTY(EditAnywhere, Category="Interaction", meta = (ClampMin = 0, Units = "DegreesPerSecond"))
+	float InteractionFastTurnRate = 120.0f;
+
+	/** Longest time a check may be skipped because nothing changed, to catch state changes of unregistered interactables */
+	UPROPERTY(EditAnywhere, Category="Interaction", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float InteractionMaxSkipTime = 1.0f;
+
 	/** Whether the notebook is currently open */
 	bool bIsNotebookOpen = false;
 
@@ -101,6 +113,18 @@ protected:
 	/** Timer for checking interactables */
 	FTimerHandle InteractionCheckTimer;
 
+	/** View location at the last interaction check */
+	FVector LastInteractionViewLocation = FVector::ZeroVector;
+
+	/** View rotation at the last interaction check */
+	FQuat LastInteractionViewRotation = FQuat::Identity;
+
+	/** Interaction subsystem revision at the last interaction check */
+	uint32 LastInteractionRevision = 0;
+
+	/** World time of the last interaction check. Negative forces the next check */
+	double LastInteractionCheckTime = -1.0;
+
 public:
 
 	/** Delegate called when the sprint meter should be updated */
@@ -142,8 +166,11 @@ protected:
 	UFUNCTION(BlueprintCallable, Category="Input")
 	void DoEndSprint();
 
-	/** Called while sprinting at a fixed time interval */
-	void SprintFixedTick();
+	/** Passes sprint meter changes from the character stat subsystem to listeners */
+	void HandleSprintMeterChanged(float Percent);
+
+	/** Passes sprint state changes from the character stat subsystem to listeners */
+	void HandleSprintStateChanged(bool bSprinting);
 
 	/** Handles interact button press */
 	UFUNCTION(BlueprintCallable, Category="Input")
@@ -153,12 +180,26 @@ protected:
 	UFUNCTION(BlueprintCallable, Category="Input")
 	void DoToggleNotebook();
 
-	/** Checks for interactable objects in front of the player */
+	/** Runs the interaction check if anything changed since the last one, and schedules the next one */
+	void UpdateInteractionCheck();
+
+	/** Runs an interaction check right away, e.g. after the notebook closes */
+	void RequestInteractionCheck();
+
+	/** Checks for interactable objects in front of the player. Queues the check with the other local players' */
 	void CheckForInteractables();
 
+	/** Returns the interactable hit by a ray through the center of the view, for interactables that aren't registered */
+	AActor* TraceForInteractable() const;
+
 	/** Sets the currently focused interactable */
 	void SetCurrentInteractable(AActor* NewInteractable);
 
+	//~Begin IInteractionViewer Interface
+	virtual bool BuildInteractionQuery(FInteractionQuery& OutQuery) override;
+	virtual void ReceiveInteractionResult(AActor* BestInteractable) override;
+	//~End IInteractionViewer Interface
+
 public:
 
 	/** Gets the notebook component */
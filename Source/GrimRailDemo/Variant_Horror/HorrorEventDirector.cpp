@@ -0,0 +1,325 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/HorrorEventDirector.h"
+#include "GrimRailTickScheduler.h"
+#include "HorrorEventMarker.h"
+#include "NotebookComponent.h"
+#include "Components/LightComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+
+void UHorrorEventDirector::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// run from the tick scheduler instead of ticking on our own
+	if (UGrimRailTickScheduler* Scheduler = Collection.InitializeDependency<UGrimRailTickScheduler>())
+	{
+		TickTaskID = Scheduler->RegisterTask(TEXT("HorrorEventDirector"), EGrimRailTickLane::Normal, FGrimRailTickDelegate::CreateUObject(this, &UHorrorEventDirector::ScheduledTick));
+	}
+}
+
+void UHorrorEventDirector::Deinitialize()
+{
+	if (UGrimRailTickScheduler* Scheduler = GetWorld()->GetSubsystem<UGrimRailTickScheduler>())
+	{
+		Scheduler->UnregisterTask(TickTaskID);
+	}
+
+	TickTaskID = INDEX_NONE;
+
+	Super::Deinitialize();
+}
+
+void UHorrorEventDirector::ScheduledTick(float DeltaTime)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// scheduled events that reached their start time become due
+	while (ScheduledEvents.Num() > 0 && ScheduledEvents.HeapTop().StartTime <= Now)
+	{
+		FScheduledEvent Scheduled;
+		ScheduledEvents.HeapPop(Scheduled, EAllowShrinking::No);
+
+		// skip markers that were unregistered while waiting
+		AHorrorEventMarker* Marker = Scheduled.Marker.Get();
+
+		if (Marker && QueuedMarkers.Remove(Marker) > 0)
+		{
+			QueueDueEvent(Marker, Now);
+		}
+	}
+
+	// throttle the condition checks
+	TimeSinceConditionCheck += DeltaTime;
+
+	if (TimeSinceConditionCheck >= ConditionCheckInterval && ConditionalEvents.Num() > 0)
+	{
+		UpdateConditions(Now);
+		TimeSinceConditionCheck = 0.0f;
+	}
+
+	StartDueEvents(Now);
+
+	UpdateFlickers(Now);
+}
+
+bool UHorrorEventDirector::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHorrorEventDirector::RegisterEvent(AHorrorEventMarker* Marker)
+{
+	if (!Marker)
+	{
+		return;
+	}
+
+	switch (Marker->GetTrigger())
+	{
+	case EHorrorEventTrigger::Scheduled:
+		ScheduleEvent(Marker, Marker->GetScheduleDelay());
+		break;
+
+	case EHorrorEventTrigger::Conditional:
+		ConditionalEvents.AddUnique(Marker);
+		break;
+
+	case EHorrorEventTrigger::Manual:
+		break;
+	}
+}
+
+void UHorrorEventDirector::UnregisterEvent(AHorrorEventMarker* Marker)
+{
+	// queued entries are skipped once the marker is gone
+	ConditionalEvents.RemoveSwap(Marker);
+	QueuedMarkers.Remove(Marker);
+}
+
+void UHorrorEventDirector::ScheduleEvent(AHorrorEventMarker* Marker, float Delay)
+{
+	if (!Marker || QueuedMarkers.Contains(Marker))
+	{
+		return;
+	}
+
+	QueuedMarkers.Add(Marker);
+	ScheduledEvents.HeapPush({ Marker, GetWorld()->GetTimeSeconds() + Delay });
+}
+
+void UHorrorEventDirector::StartFlicker(const TArray<ULightComponent*>& Lights, float Duration, float Interval)
+{
+	FActiveFlicker Flicker;
+
+	for (ULightComponent* Light : Lights)
+	{
+		// the array comes from Blueprint and may have empty entries
+		if (!Light)
+		{
+			continue;
+		}
+
+		// only the first flicker on a light saves its visibility. A later one could see it toggled off
+		FFlickerLight& FlickerLight = FlickerLights.FindOrAdd(Light, { Light->IsVisible(), 0 });
+		++FlickerLight.NumFlickers;
+
+		Flicker.Lights.Add(Light);
+	}
+
+	if (Flicker.Lights.Num() == 0)
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	Flicker.EndTime = Now + Duration;
+	Flicker.NextToggleTime = Now;
+	Flicker.Interval = FMath::Max(Interval, 0.01f);
+	Flicker.bLightsOn = true;
+
+	ActiveFlickers.Add(MoveTemp(Flicker));
+}
+
+void UHorrorEventDirector::UpdateConditions(double Now)
+{
+	// drop markers that were destroyed without unregistering
+	ConditionalEvents.RemoveAllSwap([](const TWeakObjectPtr<AHorrorEventMarker>& Marker)
+	{
+		return !Marker.IsValid();
+	});
+
+	GatherPlayerSnapshots();
+
+	if (PlayerSnapshots.Num() == 0 || ConditionalEvents.Num() == 0)
+	{
+		return;
+	}
+
+	// check a slice of the conditional events, continuing where the last update stopped
+	const int32 NumChecks = FMath::Min(ConditionalEvents.Num(), MaxConditionChecksPerUpdate);
+
+	for (int32 Check = 0; Check < NumChecks; ++Check)
+	{
+		ConditionCursor = ConditionCursor % ConditionalEvents.Num();
+		AHorrorEventMarker* Marker = ConditionalEvents[ConditionCursor].Get();
+
+		// events that used up their starts don't need checking anymore
+		if (!Marker->HasStartsLeft())
+		{
+			ConditionalEvents.RemoveAtSwap(ConditionCursor, EAllowShrinking::No);
+
+			if (ConditionalEvents.Num() == 0)
+			{
+				break;
+			}
+
+			continue;
+		}
+
+		++ConditionCursor;
+
+		if (!QueuedMarkers.Contains(Marker) && Marker->CanStart(Now) && Marker->AreConditionsMet(PlayerSnapshots))
+		{
+			QueueDueEvent(Marker, Now);
+		}
+	}
+}
+
+void UHorrorEventDirector::GatherPlayerSnapshots()
+{
+	PlayerSnapshots.Reset();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+
+		if (!PlayerController || !PlayerController->IsLocalController())
+		{
+			continue;
+		}
+
+		const APawn* Pawn = PlayerController->GetPawn();
+
+		if (!Pawn)
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		FHorrorPlayerSnapshot& Snapshot = PlayerSnapshots.AddDefaulted_GetRef();
+		Snapshot.PlayerController = PlayerController;
+		Snapshot.Location = Pawn->GetActorLocation();
+		Snapshot.ViewLocation = ViewLocation;
+		Snapshot.ViewDirection = ViewRotation.Vector();
+		Snapshot.Notebook = Pawn->FindComponentByClass<UNotebookComponent>();
+	}
+}
+
+void UHorrorEventDirector::QueueDueEvent(AHorrorEventMarker* Marker, double Now)
+{
+	if (QueuedMarkers.Contains(Marker))
+	{
+		return;
+	}
+
+	QueuedMarkers.Add(Marker);
+	DueEvents.HeapPush({ Marker, Marker->GetPriority(), Now });
+}
+
+void UHorrorEventDirector::StartDueEvents(double Now)
+{
+	int32 NumStarted = 0;
+
+	while (DueEvents.Num() > 0 && NumStarted < MaxEventStartsPerFrame)
+	{
+		FDueEvent Due;
+		DueEvents.HeapPop(Due, EAllowShrinking::No);
+
+		AHorrorEventMarker* Marker = Due.Marker.Get();
+
+		// skip markers that were unregistered while waiting
+		if (!Marker || QueuedMarkers.Remove(Marker) == 0)
+		{
+			continue;
+		}
+
+		// a scare that starts long after its trigger would feel random, so drop it
+		const bool bLate = Now - Due.DueTime > MaxStartDelay;
+		const bool bOnCooldown = !Marker->CanStart(Now);
+
+		if (!bLate && !bOnCooldown)
+		{
+			Marker->StartEvent(this, Now);
+			++NumStarted;
+		}
+
+		// scheduled events repeat until they run out of starts, even if this start was dropped
+		if (Marker->GetTrigger() == EHorrorEventTrigger::Scheduled && Marker->HasStartsLeft())
+		{
+			// an event held back by its cooldown tries again once the cooldown is over
+			const float Delay = (bOnCooldown && !bLate) ? Marker->GetRemainingCooldown(Now) : FMath::Max(Marker->GetScheduleDelay(), Marker->GetRemainingCooldown(Now));
+
+			ScheduleEvent(Marker, Delay);
+		}
+	}
+}
+
+void UHorrorEventDirector::UpdateFlickers(double Now)
+{
+	for (int32 FlickerIndex = ActiveFlickers.Num() - 1; FlickerIndex >= 0; --FlickerIndex)
+	{
+		FActiveFlicker& Flicker = ActiveFlickers[FlickerIndex];
+
+		// done, put the lights no other flicker owns back the way they were
+		if (Now >= Flicker.EndTime)
+		{
+			for (const TWeakObjectPtr<ULightComponent>& LightPtr : Flicker.Lights)
+			{
+				FFlickerLight* FlickerLight = FlickerLights.Find(LightPtr);
+
+				if (!FlickerLight || --FlickerLight->NumFlickers > 0)
+				{
+					continue;
+				}
+
+				if (ULightComponent* Light = LightPtr.Get())
+				{
+					Light->SetVisibility(FlickerLight->bWasVisible);
+				}
+
+				FlickerLights.Remove(LightPtr);
+			}
+
+			ActiveFlickers.RemoveAtSwap(FlickerIndex, EAllowShrinking::No);
+			continue;
+		}
+
+		if (Now < Flicker.NextToggleTime)
+		{
+			continue;
+		}
+
+		// toggle at a jittered interval so it doesn't look mechanical
+		Flicker.bLightsOn = !Flicker.bLightsOn;
+		Flicker.NextToggleTime = Now + Flicker.Interval * FMath::FRandRange(0.5f, 1.5f);
+
+		for (const TWeakObjectPtr<ULightComponent>& LightPtr : Flicker.Lights)
+		{
+			ULightComponent* Light = LightPtr.Get();
+			const FFlickerLight* FlickerLight = FlickerLights.Find(LightPtr);
+
+			if (Light && FlickerLight)
+			{
+				Light->SetVisibility(Flicker.bLightsOn && FlickerLight->bWasVisible);
+			}
+		}
+	}
+}
@@ -0,0 +1,189 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HorrorEventDirector.generated.h"
+
+class AHorrorEventMarker;
+class APlayerController;
+class ULightComponent;
+class UNotebookComponent;
+
+/** What event conditions know about a local player */
+struct FHorrorPlayerSnapshot
+{
+	/** Player asking */
+	APlayerController* PlayerController = nullptr;
+
+	/** Pawn location */
+	FVector Location = FVector::ZeroVector;
+
+	/** Viewpoint location */
+	FVector ViewLocation = FVector::ZeroVector;
+
+	/** Viewpoint forward direction */
+	FVector ViewDirection = FVector::ForwardVector;
+
+	/** Notebook of the player pawn, if it has one */
+	const UNotebookComponent* Notebook = nullptr;
+};
+
+/**
+ *  Paces the horror events placed in the level
+ *  Scheduled events wait in a queue ordered by start time. Conditional events have their conditions
+ *  checked against the local players at a throttled rate, a few per update. Events that are due wait
+ *  in a priority queue, and only a few start each frame. Light flickers are run here as well,
+ *  so event markers never need to tick
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UHorrorEventDirector : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Time between condition updates */
+	UPROPERTY(Config, EditAnywhere, Category="Event Director", meta = (ClampMin = 0, Units = "s"))
+	float ConditionCheckInterval = 0.25f;
+
+	/** Max conditional events checked per condition update. The rest take turns */
+	UPROPERTY(Config, EditAnywhere, Category="Event Director", meta = (ClampMin = 1))
+	int32 MaxConditionChecksPerUpdate = 32;
+
+	/** Max events started per frame. Further due events wait for the next frames */
+	UPROPERTY(Config, EditAnywhere, Category="Event Director", meta = (ClampMin = 1))
+	int32 MaxEventStartsPerFrame = 2;
+
+	/** Due events that waited longer than this are dropped instead of starting late */
+	UPROPERTY(Config, EditAnywhere, Category="Event Director", meta = (ClampMin = 0, Units = "s"))
+	float MaxStartDelay = 2.0f;
+
+	/** An event waiting for its start time */
+	struct FScheduledEvent
+	{
+		TWeakObjectPtr<AHorrorEventMarker> Marker;
+		double StartTime;
+
+		bool operator<(const FScheduledEvent& Other) const { return StartTime < Other.StartTime; }
+	};
+
+	/** An event due to start */
+	struct FDueEvent
+	{
+		TWeakObjectPtr<AHorrorEventMarker> Marker;
+		int32 Priority;
+		double DueTime;
+
+		bool operator<(const FDueEvent& Other) const
+		{
+			// highest priority first, then oldest first
+			return Priority != Other.Priority ? Priority > Other.Priority : DueTime < Other.DueTime;
+		}
+	};
+
+	/** A light flicker in progress */
+	struct FActiveFlicker
+	{
+		TArray<TWeakObjectPtr<ULightComponent>> Lights;
+		double EndTime;
+		double NextToggleTime;
+		float Interval;
+		bool bLightsOn;
+	};
+
+	/** A light owned by one or more flickers */
+	struct FFlickerLight
+	{
+		/** Visibility from before the first flicker, restored when the last one ends */
+		bool bWasVisible;
+		int32 NumFlickers;
+	};
+
+	/** Heap of scheduled events, earliest first */
+	TArray<FScheduledEvent> ScheduledEvents;
+
+	/** Heap of due events, highest priority first */
+	TArray<FDueEvent> DueEvents;
+
+	/** Markers with conditions to check */
+	TArray<TWeakObjectPtr<AHorrorEventMarker>> ConditionalEvents;
+
+	/** Markers currently scheduled or due, so they aren't queued twice */
+	TSet<TObjectKey<AHorrorEventMarker>> QueuedMarkers;
+
+	/** Light flickers in progress */
+	TArray<FActiveFlicker> ActiveFlickers;
+
+	/** Lights in flickers in progress */
+	TMap<TWeakObjectPtr<ULightComponent>, FFlickerLight> FlickerLights;
+
+	/** Local players, refreshed on every condition update */
+	TArray<FHorrorPlayerSnapshot> PlayerSnapshots;
+
+	/** Conditional event the next condition update starts from */
+	int32 ConditionCursor = 0;
+
+	/** Time since the last condition update */
+	float TimeSinceConditionCheck = 0.0f;
+
+	/** Tick scheduler task running the event director update */
+	int32 TickTaskID = INDEX_NONE;
+
+public:
+
+	//~Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem Interface
+
+	/** Runs the event director update from the tick scheduler's normal lane */
+	void ScheduledTick(float DeltaTime);
+
+	/** Registers an event marker. Scheduled markers start counting down right away */
+	void RegisterEvent(AHorrorEventMarker* Marker);
+
+	/** Unregisters an event marker */
+	void UnregisterEvent(AHorrorEventMarker* Marker);
+
+	/**
+	 * Schedules an event to start after a delay, regardless of its conditions
+	 * @param Marker Event to start
+	 * @param Delay Time until the event is due, in seconds
+	 */
+	UFUNCTION(BlueprintCallable, Category="Event Director")
+	void ScheduleEvent(AHorrorEventMarker* Marker, float Delay);
+
+	/**
+	 * Flickers a set of lights on and off, then restores their visibility
+	 * @param Lights Lights to flicker
+	 * @param Duration How long the flicker lasts, in seconds
+	 * @param Interval Average time between toggles, in seconds
+	 */
+	void StartFlicker(const TArray<ULightComponent*>& Lights, float Duration, float Interval);
+
+	/** Returns the number of events currently scheduled or due */
+	int32 GetNumQueuedEvents() const { return QueuedMarkers.Num(); }
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem Interface
+
+	/** Checks a slice of the conditional events and queues the ones whose conditions are met */
+	void UpdateConditions(double Now);
+
+	/** Refreshes the local player snapshots */
+	void GatherPlayerSnapshots();
+
+	/** Adds an event to the due queue */
+	void QueueDueEvent(AHorrorEventMarker* Marker, double Now);
+
+	/** Starts the highest priority due events, up to the per frame cap */
+	void StartDueEvents(double Now);
+
+	/** Toggles and finishes light flickers */
+	void UpdateFlickers(double Now);
+};
@@ -0,0 +1,145 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/HorrorEventMarker.h"
+#include "HorrorEventDirector.h"
+#include "RoomFlipActor.h"
+#include "NotebookComponent.h"
+#include "Components/LightComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+
+AHorrorEventMarker::AHorrorEventMarker()
+{
+	// the event director does all the work
+	PrimaryActorTick.bCanEverTick = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+}
+
+void AHorrorEventMarker::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UHorrorEventDirector* Director = GetWorld()->GetSubsystem<UHorrorEventDirector>())
+	{
+		Director->RegisterEvent(this);
+	}
+}
+
+void AHorrorEventMarker::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UHorrorEventDirector* Director = GetWorld()->GetSubsystem<UHorrorEventDirector>())
+	{
+		Director->UnregisterEvent(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool AHorrorEventMarker::HasStartsLeft() const
+{
+	return MaxStarts <= 0 || NumStarts < MaxStarts;
+}
+
+bool AHorrorEventMarker::CanStart(double Now) const
+{
+	if (!HasStartsLeft())
+	{
+		return false;
+	}
+
+	// Never started counts as off cooldown
+	return LastStartTime < 0.0 || Now - LastStartTime >= Cooldown;
+}
+
+float AHorrorEventMarker::GetRemainingCooldown(double Now) const
+{
+	// Never started counts as off cooldown
+	return LastStartTime < 0.0 ? 0.0f : FMath::Max(0.0f, float(LastStartTime + Cooldown - Now));
+}
+
+bool AHorrorEventMarker::AreConditionsMet(const TArray<FHorrorPlayerSnapshot>& Players) const
+{
+	const FVector MarkerLocation = GetActorLocation();
+	const float RadiusSquared = FMath::Square(TriggerRadius);
+	const float CosViewAngle = FMath::Cos(FMath::DegreesToRadians(ViewAngle));
+
+	for (const FHorrorPlayerSnapshot& Player : Players)
+	{
+		// Distance first, it's the cheapest
+		if (TriggerRadius > 0.0f && FVector::DistSquared(Player.Location, MarkerLocation) > RadiusSquared)
+		{
+			continue;
+		}
+
+		if (ViewRequirement != EHorrorEventView::Any)
+		{
+			const FVector ToMarker = (MarkerLocation - Player.ViewLocation).GetSafeNormal();
+			const bool bInView = FVector::DotProduct(ToMarker, Player.ViewDirection) >= CosViewAngle;
+
+			if (bInView != (ViewRequirement == EHorrorEventView::InView))
+			{
+				continue;
+			}
+		}
+
+		if (!RequiredObjective.IsNone() && (!Player.Notebook || !Player.Notebook->IsObjectiveUnlocked(RequiredObjective)))
+		{
+			continue;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+void AHorrorEventMarker::StartEvent(UHorrorEventDirector* Director, double Now)
+{
+	++NumStarts;
+	LastStartTime = Now;
+
+	switch (Action)
+	{
+	case EHorrorEventAction::FlickerLights:
+		{
+			TArray<ULightComponent*> Lights;
+
+			for (AActor* LightActor : FlickerLightActors)
+			{
+				if (LightActor)
+				{
+					TArray<ULightComponent*> ActorLights;
+					LightActor->GetComponents(ActorLights);
+					Lights.Append(ActorLights);
+				}
+			}
+
+			Director->StartFlicker(Lights, FlickerDuration, FlickerInterval);
+		}
+		break;
+
+	case EHorrorEventAction::FlipRoom:
+		if (RoomToFlip)
+		{
+			RoomToFlip->TriggerFlip();
+		}
+		break;
+
+	case EHorrorEventAction::PlaySound:
+		if (Sound)
+		{
+			UGameplayStatics::PlaySoundAtLocation(this, Sound, GetActorLocation());
+		}
+		break;
+
+	case EHorrorEventAction::Custom:
+		break;
+	}
+
+	// Call Blueprint event
+	BP_OnEventStarted();
+
+	UE_LOG(LogTemp, Verbose, TEXT("HorrorEventMarker: %s started (#%d)"), *GetName(), NumStarts);
+}
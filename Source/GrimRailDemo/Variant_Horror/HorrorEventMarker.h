@@ -0,0 +1,185 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "HorrorEventMarker.generated.h"
+
+class ARoomFlipActor;
+class USoundBase;
+class UHorrorEventDirector;
+struct FHorrorPlayerSnapshot;
+
+/** What a horror event does when it starts */
+UENUM(BlueprintType)
+enum class EHorrorEventAction : uint8
+{
+	FlickerLights	UMETA(DisplayName = "Flicker Lights"),
+	FlipRoom		UMETA(DisplayName = "Flip Room"),
+	PlaySound		UMETA(DisplayName = "Play Sound"),
+	Custom			UMETA(DisplayName = "Custom (Blueprint only)")
+};
+
+/** How a horror event gets started */
+UENUM(BlueprintType)
+enum class EHorrorEventTrigger : uint8
+{
+	Scheduled		UMETA(DisplayName = "Scheduled"),
+	Conditional		UMETA(DisplayName = "Conditional"),
+	Manual			UMETA(DisplayName = "Manual")
+};
+
+/** Where the player has to be looking for a conditional event to start */
+UENUM(BlueprintType)
+enum class EHorrorEventView : uint8
+{
+	Any				UMETA(DisplayName = "Any"),
+	InView			UMETA(DisplayName = "In View"),
+	OutOfView		UMETA(DisplayName = "Out Of View")
+};
+
+/**
+ * Places a scare in the level
+ * Doesn't tick. The horror event director checks its conditions and starts it
+ */
+UCLASS()
+class GRIMRAILDEMO_API AHorrorEventMarker : public AActor
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** What the event does */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event")
+	EHorrorEventAction Action = EHorrorEventAction::FlickerLights;
+
+	/** How the event gets started */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event")
+	EHorrorEventTrigger Trigger = EHorrorEventTrigger::Conditional;
+
+	/** Events with a higher priority start first when several are due at once */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event")
+	int32 Priority = 0;
+
+	/** How many times the event can start. Zero means no limit */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event", meta = (ClampMin = 0))
+	int32 MaxStarts = 1;
+
+	/** Minimum time between two starts */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event", meta = (ClampMin = 0, Units = "s"))
+	float Cooldown = 10.0f;
+
+	/** Time from level start to the first start of a scheduled event, and between starts after that */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event|Schedule", meta = (ClampMin = 0, Units = "s", EditCondition = "Trigger == EHorrorEventTrigger::Scheduled"))
+	float ScheduleDelay = 30.0f;
+
+	/** A player has to be within this distance of the marker. Zero means anywhere */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event|Conditions", meta = (ClampMin = 0, Units = "cm", EditCondition = "Trigger == EHorrorEventTrigger::Conditional"))
+	float TriggerRadius = 800.0f;
+
+	/** Where the player has to be looking */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event|Conditions", meta = (EditCondition = "Trigger == EHorrorEventTrigger::Conditional"))
+	EHorrorEventView ViewRequirement = EHorrorEventView::Any;
+
+	/** Half angle of the player's view used by the view requirement */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event|Conditions", meta = (ClampMin = 0, ClampMax = 180, Units = "Degrees", EditCondition = "Trigger == EHorrorEventTrigger::Conditional"))
+	float ViewAngle = 50.0f;
+
+	/** Notebook objective the player has to have unlocked. None means no requirement */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event|Conditions", meta = (EditCondition = "Trigger == EHorrorEventTrigger::Conditional"))
+	FName RequiredObjective;
+
+	/** Actors whose lights flicker */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event|Flicker")
+	TArray<TObjectPtr<AActor>> FlickerLightActors;
+
+	/** How long the lights flicker */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event|Flicker", meta = (ClampMin = 0, Units = "s"))
+	float FlickerDuration = 1.5f;
+
+	/** Average time between flicker toggles */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event|Flicker", meta = (ClampMin = 0.01, Units = "s"))
+	float FlickerInterval = 0.08f;
+
+	/** Room to flip */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event|Room Flip")
+	TObjectPtr<ARoomFlipActor> RoomToFlip;
+
+	/** Sound played at the marker */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Horror Event|Sound")
+	TObjectPtr<USoundBase> Sound;
+
+	/** Number of times the event started */
+	int32 NumStarts = 0;
+
+	/** World time of the last start */
+	double LastStartTime = -1.0;
+
+public:
+
+	/** Constructor */
+	AHorrorEventMarker();
+
+protected:
+
+	/** Registers with the event director */
+	virtual void BeginPlay() override;
+
+	/** Unregisters from the event director */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+
+	/** Returns how the event gets started */
+	EHorrorEventTrigger GetTrigger() const { return Trigger; }
+
+	/** Returns the event priority */
+	int32 GetPriority() const { return Priority; }
+
+	/** Returns the delay used by scheduled events */
+	float GetScheduleDelay() const { return ScheduleDelay; }
+
+	/**
+	 * Checks whether the event can start again at all, ignoring the cooldown
+	 * @return False once the event used up its starts
+	 */
+	bool HasStartsLeft() const;
+
+	/**
+	 * Checks whether the event is off cooldown and has starts left
+	 * @param Now Current world time
+	 * @return True if the event may start
+	 */
+	bool CanStart(double Now) const;
+
+	/**
+	 * Returns the time left until the event is off cooldown
+	 * @param Now Current world time
+	 * @return Remaining cooldown in seconds, zero if the event is off cooldown
+	 */
+	float GetRemainingCooldown(double Now) const;
+
+	/**
+	 * Checks the event conditions against the local players
+	 * @param Players Local player snapshots
+	 * @return True if any player meets every condition
+	 */
+	bool AreConditionsMet(const TArray<FHorrorPlayerSnapshot>& Players) const;
+
+	/**
+	 * Runs the event action. Called by the event director
+	 * @param Director Director starting the event, used for light flickers
+	 * @param Now Current world time
+	 */
+	void StartEvent(UHorrorEventDirector* Director, double Now);
+
+protected:
+
+	/**
+	 * Called when the event starts
+	 * Override in Blueprint for custom effects, or to implement custom actions
+	 */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Horror Event", meta = (DisplayName = "On Event Started"))
+	void BP_OnEventStarted();
+};
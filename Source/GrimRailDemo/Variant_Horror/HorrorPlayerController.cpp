@@ -8,6 +8,9 @@
 #include "GrimRailDemoCameraManager.h"
 #include "HorrorCharacter.h"
 #include "HorrorUI.h"
+#include "NotebookWidget.h"
+#include "TimerManager.h"
+#include "GrimRailHUDModel.h"
 #include "GrimRailDemo.h"
 #include "Widgets/Input/SVirtualJoystick.h"
 
@@ -51,27 +54,37 @@ void AHorrorPlayerController::OnPossess(APawn* aPawn)
 		// set up the UI for the character
 		if (AHorrorCharacter* HorrorCharacter = Cast<AHorrorCharacter>(aPawn))
 		{
+			// create the HUD model
+			if (!HUDModel)
+			{
+				HUDModel = NewObject<UGrimRailHUDModel>(this);
+			}
+
 			// create the UI
 			if (!HorrorUI)
 			{
 				HorrorUI = CreateWidget<UHorrorUI>(this, HorrorUIClass);
-				HorrorUI->AddToViewport(0);
+				HorrorUI->AddToPlayerScreen(0);
+				HorrorUI->SetupHUDModel(HUDModel);
 			}
 
 			HorrorUI->SetupCharacter(HorrorCharacter);
 
-			// create the notebook UI
-			if (NotebookWidgetClass && !NotebookWidget)
+			// route the character's sprint updates through the HUD model
+			HorrorCharacter->OnSprintMeterUpdated.AddUniqueDynamic(HUDModel.Get(), &UGrimRailHUDModel::SetSprintPercent);
+			HorrorCharacter->OnSprintStateChanged.AddUniqueDynamic(HUDModel.Get(), &UGrimRailHUDModel::SetSprinting);
+			HUDModel->MarkAllDirty();
+
+			// the notebook widget is only created the first time it's opened
+			if (NotebookWidgetClass)
 			{
-				NotebookWidget = CreateWidget<UUserWidget>(this, NotebookWidgetClass);
-				if (NotebookWidget)
-				{
-					NotebookWidget->AddToViewport(10); // Higher Z-order than HUD
-					NotebookWidget->SetVisibility(ESlateVisibility::Hidden);
+				HorrorCharacter->OnNotebookToggled.AddUniqueDynamic(this, &AHorrorPlayerController::OnNotebookToggled);
+			}
 
-					// Bind to notebook toggle delegate
-					HorrorCharacter->OnNotebookToggled.AddDynamic(this, &AHorrorPlayerController::OnNotebookToggled);
-				}
+			// point an existing notebook widget at the new character's notebook
+			if (UNotebookWidget* Notebook = Cast<UNotebookWidget>(NotebookWidget))
+			{
+				Notebook->SetupNotebook(HorrorCharacter->GetNotebookComponent());
 			}
 		}
 	}
@@ -107,12 +120,37 @@ void AHorrorPlayerController::SetupInputComponent()
 
 void AHorrorPlayerController::OnNotebookToggled(bool bIsOpen)
 {
+	// Create the notebook UI on first open, so it doesn't cost anything at startup
+	if (bIsOpen && !NotebookWidget && NotebookWidgetClass)
+	{
+		NotebookWidget = CreateWidget<UUserWidget>(this, NotebookWidgetClass);
+		if (NotebookWidget)
+		{
+			NotebookWidget->AddToPlayerScreen(10); // Higher Z-order than HUD, in this player's splitscreen area
+
+			if (UNotebookWidget* Notebook = Cast<UNotebookWidget>(NotebookWidget))
+			{
+				const AHorrorCharacter* HorrorCharacter = Cast<AHorrorCharacter>(GetPawn());
+				Notebook->SetupNotebook(HorrorCharacter ? HorrorCharacter->GetNotebookComponent() : nullptr);
+			}
+		}
+	}
+
 	if (NotebookWidget)
 	{
 		if (bIsOpen)
 		{
+			// Keep the notebook UI while it's in use
+			GetWorldTimerManager().ClearTimer(NotebookReleaseTimer);
+
 			NotebookWidget->SetVisibility(ESlateVisibility::Visible);
 
+			// Catch up on entries found while it was closed
+			if (UNotebookWidget* Notebook = Cast<UNotebookWidget>(NotebookWidget))
+			{
+				Notebook->RefreshIfDirty();
+			}
+
 			// Show mouse cursor and enable UI mode
 			SetShowMouseCursor(true);
 			SetInputMode(FInputModeGameAndUI());
@@ -121,6 +159,12 @@ void AHorrorPlayerController::OnNotebookToggled(bool bIsOpen)
 		{
 			NotebookWidget->SetVisibility(ESlateVisibility::Hidden);
 
+			// Release the notebook UI if it stays closed for a while
+			if (NotebookReleaseDelay > 0.0f)
+			{
+				GetWorldTimerManager().SetTimer(NotebookReleaseTimer, this, &AHorrorPlayerController::ReleaseNotebookWidget, NotebookReleaseDelay, false);
+			}
+
 			// Hide mouse cursor and return to game mode
 			SetShowMouseCursor(false);
 			SetInputMode(FInputModeGameOnly());
@@ -129,3 +173,17 @@ void AHorrorPlayerController::OnNotebookToggled(bool bIsOpen)
 		UE_LOG(LogTemp, Log, TEXT("HorrorPlayerController: Notebook toggled %s"), bIsOpen ? TEXT("open") : TEXT("closed"));
 	}
 }
+
+void AHorrorPlayerController::ReleaseNotebookWidget()
+{
+	if (!NotebookWidget)
+	{
+		return;
+	}
+
+	// Drop the widget tree, it's rebuilt on the next open
+	NotebookWidget->RemoveFromParent();
+	NotebookWidget = nullptr;
+
+	UE_LOG(LogTemp, Verbose, TEXT("HorrorPlayerController: Released idle notebook widget"));
+}
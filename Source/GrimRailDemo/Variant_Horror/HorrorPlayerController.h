@@ -8,6 +8,7 @@
 
 class UInputMappingContext;
 class UHorrorUI;
+class UGrimRailHUDModel;
 
 /**
  *  Player Controller for a first person horror game
@@ -28,13 +29,24 @@ protected:
 	/** Pointer to the UI widget */
 	TObjectPtr<UHorrorUI> HorrorUI;
 
+	/** Coalesces character HUD updates before they reach the UI */
+	UPROPERTY(Transient)
+	TObjectPtr<UGrimRailHUDModel> HUDModel;
+
 	/** Type of notebook widget to spawn */
 	UPROPERTY(EditAnywhere, Category="Horror|UI")
 	TSubclassOf<UUserWidget> NotebookWidgetClass;
 
-	/** Pointer to the notebook widget */
+	/** Pointer to the notebook widget, created the first time the notebook is opened */
 	TObjectPtr<UUserWidget> NotebookWidget;
 
+	/** Time the notebook has to stay closed before its widget is released. Zero keeps it around */
+	UPROPERTY(EditAnywhere, Category="Horror|UI", meta = (ClampMin = 0, Units = "s"))
+	float NotebookReleaseDelay = 30.0f;
+
+	/** Releases the notebook widget once it has been closed long enough */
+	FTimerHandle NotebookReleaseTimer;
+
 public:
 
 	/** Constructor */
@@ -70,4 +82,7 @@ protected:
 	UFUNCTION()
 	void OnNotebookToggled(bool bIsOpen);
 
+	/** Removes the notebook widget so its widget tree can be garbage collected */
+	void ReleaseNotebookWidget();
+
 };
@@ -0,0 +1,52 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/LightExposureComponent.h"
+#include "Engine/World.h"
+#include "LightExposureSubsystem.h"
+
+ULightExposureComponent::ULightExposureComponent()
+{
+	// exposure is pushed by the subsystem, so this never needs to tick
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void ULightExposureComponent::SetExposure(float NewExposure)
+{
+	Exposure = NewExposure;
+
+	// only broadcast changes large enough to matter, and always when the exposure reaches zero
+	if (FMath::Abs(Exposure - BroadcastExposure) >= ExposureTolerance || (Exposure == 0.0f && BroadcastExposure != 0.0f))
+	{
+		BroadcastExposure = Exposure;
+		OnExposureChanged.Broadcast(Exposure);
+	}
+
+	const bool bNewLit = Exposure > LitThreshold;
+
+	if (bNewLit != bLit)
+	{
+		bLit = bNewLit;
+		OnLitStateChanged.Broadcast(bLit);
+	}
+}
+
+void ULightExposureComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (ULightExposureSubsystem* LightExposure = GetWorld()->GetSubsystem<ULightExposureSubsystem>())
+	{
+		LightExposure->RegisterReceiver(this);
+	}
+}
+
+void ULightExposureComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (ULightExposureSubsystem* LightExposure = GetWorld()->GetSubsystem<ULightExposureSubsystem>())
+	{
+		LightExposure->UnregisterReceiver(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "LightExposureComponent.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLightExposureChangedDelegate, float, Exposure);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLitStateChangedDelegate, bool, bLit);
+
+/**
+ *  Marks a point on an actor that reacts to the player's flashlight
+ *  Exposure is computed by the light exposure subsystem and pushed here every few frames
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class GRIMRAILDEMO_API ULightExposureComponent : public USceneComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Exposure above which the owner counts as lit */
+	UPROPERTY(EditAnywhere, Category="Light Exposure", meta = (ClampMin = 0, ClampMax = 1))
+	float LitThreshold = 0.2f;
+
+	/** Smallest exposure change that is broadcast */
+	UPROPERTY(EditAnywhere, Category="Light Exposure", meta = (ClampMin = 0, ClampMax = 1))
+	float ExposureTolerance = 0.05f;
+
+	/** Current exposure, from 0 (dark) to 1 (center of the beam, up close) */
+	float Exposure = 0.0f;
+
+	/** Exposure last broadcast to listeners */
+	float BroadcastExposure = 0.0f;
+
+	/** True while exposure is above the lit threshold */
+	bool bLit = false;
+
+public:
+
+	/** Called when the exposure changes by more than the tolerance */
+	UPROPERTY(BlueprintAssignable, Category="Light Exposure")
+	FLightExposureChangedDelegate OnExposureChanged;
+
+	/** Called when the owner becomes lit or unlit */
+	UPROPERTY(BlueprintAssignable, Category="Light Exposure")
+	FLitStateChangedDelegate OnLitStateChanged;
+
+public:
+
+	/** Constructor */
+	ULightExposureComponent();
+
+	/** Returns the current exposure */
+	UFUNCTION(BlueprintPure, Category="Light Exposure")
+	float GetExposure() const { return Exposure; }
+
+	/** Returns true if the owner is lit */
+	UFUNCTION(BlueprintPure, Category="Light Exposure")
+	bool IsLit() const { return bLit; }
+
+	/** Updates the exposure and notifies listeners of meaningful changes. Called by the light exposure subsystem */
+	void SetExposure(float NewExposure);
+
+protected:
+
+	/** Registers with the light exposure subsystem */
+	virtual void BeginPlay() override;
+
+	/** Unregisters from the light exposure subsystem */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
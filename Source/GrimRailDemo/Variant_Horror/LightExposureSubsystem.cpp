@@ -0,0 +1,334 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/LightExposureSubsystem.h"
+#include "GrimRailTickScheduler.h"
+#include "LightExposureComponent.h"
+#include "Components/SpotLightComponent.h"
+#include "Engine/World.h"
+#include "Math/VectorRegister.h"
+
+void ULightExposureSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	OcclusionTraceDelegate.BindUObject(this, &ULightExposureSubsystem::OnOcclusionTraceDone);
+
+	// run as a tick scheduler job instead of ticking on our own
+	if (UGrimRailTickScheduler* Scheduler = Collection.InitializeDependency<UGrimRailTickScheduler>())
+	{
+		JobID = Scheduler->RegisterJob(TEXT("LightExposure"), this, this, EGrimRailJobData::None, EGrimRailJobData::LightExposure);
+	}
+}
+
+void ULightExposureSubsystem::Deinitialize()
+{
+	if (UGrimRailTickScheduler* Scheduler = GetWorld()->GetSubsystem<UGrimRailTickScheduler>())
+	{
+		Scheduler->UnregisterJob(JobID);
+	}
+
+	JobID = INDEX_NONE;
+
+	Super::Deinitialize();
+}
+
+bool ULightExposureSubsystem::GatherJob(float DeltaTime)
+{
+	// nothing to light
+	if (Receivers.Num() == 0)
+	{
+		FramesSinceUpdate = 0;
+		return false;
+	}
+
+	// throttle the update
+	if (++FramesSinceUpdate < UpdateFrameInterval)
+	{
+		return false;
+	}
+
+	FramesSinceUpdate = 0;
+
+	// drop lights that were destroyed without unregistering
+	Lights.RemoveAllSwap([](const TWeakObjectPtr<USpotLightComponent>& Light)
+	{
+		return !Light.IsValid();
+	});
+
+	// copy the lights that are switched on
+	LightSnapshots.Reset();
+
+	for (const TWeakObjectPtr<USpotLightComponent>& LightPtr : Lights)
+	{
+		const USpotLightComponent* Light = LightPtr.Get();
+
+		if (!Light->IsVisible() || Light->Intensity <= 0.0f || Light->AttenuationRadius <= 0.0f)
+		{
+			continue;
+		}
+
+		// same clamping the spot light uses for rendering
+		const float OuterConeAngle = FMath::Clamp(Light->OuterConeAngle, 1.0f, 89.0f);
+		const float InnerConeAngle = FMath::Clamp(Light->InnerConeAngle, 0.0f, OuterConeAngle - 0.001f);
+
+		FLightSnapshot& Snapshot = LightSnapshots.AddDefaulted_GetRef();
+		Snapshot.Light = LightPtr;
+		Snapshot.Location = Light->GetComponentLocation();
+		Snapshot.Direction = Light->GetForwardVector();
+		Snapshot.CosOuter = FMath::Cos(FMath::DegreesToRadians(OuterConeAngle));
+		Snapshot.CosInner = FMath::Cos(FMath::DegreesToRadians(InnerConeAngle));
+		Snapshot.InvRadius = 1.0f / Light->AttenuationRadius;
+	}
+
+	NumJobReceivers = Receivers.Num();
+	const int32 NumPadded = Align(NumJobReceivers, 4);
+
+	// pack the receiver positions. Padding lanes are computed but never read
+	PositionsX.SetNumUninitialized(NumPadded, EAllowShrinking::No);
+	PositionsY.SetNumUninitialized(NumPadded, EAllowShrinking::No);
+	PositionsZ.SetNumUninitialized(NumPadded, EAllowShrinking::No);
+	LightExposures.SetNumUninitialized(NumPadded, EAllowShrinking::No);
+	JobExposures.SetNumUninitialized(NumJobReceivers, EAllowShrinking::No);
+	JobBestLights.SetNumUninitialized(NumJobReceivers, EAllowShrinking::No);
+	JobSerials = ReceiverSerials;
+
+	for (int32 Index = 0; Index < NumPadded; ++Index)
+	{
+		const ULightExposureComponent* Receiver = Index < NumJobReceivers ? Receivers[Index].Get() : nullptr;
+		const FVector Location = Receiver ? Receiver->GetComponentLocation() : FVector::ZeroVector;
+
+		PositionsX[Index] = Location.X;
+		PositionsY[Index] = Location.Y;
+		PositionsZ[Index] = Location.Z;
+	}
+
+	return true;
+}
+
+void ULightExposureSubsystem::PrepareJob()
+{
+	// keep the unoccluded exposure of the brightest light per receiver
+	for (int32 Index = 0; Index < NumJobReceivers; ++Index)
+	{
+		JobExposures[Index] = 0.0f;
+		JobBestLights[Index] = INDEX_NONE;
+	}
+
+	for (int32 LightIndex = 0; LightIndex < LightSnapshots.Num(); ++LightIndex)
+	{
+		ComputeLightExposure(LightSnapshots[LightIndex], NumJobReceivers);
+
+		for (int32 Index = 0; Index < NumJobReceivers; ++Index)
+		{
+			if (LightExposures[Index] > JobExposures[Index])
+			{
+				JobExposures[Index] = LightExposures[Index];
+				JobBestLights[Index] = LightIndex;
+			}
+		}
+	}
+}
+
+void ULightExposureSubsystem::CommitJob()
+{
+	// receivers may have come and gone since the gather, match the results up by serial
+	for (int32 JobIndex = 0; JobIndex < NumJobReceivers; ++JobIndex)
+	{
+		const int32* Index = ReceiverIndexBySerial.Find(JobSerials[JobIndex]);
+
+		if (!Index)
+		{
+			continue;
+		}
+
+		// receivers that just entered a cone stay dark until a trace confirms they can be seen
+		if (JobExposures[JobIndex] > 0.0f && Exposures[*Index] <= 0.0f)
+		{
+			Occluded[*Index] = true;
+		}
+
+		Exposures[*Index] = JobExposures[JobIndex];
+		BestLights[*Index] = JobBestLights[JobIndex];
+	}
+
+	const int32 NumReceivers = Receivers.Num();
+
+	StartOcclusionTraces(NumReceivers);
+
+	// publish. Receivers may react by unregistering, so work off a copy
+	const TArray<TWeakObjectPtr<ULightExposureComponent>> ReceiversCopy = Receivers;
+	const TArray<float> ExposuresCopy = Exposures;
+	const TArray<bool> OccludedCopy = Occluded;
+
+	for (int32 Index = 0; Index < NumReceivers; ++Index)
+	{
+		if (ULightExposureComponent* Receiver = ReceiversCopy[Index].Get())
+		{
+			Receiver->SetExposure(OccludedCopy[Index] ? 0.0f : ExposuresCopy[Index]);
+		}
+	}
+}
+
+bool ULightExposureSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void ULightExposureSubsystem::RegisterLight(USpotLightComponent* Light)
+{
+	if (Light)
+	{
+		Lights.AddUnique(Light);
+	}
+}
+
+void ULightExposureSubsystem::UnregisterLight(USpotLightComponent* Light)
+{
+	Lights.RemoveSwap(Light);
+}
+
+void ULightExposureSubsystem::RegisterReceiver(ULightExposureComponent* Receiver)
+{
+	if (!Receiver || Receivers.Contains(Receiver))
+	{
+		return;
+	}
+
+	const uint32 Serial = NextSerial++;
+
+	Receivers.Add(Receiver);
+	ReceiverSerials.Add(Serial);
+	Exposures.Add(0.0f);
+	BestLights.Add(INDEX_NONE);
+	Occluded.Add(true);
+
+	ReceiverIndexBySerial.Add(Serial, Receivers.Num() - 1);
+}
+
+void ULightExposureSubsystem::UnregisterReceiver(ULightExposureComponent* Receiver)
+{
+	const int32 Index = Receivers.IndexOfByKey(Receiver);
+
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	// pending traces for this receiver won't find its serial anymore
+	ReceiverIndexBySerial.Remove(ReceiverSerials[Index]);
+
+	// swap the last receiver into the hole and fix up its index
+	Receivers.RemoveAtSwap(Index, EAllowShrinking::No);
+	ReceiverSerials.RemoveAtSwap(Index, EAllowShrinking::No);
+	Exposures.RemoveAtSwap(Index, EAllowShrinking::No);
+	BestLights.RemoveAtSwap(Index, EAllowShrinking::No);
+	Occluded.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	if (ReceiverSerials.IsValidIndex(Index))
+	{
+		ReceiverIndexBySerial.Add(ReceiverSerials[Index], Index);
+	}
+}
+
+void ULightExposureSubsystem::ComputeLightExposure(const FLightSnapshot& Light, int32 NumReceivers)
+{
+	const VectorRegister4Float LightX = VectorSetFloat1(Light.Location.X);
+	const VectorRegister4Float LightY = VectorSetFloat1(Light.Location.Y);
+	const VectorRegister4Float LightZ = VectorSetFloat1(Light.Location.Z);
+	const VectorRegister4Float DirX = VectorSetFloat1(Light.Direction.X);
+	const VectorRegister4Float DirY = VectorSetFloat1(Light.Direction.Y);
+	const VectorRegister4Float DirZ = VectorSetFloat1(Light.Direction.Z);
+	const VectorRegister4Float CosOuterV = VectorSetFloat1(Light.CosOuter);
+	const VectorRegister4Float InvConeRange = VectorSetFloat1(1.0f / FMath::Max(Light.CosInner - Light.CosOuter, KINDA_SMALL_NUMBER));
+	const VectorRegister4Float InvRadius = VectorSetFloat1(Light.InvRadius);
+	const VectorRegister4Float MinDistanceSquared = VectorSetFloat1(KINDA_SMALL_NUMBER);
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float One = VectorOneFloat();
+
+	// four receivers at a time
+	for (int32 Index = 0; Index < NumReceivers; Index += 4)
+	{
+		const VectorRegister4Float DeltaX = VectorSubtract(VectorLoad(&PositionsX[Index]), LightX);
+		const VectorRegister4Float DeltaY = VectorSubtract(VectorLoad(&PositionsY[Index]), LightY);
+		const VectorRegister4Float DeltaZ = VectorSubtract(VectorLoad(&PositionsZ[Index]), LightZ);
+
+		VectorRegister4Float DistanceSquared = VectorMultiply(DeltaX, DeltaX);
+		DistanceSquared = VectorMultiplyAdd(DeltaY, DeltaY, DistanceSquared);
+		DistanceSquared = VectorMultiplyAdd(DeltaZ, DeltaZ, DistanceSquared);
+		DistanceSquared = VectorMax(DistanceSquared, MinDistanceSquared);
+
+		const VectorRegister4Float InvDistance = VectorReciprocalSqrt(DistanceSquared);
+		const VectorRegister4Float Distance = VectorMultiply(DistanceSquared, InvDistance);
+
+		// cosine of the angle to the light axis, faded from the outer to the inner cone
+		VectorRegister4Float CosAngle = VectorMultiply(DeltaX, DirX);
+		CosAngle = VectorMultiplyAdd(DeltaY, DirY, CosAngle);
+		CosAngle = VectorMultiplyAdd(DeltaZ, DirZ, CosAngle);
+		CosAngle = VectorMultiply(CosAngle, InvDistance);
+
+		VectorRegister4Float Cone = VectorMultiply(VectorSubtract(CosAngle, CosOuterV), InvConeRange);
+		Cone = VectorMin(VectorMax(Cone, Zero), One);
+
+		// squared falloff to zero at the attenuation radius
+		VectorRegister4Float Attenuation = VectorSubtract(One, VectorMultiply(Distance, InvRadius));
+		Attenuation = VectorMin(VectorMax(Attenuation, Zero), One);
+		Attenuation = VectorMultiply(Attenuation, Attenuation);
+
+		VectorStore(VectorMultiply(Cone, Attenuation), &LightExposures[Index]);
+	}
+}
+
+void ULightExposureSubsystem::StartOcclusionTraces(int32 NumReceivers)
+{
+	if (NumReceivers == 0 || MaxOcclusionTracesPerUpdate <= 0)
+	{
+		return;
+	}
+
+	int32 NumTraces = 0;
+
+	// walk the receivers once starting at the cursor, so every lit receiver gets its turn
+	for (int32 Step = 0; Step < NumReceivers && NumTraces < MaxOcclusionTracesPerUpdate; ++Step)
+	{
+		const int32 Index = (OcclusionCursor + Step) % NumReceivers;
+
+		const ULightExposureComponent* Receiver = Receivers[Index].Get();
+		const USpotLightComponent* Light = BestLights[Index] != INDEX_NONE ? LightSnapshots[BestLights[Index]].Light.Get() : nullptr;
+
+		if (!Receiver || !Light || Exposures[Index] <= 0.0f)
+		{
+			continue;
+		}
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(LightExposureOcclusion));
+		QueryParams.AddIgnoredActor(Light->GetOwner());
+		QueryParams.AddIgnoredActor(Receiver->GetOwner());
+
+		GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Light->GetComponentLocation(), Receiver->GetComponentLocation(), ECC_Visibility,
+			QueryParams, FCollisionResponseParams::DefaultResponseParam, &OcclusionTraceDelegate, ReceiverSerials[Index]);
+
+		++NumTraces;
+		OcclusionCursor = (Index + 1) % NumReceivers;
+	}
+}
+
+void ULightExposureSubsystem::OnOcclusionTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	// the receiver may have unregistered while the trace was in flight
+	const int32* Index = ReceiverIndexBySerial.Find(TraceDatum.UserData);
+
+	if (!Index)
+	{
+		return;
+	}
+
+	bool bBlocked = false;
+
+	for (const FHitResult& Hit : TraceDatum.OutHits)
+	{
+		bBlocked |= Hit.bBlockingHit;
+	}
+
+	Occluded[*Index] = bBlocked;
+}
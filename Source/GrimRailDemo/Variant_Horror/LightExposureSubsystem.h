@@ -0,0 +1,140 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "GrimRailTickScheduler.h"
+#include "LightExposureSubsystem.generated.h"
+
+class USpotLightComponent;
+class ULightExposureComponent;
+
+/**
+ *  Computes how strongly registered receivers are lit by registered spot lights, e.g. the horror flashlight
+ *  Cone and range tests run in SIMD over packed receiver positions, as a tick scheduler job on a worker thread.
+ *  Receivers inside a cone get an async occlusion trace, a few per update, and results are pushed to the
+ *  receivers every few frames
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API ULightExposureSubsystem : public UWorldSubsystem, public IGrimRailJob
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Frames between exposure updates */
+	UPROPERTY(Config, EditAnywhere, Category="Light Exposure", meta = (ClampMin = 1))
+	int32 UpdateFrameInterval = 3;
+
+	/** Max occlusion traces started per update. Lit receivers take turns */
+	UPROPERTY(Config, EditAnywhere, Category="Light Exposure", meta = (ClampMin = 0))
+	int32 MaxOcclusionTracesPerUpdate = 16;
+
+	/** Registered lights */
+	TArray<TWeakObjectPtr<USpotLightComponent>> Lights;
+
+	/** Registered receivers */
+	TArray<TWeakObjectPtr<ULightExposureComponent>> Receivers;
+
+	/** Unique serial per receiver, used to match async trace results after receivers were removed */
+	TArray<uint32> ReceiverSerials;
+
+	/** A switched on light, copied out for the job */
+	struct FLightSnapshot
+	{
+		TWeakObjectPtr<USpotLightComponent> Light;
+		FVector Location;
+		FVector Direction;
+		float CosOuter = 0.0f;
+		float CosInner = 0.0f;
+		float InvRadius = 0.0f;
+	};
+
+	/** Lights the last update was computed from */
+	TArray<FLightSnapshot> LightSnapshots;
+
+	/** Receiver positions copied out for the job, one array per axis and padded to a multiple of 4 for SIMD */
+	TArray<float> PositionsX;
+	TArray<float> PositionsY;
+	TArray<float> PositionsZ;
+
+	/** Serial of each receiver copied out for the job */
+	TArray<uint32> JobSerials;
+
+	/** Job results: unoccluded exposure per copied receiver from the best light, and that light's snapshot index */
+	TArray<float> JobExposures;
+	TArray<int32> JobBestLights;
+
+	/** Exposure from the light being processed, scratch for the SIMD pass */
+	TArray<float> LightExposures;
+
+	/** Number of receivers copied out for the job */
+	int32 NumJobReceivers = 0;
+
+	/** Unoccluded exposure per receiver from the best light, and that light's snapshot index */
+	TArray<float> Exposures;
+	TArray<int32> BestLights;
+
+	/** True if the receiver's last occlusion trace was blocked, or it just entered a cone and wasn't traced yet */
+	TArray<bool> Occluded;
+
+	/** Receiver index by serial */
+	TMap<uint32, int32> ReceiverIndexBySerial;
+
+	/** Next receiver serial */
+	uint32 NextSerial = 1;
+
+	/** Receiver the occlusion traces continue from next update */
+	int32 OcclusionCursor = 0;
+
+	/** Frames since the last update */
+	int32 FramesSinceUpdate = 0;
+
+	/** Delegate for async occlusion trace results */
+	FTraceDelegate OcclusionTraceDelegate;
+
+	/** Tick scheduler job running the exposure update */
+	int32 JobID = INDEX_NONE;
+
+public:
+
+	//~Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem Interface
+
+	//~Begin IGrimRailJob Interface
+	virtual bool GatherJob(float DeltaTime) override;
+	virtual void PrepareJob() override;
+	virtual void CommitJob() override;
+	//~End IGrimRailJob Interface
+
+	/** Registers a spot light that lights up receivers */
+	void RegisterLight(USpotLightComponent* Light);
+
+	/** Unregisters a spot light */
+	void UnregisterLight(USpotLightComponent* Light);
+
+	/** Registers a receiver */
+	void RegisterReceiver(ULightExposureComponent* Receiver);
+
+	/** Unregisters a receiver */
+	void UnregisterReceiver(ULightExposureComponent* Receiver);
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem Interface
+
+	/** Computes the exposure of every copied receiver from a single light into LightExposures */
+	void ComputeLightExposure(const FLightSnapshot& Light, int32 NumReceivers);
+
+	/** Starts occlusion traces for lit receivers, round robin */
+	void StartOcclusionTraces(int32 NumReceivers);
+
+	/** Applies an occlusion trace result */
+	void OnOcclusionTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+};
@@ -3,11 +3,16 @@
 
 #include "HorrorUI.h"
 #include "HorrorCharacter.h"
+#include "GrimRailHUDModel.h"
+
+void UHorrorUI::SetupHUDModel(UGrimRailHUDModel* HUDModel)
+{
+	HUDModel->OnSprintPercentChanged.AddDynamic(this, &UHorrorUI::OnSprintMeterUpdated);
+	HUDModel->OnSprintingChanged.AddDynamic(this, &UHorrorUI::OnSprintStateChanged);
+}
 
 void UHorrorUI::SetupCharacter(AHorrorCharacter* HorrorCharacter)
 {
-	HorrorCharacter->OnSprintMeterUpdated.AddDynamic(this, &UHorrorUI::OnSprintMeterUpdated);
-	HorrorCharacter->OnSprintStateChanged.AddDynamic(this, &UHorrorUI::OnSprintStateChanged);
 	HorrorCharacter->OnInteractableDetected.AddDynamic(this, &UHorrorUI::OnInteractableDetected);
 	HorrorCharacter->OnInteractableLost.AddDynamic(this, &UHorrorUI::OnInteractableLost);
 }
@@ -7,10 +7,12 @@
 #include "HorrorUI.generated.h"
 
 class AHorrorCharacter;
+class UGrimRailHUDModel;
 
 /**
  *  Simple UI for a first person horror game
  *  Manages character sprint meter display
+ *  Sprint values come from the owning player's HUD model, so they arrive at most once per frame
  */
 UCLASS(abstract)
 class GRIMRAILDEMO_API UHorrorUI : public UUserWidget
@@ -19,6 +21,9 @@ class GRIMRAILDEMO_API UHorrorUI : public UUserWidget
 	
 public:
 
+	/** Sets up delegate listeners for the passed HUD model */
+	void SetupHUDModel(UGrimRailHUDModel* HUDModel);
+
 	/** Sets up delegate listeners for the passed character */
 	void SetupCharacter(AHorrorCharacter* HorrorCharacter);
 
@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "NotebookEntryRow.h"
+
+const FNotebookEntry* UNotebookEntryListItem::ResolveEntry() const
+{
+	const UNotebookComponent* NotebookComponent = Notebook.Get();
+	return NotebookComponent ? NotebookComponent->ResolveEntryHandle(Handle) : nullptr;
+}
+
+void UNotebookEntryRow::NativeOnListItemObjectSet(UObject* ListItemObject)
+{
+	IUserObjectListEntry::NativeOnListItemObjectSet(ListItemObject);
+
+	RefreshEntry();
+}
+
+void UNotebookEntryRow::RefreshEntry()
+{
+	const UNotebookEntryListItem* Item = GetListItem<UNotebookEntryListItem>();
+	const FNotebookEntry* Entry = Item ? Item->ResolveEntry() : nullptr;
+
+	if (Entry)
+	{
+		// call the BP handler
+		BP_ShowEntry(*Entry);
+
+	} else {
+
+		BP_ClearEntry();
+	}
+}
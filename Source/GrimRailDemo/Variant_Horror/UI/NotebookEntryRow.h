@@ -0,0 +1,60 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/IUserObjectListEntry.h"
+#include "NotebookComponent.h"
+#include "NotebookEntryRow.generated.h"
+
+/**
+ *  List item pointing at a notebook entry
+ *  Only holds a handle, the entry stays in the notebook component
+ */
+UCLASS()
+class GRIMRAILDEMO_API UNotebookEntryListItem : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Notebook holding the entry */
+	TWeakObjectPtr<UNotebookComponent> Notebook;
+
+	/** Handle to the entry */
+	FNotebookEntryHandle Handle;
+
+	/** Returns the entry, or nullptr if the notebook is gone or was cleared since */
+	const FNotebookEntry* ResolveEntry() const;
+};
+
+/**
+ *  Row of the notebook entry list
+ *  Rows are only created for visible entries and are recycled by the list view while scrolling,
+ *  so a row can show many different entries over its lifetime
+ */
+UCLASS(abstract)
+class GRIMRAILDEMO_API UNotebookEntryRow : public UUserWidget, public IUserObjectListEntry
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Shows the current state of the row's entry again, e.g. after it was read */
+	void RefreshEntry();
+
+protected:
+
+	//~Begin IUserObjectListEntry Interface
+	virtual void NativeOnListItemObjectSet(UObject* ListItemObject) override;
+	//~End IUserObjectListEntry Interface
+
+	/** Passes control to Blueprint to show an entry */
+	UFUNCTION(BlueprintImplementableEvent, Category="Notebook", meta = (DisplayName = "Show Entry"))
+	void BP_ShowEntry(const FNotebookEntry& Entry);
+
+	/** Passes control to Blueprint to clear the row when its entry can't be shown */
+	UFUNCTION(BlueprintImplementableEvent, Category="Notebook", meta = (DisplayName = "Clear Entry"))
+	void BP_ClearEntry();
+};
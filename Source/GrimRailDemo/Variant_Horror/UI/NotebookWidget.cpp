@@ -0,0 +1,187 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "NotebookWidget.h"
+#include "NotebookEntryRow.h"
+#include "Components/ListView.h"
+
+void UNotebookWidget::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
+
+	if (EntryList)
+	{
+		EntryList->OnItemSelectionChanged().AddUObject(this, &UNotebookWidget::OnItemSelectionChanged);
+	}
+}
+
+void UNotebookWidget::NativeDestruct()
+{
+	// unbind from the notebook, it outlives this widget
+	if (UNotebookComponent* NotebookComponent = Notebook.Get())
+	{
+		NotebookComponent->OnNotebookEntryAdded.RemoveDynamic(this, &UNotebookWidget::OnEntryAdded);
+		NotebookComponent->OnNotebookEntryRead.RemoveDynamic(this, &UNotebookWidget::OnEntryRead);
+	}
+
+	Super::NativeDestruct();
+}
+
+void UNotebookWidget::SetupNotebook(UNotebookComponent* NotebookComponent)
+{
+	if (UNotebookComponent* OldNotebook = Notebook.Get())
+	{
+		OldNotebook->OnNotebookEntryAdded.RemoveDynamic(this, &UNotebookWidget::OnEntryAdded);
+		OldNotebook->OnNotebookEntryRead.RemoveDynamic(this, &UNotebookWidget::OnEntryRead);
+	}
+
+	Notebook = NotebookComponent;
+
+	if (NotebookComponent)
+	{
+		NotebookComponent->OnNotebookEntryAdded.AddUniqueDynamic(this, &UNotebookWidget::OnEntryAdded);
+		NotebookComponent->OnNotebookEntryRead.AddUniqueDynamic(this, &UNotebookWidget::OnEntryRead);
+	}
+
+	MarkListDirty();
+}
+
+void UNotebookWidget::ShowAllEntries()
+{
+	ListMode = ENotebookListMode::All;
+	RebuildList();
+}
+
+void UNotebookWidget::ShowCategory(ENotebookCategory Category)
+{
+	ListMode = ENotebookListMode::Category;
+	ListCategory = Category;
+	RebuildList();
+}
+
+void UNotebookWidget::ShowSearchResults(const FString& Query)
+{
+	ListMode = ENotebookListMode::Search;
+	SearchQuery = Query;
+	RebuildList();
+}
+
+void UNotebookWidget::RefreshIfDirty()
+{
+	if (bListDirty)
+	{
+		RebuildList();
+	}
+}
+
+void UNotebookWidget::MarkListDirty()
+{
+	bListDirty = true;
+
+	// don't rebuild a hidden list for every entry picked up
+	if (IsVisible())
+	{
+		RebuildList();
+	}
+}
+
+void UNotebookWidget::RebuildList()
+{
+	bListDirty = false;
+
+	if (!EntryList)
+	{
+		return;
+	}
+
+	UNotebookComponent* NotebookComponent = Notebook.Get();
+
+	TArray<FNotebookEntryHandle> Handles;
+
+	if (NotebookComponent)
+	{
+		switch (ListMode)
+		{
+		case ENotebookListMode::All:
+			NotebookComponent->GetAllEntryHandles(Handles);
+			break;
+
+		case ENotebookListMode::Category:
+			NotebookComponent->GetEntryHandlesByCategory(ListCategory, Handles);
+			break;
+
+		case ENotebookListMode::Search:
+			NotebookComponent->SearchEntries(SearchQuery, 0, Handles);
+			break;
+		}
+	}
+
+	// reuse the items from the last rebuild, only the handles change
+	while (ItemPool.Num() < Handles.Num())
+	{
+		ItemPool.Add(NewObject<UNotebookEntryListItem>(this));
+	}
+
+	TArray<UObject*> Items;
+	Items.Reserve(Handles.Num());
+
+	for (int32 Index = 0; Index < Handles.Num(); ++Index)
+	{
+		UNotebookEntryListItem* Item = ItemPool[Index];
+		Item->Notebook = NotebookComponent;
+		Item->Handle = Handles[Index];
+
+		Items.Add(Item);
+	}
+
+	// the list view only rebuilds the rows on screen
+	EntryList->SetListItems(Items);
+	EntryList->RegenerateAllEntries();
+}
+
+void UNotebookWidget::OnEntryAdded(const FNotebookEntry& Entry, int32 UnreadCount)
+{
+	MarkListDirty();
+}
+
+void UNotebookWidget::OnEntryRead(const FNotebookEntry& Entry)
+{
+	if (!EntryList)
+	{
+		return;
+	}
+
+	// only rows on screen exist, the rest pick up the change when scrolled into view
+	for (UUserWidget* Widget : EntryList->GetDisplayedEntryWidgets())
+	{
+		UNotebookEntryRow* Row = Cast<UNotebookEntryRow>(Widget);
+		const UNotebookEntryListItem* Item = Row ? Row->GetListItem<UNotebookEntryListItem>() : nullptr;
+		const FNotebookEntry* RowEntry = Item ? Item->ResolveEntry() : nullptr;
+
+		if (RowEntry && RowEntry->EntryID == Entry.EntryID)
+		{
+			Row->RefreshEntry();
+		}
+	}
+}
+
+void UNotebookWidget::OnItemSelectionChanged(UObject* Item)
+{
+	const UNotebookEntryListItem* EntryItem = Cast<UNotebookEntryListItem>(Item);
+	const FNotebookEntry* Entry = EntryItem ? EntryItem->ResolveEntry() : nullptr;
+
+	if (!Entry)
+	{
+		return;
+	}
+
+	const FName EntryID = Entry->EntryID;
+
+	// call the BP handler before marking it read, so it can tell new entries apart
+	BP_EntrySelected(*Entry);
+
+	if (UNotebookComponent* NotebookComponent = Notebook.Get())
+	{
+		NotebookComponent->MarkEntryAsRead(EntryID);
+	}
+}
@@ -0,0 +1,103 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "NotebookComponent.h"
+#include "NotebookWidget.generated.h"
+
+class UListView;
+class UNotebookEntryListItem;
+
+/** Which entries the notebook list shows */
+enum class ENotebookListMode : uint8
+{
+	All,
+	Category,
+	Search
+};
+
+/**
+ *  Notebook UI for a first person horror game
+ *  Entries are shown in a virtualized list view: rows are only built for visible entries and recycled while
+ *  scrolling, and list items only hold handles into the notebook. The list is rebuilt lazily, only while shown
+ */
+UCLASS(abstract)
+class GRIMRAILDEMO_API UNotebookWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Entry list. Its entry widget class should be a UNotebookEntryRow */
+	UPROPERTY(BlueprintReadOnly, Category="Notebook", meta = (BindWidget))
+	TObjectPtr<UListView> EntryList;
+
+	/** Notebook being shown */
+	TWeakObjectPtr<UNotebookComponent> Notebook;
+
+	/** Which entries are shown */
+	ENotebookListMode ListMode = ENotebookListMode::All;
+
+	/** Category shown in category mode */
+	ENotebookCategory ListCategory = ENotebookCategory::Clue;
+
+	/** Query shown in search mode */
+	FString SearchQuery;
+
+	/** List items, reused across rebuilds */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UNotebookEntryListItem>> ItemPool;
+
+	/** True if the list has to be rebuilt before it's shown again */
+	bool bListDirty = true;
+
+public:
+
+	/** Shows the entries of a notebook */
+	void SetupNotebook(UNotebookComponent* NotebookComponent);
+
+	/** Shows every entry, in the order they were found */
+	UFUNCTION(BlueprintCallable, Category="Notebook")
+	void ShowAllEntries();
+
+	/** Shows the entries of one category */
+	UFUNCTION(BlueprintCallable, Category="Notebook")
+	void ShowCategory(ENotebookCategory Category);
+
+	/** Shows the entries matching a search, best match first */
+	UFUNCTION(BlueprintCallable, Category="Notebook")
+	void ShowSearchResults(const FString& Query);
+
+	/** Rebuilds the list if entries changed while it was hidden. Called when the notebook opens */
+	void RefreshIfDirty();
+
+protected:
+
+	//~Begin UUserWidget Interface
+	virtual void NativeOnInitialized() override;
+	virtual void NativeDestruct() override;
+	//~End UUserWidget Interface
+
+	/** Rebuilds the list items for the current mode */
+	void RebuildList();
+
+	/** Rebuilds right away if shown, otherwise on the next open */
+	void MarkListDirty();
+
+	/** Called when an entry is added to the notebook */
+	UFUNCTION()
+	void OnEntryAdded(const FNotebookEntry& Entry, int32 UnreadCount);
+
+	/** Called when an entry of the notebook is read */
+	UFUNCTION()
+	void OnEntryRead(const FNotebookEntry& Entry);
+
+	/** Marks the selected entry as read */
+	void OnItemSelectionChanged(UObject* Item);
+
+	/** Passes control to Blueprint to show the selected entry */
+	UFUNCTION(BlueprintImplementableEvent, Category="Notebook", meta = (DisplayName = "Entry Selected"))
+	void BP_EntrySelected(const FNotebookEntry& Entry);
+};
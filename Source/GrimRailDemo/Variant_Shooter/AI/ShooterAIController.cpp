@@ -29,7 +29,7 @@ void AShooterAIController::OnPossess(APawn* InPawn)
 	if (AShooterNPC* NPC = Cast<AShooterNPC>(InPawn))
 	{
 		// add the team tag to the pawn
-		NPC->Tags.Add(TeamTag);
+		NPC->Tags.AddUnique(TeamTag);
 
 		// subscribe to the pawn's OnDeath delegate
 		NPC->OnPawnDeath.AddDynamic(this, &AShooterAIController::OnPawnDeath);
@@ -38,6 +38,16 @@ void AShooterAIController::OnPossess(APawn* InPawn)
 
 void AShooterAIController::OnPawnDeath()
 {
+	// pooled NPCs keep their controller so the whole stack can be reused
+	if (const AShooterNPC* NPC = Cast<AShooterNPC>(GetPawn()))
+	{
+		if (NPC->IsPooled())
+		{
+			PauseForPool();
+			return;
+		}
+	}
+
 	// stop movement
 	GetPathFollowingComponent()->AbortMove(*this, FPathFollowingResultFlags::UserAbort);
 
@@ -51,6 +61,32 @@ void AShooterAIController::OnPawnDeath()
 	Destroy();
 }
 
+void AShooterAIController::PauseForPool()
+{
+	// stop movement
+	GetPathFollowingComponent()->AbortMove(*this, FPathFollowingResultFlags::UserAbort);
+
+	// stop StateTree logic
+	StateTreeAI->StopLogic(FString("Pooled"));
+
+	// forget the current target
+	ClearCurrentTarget();
+	ClearFocus(EAIFocusPriority::Gameplay);
+}
+
+void AShooterAIController::ResumeFromPool()
+{
+	// make sure the pawn still carries the team tag
+	if (APawn* ControlledPawn = GetPawn())
+	{
+		ControlledPawn->Tags.AddUnique(TeamTag);
+	}
+
+	// restart the StateTree so it begins from its initial state
+	StateTreeAI->StopLogic(FString("Reused"));
+	StateTreeAI->StartLogic();
+}
+
 void AShooterAIController::SetCurrentTarget(AActor* Target)
 {
 	TargetEnemy = Target;
@@ -73,6 +73,12 @@ public:
 	/** Returns the targeted enemy */
 	AActor* GetCurrentTarget() const { return TargetEnemy; };
 
+	/** Stops movement and StateTree logic while the possessed NPC waits in the pool */
+	void PauseForPool();
+
+	/** Restarts StateTree logic from scratch after the possessed NPC is reused from the pool */
+	void ResumeFromPool();
+
 protected:
 
 	/** Called when the AI perception component updates a perception on a given actor */
@@ -0,0 +1,92 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterAnimationBudgetSubsystem.h"
+#include "GrimRailSignificanceSubsystem.h"
+#include "IAnimationBudgetAllocator.h"
+#include "AnimationBudgetAllocatorParameters.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "Engine/World.h"
+
+bool UShooterAnimationBudgetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterAnimationBudgetSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(&InWorld);
+
+	if (!Allocator)
+	{
+		return;
+	}
+
+	FAnimationBudgetAllocatorParameters Parameters;
+	Parameters.BudgetInMs = BudgetMs;
+	Parameters.MaxTickRate = MaxTickRate;
+	Parameters.MaxInterpolatedComponents = MaxInterpolatedMeshes;
+	Parameters.InterpolationMaxRate = InterpolationMaxRate;
+
+	Allocator->SetParameters(Parameters);
+	Allocator->SetEnabled(true);
+}
+
+void UShooterAnimationBudgetSubsystem::RegisterMesh(AActor* Owner, USkeletalMeshComponentBudgeted* Mesh)
+{
+	if (!Owner || !Mesh || MeshOwners.Contains(Owner))
+	{
+		return;
+	}
+
+	MeshOwners.Add(Owner);
+
+	// the significance subsystem already evaluates the local views, reuse its significance for the mesh
+	if (UGrimRailSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UGrimRailSignificanceSubsystem>())
+	{
+		TWeakObjectPtr<USkeletalMeshComponentBudgeted> WeakMesh = Mesh;
+
+		Significance->RegisterListener(Owner, TEXT("AnimationBudget"), FGrimRailSignificanceDelegate::CreateWeakLambda(this, [WeakMesh](float MeshSignificance)
+		{
+			if (USkeletalMeshComponentBudgeted* BudgetedMesh = WeakMesh.Get())
+			{
+				BudgetedMesh->SetComponentSignificance(MeshSignificance);
+			}
+		}));
+	}
+}
+
+void UShooterAnimationBudgetSubsystem::UnregisterMesh(AActor* Owner)
+{
+	if (MeshOwners.Remove(Owner) == 0)
+	{
+		return;
+	}
+
+	if (UGrimRailSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UGrimRailSignificanceSubsystem>())
+	{
+		Significance->UnregisterListener(Owner);
+	}
+}
+
+void UShooterAnimationBudgetSubsystem::SetMeshBudgeted(USkeletalMeshComponentBudgeted* Mesh, bool bBudgeted)
+{
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(GetWorld());
+
+	if (!Mesh || !Allocator || !Mesh->IsRegistered())
+	{
+		return;
+	}
+
+	if (bBudgeted)
+	{
+		Allocator->RegisterComponent(Mesh);
+
+	} else {
+
+		// the allocator hands the tick back to the mesh
+		Allocator->UnregisterComponent(Mesh);
+	}
+}
@@ -0,0 +1,63 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterAnimationBudgetSubsystem.generated.h"
+
+class USkeletalMeshComponentBudgeted;
+
+/**
+ *  Keeps NPC animation inside a fixed time budget for the shooter variant
+ *  Configures the animation budget allocator, which ticks budgeted NPC meshes at a reduced, interpolated
+ *  rate when the budget runs short, and feeds it each NPC's significance so far and unseen NPCs degrade first
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UShooterAnimationBudgetSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Time per frame all budgeted NPC meshes together may spend animating */
+	UPROPERTY(Config, EditAnywhere, Category="Animation Budget", meta = (ClampMin = 0.1, Units = "ms"))
+	float BudgetMs = 1.5f;
+
+	/** Most frames the least significant NPC mesh may go without an animation update */
+	UPROPERTY(Config, EditAnywhere, Category="Animation Budget", meta = (ClampMin = 1))
+	int32 MaxTickRate = 10;
+
+	/** Most NPC meshes that interpolate between their skipped updates at once */
+	UPROPERTY(Config, EditAnywhere, Category="Animation Budget", meta = (ClampMin = 0))
+	int32 MaxInterpolatedMeshes = 32;
+
+	/** Most frames between updates a mesh may have and still be interpolated */
+	UPROPERTY(Config, EditAnywhere, Category="Animation Budget", meta = (ClampMin = 1))
+	int32 InterpolationMaxRate = 20;
+
+	/** Actors whose mesh follows their significance */
+	TSet<TObjectKey<AActor>> MeshOwners;
+
+public:
+
+	/**
+	 * Starts scaling the mesh's animation rate by its owner's significance
+	 * @param Owner Actor whose significance drives the mesh
+	 * @param Mesh Budgeted mesh of the actor
+	 */
+	void RegisterMesh(AActor* Owner, USkeletalMeshComponentBudgeted* Mesh);
+
+	/** Stops scaling the owner's mesh animation rate */
+	void UnregisterMesh(AActor* Owner);
+
+	/** Hands the mesh's tick to the budget allocator or takes it back, e.g. while the mesh is a ragdoll */
+	void SetMeshBudgeted(USkeletalMeshComponentBudgeted* Mesh, bool bBudgeted);
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	//~End UWorldSubsystem Interface
+};
@@ -0,0 +1,242 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterCorpseSubsystem.h"
+#include "GrimRailTickScheduler.h"
+#include "GrimRailMemorySubsystem.h"
+#include "ShooterNPC.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+void UShooterCorpseSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// run from the tick scheduler instead of ticking on our own
+	if (UGrimRailTickScheduler* Scheduler = Collection.InitializeDependency<UGrimRailTickScheduler>())
+	{
+		TickTaskID = Scheduler->RegisterTask(TEXT("Corpses"), EGrimRailTickLane::Deferrable, FGrimRailTickDelegate::CreateUObject(this, &UShooterCorpseSubsystem::ScheduledTick));
+	}
+
+	// break the corpses out in the memory report. They're NPC actors and already counted under ShooterNPC,
+	// so the row is a subset and stays out of the totals
+	if (UGrimRailMemorySubsystem* Memory = Collection.InitializeDependency<UGrimRailMemorySubsystem>())
+	{
+		Memory->RegisterCounter(TEXT("Corpses"), FGrimRailMemoryCounter::CreateUObject(this, &UShooterCorpseSubsystem::CountCorpses), true);
+	}
+}
+
+void UShooterCorpseSubsystem::Deinitialize()
+{
+	if (UGrimRailTickScheduler* Scheduler = GetWorld()->GetSubsystem<UGrimRailTickScheduler>())
+	{
+		Scheduler->UnregisterTask(TickTaskID);
+	}
+
+	TickTaskID = INDEX_NONE;
+
+	if (UGrimRailMemorySubsystem* Memory = GetWorld()->GetSubsystem<UGrimRailMemorySubsystem>())
+	{
+		Memory->UnregisterCounter(TEXT("Corpses"));
+	}
+
+	Super::Deinitialize();
+}
+
+void UShooterCorpseSubsystem::CountCorpses(bool bWithBytes, int32& OutCount, int64& OutBytes) const
+{
+	for (const FCorpse& Corpse : Corpses)
+	{
+		if (AShooterNPC* NPC = Corpse.NPC.Get())
+		{
+			++OutCount;
+			OutBytes += bWithBytes ? UGrimRailMemorySubsystem::GetActorBytes(NPC) : 0;
+		}
+	}
+}
+
+void UShooterCorpseSubsystem::ScheduledTick(float DeltaTime)
+{
+	// nothing to manage
+	if (Corpses.Num() == 0)
+	{
+		TimeSinceUpdate = 0.0f;
+		return;
+	}
+
+	// throttle the update
+	TimeSinceUpdate += DeltaTime;
+
+	if (TimeSinceUpdate >= UpdateInterval)
+	{
+		UpdateCorpses();
+		TimeSinceUpdate = 0.0f;
+	}
+}
+
+bool UShooterCorpseSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterCorpseSubsystem::RegisterCorpse(AShooterNPC* NPC, float Lifetime)
+{
+	if (!NPC)
+	{
+		return;
+	}
+
+	// new corpses go to the back so the array stays ordered from oldest to newest
+	FCorpse& Corpse = Corpses.AddDefaulted_GetRef();
+	Corpse.NPC = NPC;
+	Corpse.ExpireTime = GetWorld()->GetTimeSeconds() + Lifetime;
+
+	// make room right away if we're over the corpse cap
+	while (Corpses.Num() > MaxCorpses)
+	{
+		RecycleCorpse(0);
+	}
+}
+
+void UShooterCorpseSubsystem::UnregisterCorpse(AShooterNPC* NPC)
+{
+	Corpses.RemoveAll([NPC](const FCorpse& Corpse)
+	{
+		return Corpse.NPC.Get() == NPC;
+	});
+}
+
+void UShooterCorpseSubsystem::UpdateCorpses()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// drop corpses that were destroyed externally and recycle the expired ones
+	for (int32 Index = 0; Index < Corpses.Num(); )
+	{
+		if (!Corpses[Index].NPC.IsValid())
+		{
+			Corpses.RemoveAt(Index);
+		}
+		else if (Corpses[Index].ExpireTime <= Now)
+		{
+			RecycleCorpse(Index);
+		}
+		else
+		{
+			++Index;
+		}
+	}
+
+	TArray<FVector> ViewLocations;
+	GatherViewLocations(ViewLocations);
+
+	const float FreezeDistanceSquared = FMath::Square(FreezeDistance);
+	const float SleepSpeedSquared = FMath::Square(SleepLinearSpeed);
+
+	// walk from newest to oldest so the newest deaths keep their simulation budget
+	int32 NumSimulating = 0;
+
+	for (int32 Index = Corpses.Num() - 1; Index >= 0; --Index)
+	{
+		FCorpse& Corpse = Corpses[Index];
+
+		if (Corpse.State == EShooterCorpseState::Frozen)
+		{
+			continue;
+		}
+
+		USkeletalMeshComponent* Mesh = Corpse.NPC->GetMesh();
+		const FVector CorpseLocation = Mesh->GetComponentLocation();
+
+		// freeze ragdolls nobody is close enough to see
+		bool bNearViewer = ViewLocations.Num() == 0;
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			if (FVector::DistSquared(ViewLocation, CorpseLocation) <= FreezeDistanceSquared)
+			{
+				bNearViewer = true;
+				break;
+			}
+		}
+
+		// freeze anything over the simulation cap
+		if (!bNearViewer || NumSimulating >= MaxSimulatingRagdolls)
+		{
+			FreezeCorpse(Corpse);
+			continue;
+		}
+
+		++NumSimulating;
+
+		// put the ragdoll to sleep once it has stayed still long enough
+		if (Corpse.State == EShooterCorpseState::Simulating)
+		{
+			if (Mesh->GetPhysicsLinearVelocity().SizeSquared() <= SleepSpeedSquared)
+			{
+				Corpse.SettledTime += UpdateInterval;
+
+				if (Corpse.SettledTime >= SettleTime)
+				{
+					SleepCorpse(Corpse);
+				}
+
+			} else {
+
+				Corpse.SettledTime = 0.0f;
+			}
+
+		} else if (Mesh->IsAnyRigidBodyAwake()) {
+
+			// something woke the ragdoll up again, e.g. a projectile impulse
+			Corpse.State = EShooterCorpseState::Simulating;
+			Corpse.SettledTime = 0.0f;
+		}
+	}
+}
+
+void UShooterCorpseSubsystem::SleepCorpse(FCorpse& Corpse)
+{
+	Corpse.NPC->GetMesh()->PutAllRigidBodiesToSleep();
+	Corpse.State = EShooterCorpseState::Asleep;
+}
+
+void UShooterCorpseSubsystem::FreezeCorpse(FCorpse& Corpse)
+{
+	USkeletalMeshComponent* Mesh = Corpse.NPC->GetMesh();
+
+	// stop refreshing bones first so turning physics off keeps the current ragdoll pose
+	Mesh->bNoSkeletonUpdate = true;
+	Mesh->SetComponentTickEnabled(false);
+
+	Mesh->SetSimulatePhysics(false);
+	Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	Corpse.State = EShooterCorpseState::Frozen;
+}
+
+void UShooterCorpseSubsystem::RecycleCorpse(int32 Index)
+{
+	// remove the entry first, the NPC unregisters itself again while being destroyed
+	TWeakObjectPtr<AShooterNPC> NPC = Corpses[Index].NPC;
+	Corpses.RemoveAt(Index);
+
+	if (AShooterNPC* DeadNPC = NPC.Get())
+	{
+		DeadNPC->DeferredDestruction();
+	}
+}
+
+void UShooterCorpseSubsystem::GatherViewLocations(TArray<FVector>& OutLocations) const
+{
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+
+		if (PC && PC->IsLocalController() && PC->PlayerCameraManager)
+		{
+			OutLocations.Add(PC->PlayerCameraManager->GetCameraLocation());
+		}
+	}
+}
@@ -0,0 +1,135 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterCorpseSubsystem.generated.h"
+
+class AShooterNPC;
+
+/** Physics LOD of a managed corpse */
+enum class EShooterCorpseState : uint8
+{
+	/** Ragdoll is simulating and awake */
+	Simulating,
+
+	/** Ragdoll has settled and its bodies were put to sleep */
+	Asleep,
+
+	/** Physics is off and the mesh holds its last ragdoll pose */
+	Frozen
+};
+
+/**
+ *  Manages dead NPC ragdolls for the shooter variant
+ *  Caps how many ragdolls simulate at once, puts settled bodies to sleep early,
+ *  freezes distant bodies into a posed snapshot and recycles the oldest corpses first
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UShooterCorpseSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Book-keeping for a single corpse */
+	struct FCorpse
+	{
+		/** Dead NPC */
+		TWeakObjectPtr<AShooterNPC> NPC;
+
+		/** World time after which the corpse is recycled */
+		double ExpireTime = 0.0;
+
+		/** Time the ragdoll has spent below the sleep velocity */
+		float SettledTime = 0.0f;
+
+		/** Current physics LOD */
+		EShooterCorpseState State = EShooterCorpseState::Simulating;
+	};
+
+	/** Corpses ordered from oldest to newest */
+	TArray<FCorpse> Corpses;
+
+	/** Max number of ragdolls allowed to simulate at once. The oldest ones are frozen first */
+	UPROPERTY(Config, EditAnywhere, Category="Corpses", meta = (ClampMin = 0))
+	int32 MaxSimulatingRagdolls = 6;
+
+	/** Max number of corpses allowed in the world. The oldest ones are recycled first */
+	UPROPERTY(Config, EditAnywhere, Category="Corpses", meta = (ClampMin = 1))
+	int32 MaxCorpses = 20;
+
+	/** Ragdoll root speed under which the body is considered settled */
+	UPROPERTY(Config, EditAnywhere, Category="Corpses", meta = (ClampMin = 0, Units = "cm/s"))
+	float SleepLinearSpeed = 10.0f;
+
+	/** How long a ragdoll must stay under the sleep speed before it's put to sleep */
+	UPROPERTY(Config, EditAnywhere, Category="Corpses", meta = (ClampMin = 0, Units = "s"))
+	float SettleTime = 0.5f;
+
+	/** Ragdolls farther than this from every local viewer are frozen right away */
+	UPROPERTY(Config, EditAnywhere, Category="Corpses", meta = (ClampMin = 0, Units = "cm"))
+	float FreezeDistance = 4000.0f;
+
+	/** Time between corpse updates */
+	UPROPERTY(Config, EditAnywhere, Category="Corpses", meta = (ClampMin = 0, Units = "s"))
+	float UpdateInterval = 0.1f;
+
+	/** Time accumulated since the last corpse update */
+	float TimeSinceUpdate = 0.0f;
+
+	/** Tick scheduler task running the corpse update */
+	int32 TickTaskID = INDEX_NONE;
+
+public:
+
+	//~Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem Interface
+
+	/** Runs the corpse update from the tick scheduler's deferrable lane */
+	void ScheduledTick(float DeltaTime);
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem Interface
+
+public:
+
+	/**
+	 * Starts managing a freshly ragdolled NPC
+	 * @param NPC The dead NPC
+	 * @param Lifetime Time to keep the corpse around before it's recycled
+	 */
+	void RegisterCorpse(AShooterNPC* NPC, float Lifetime);
+
+	/** Stops managing the given NPC without recycling it */
+	void UnregisterCorpse(AShooterNPC* NPC);
+
+	/** Returns the number of corpses currently managed */
+	int32 GetNumCorpses() const { return Corpses.Num(); }
+
+protected:
+
+	/** Runs the throttled corpse update */
+	void UpdateCorpses();
+
+	/** Puts all of the corpse's rigid bodies to sleep */
+	void SleepCorpse(FCorpse& Corpse);
+
+	/** Turns off physics and keeps the corpse in its last simulated pose */
+	void FreezeCorpse(FCorpse& Corpse);
+
+	/** Recycles the corpse at the given index */
+	void RecycleCorpse(int32 Index);
+
+	/** Counts the corpses and their bytes for the memory report */
+	void CountCorpses(bool bWithBytes, int32& OutCount, int64& OutBytes) const;
+
+	/** Collects the camera locations of all local players */
+	void GatherViewLocations(TArray<FVector>& OutLocations) const;
+};
@@ -5,17 +5,65 @@
 #include "ShooterWeapon.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Camera/CameraComponent.h"
-#include "Kismet/KismetMathLibrary.h"
 #include "Engine/World.h"
 #include "ShooterGameMode.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "TimerManager.h"
+#include "GrimRailRandomSubsystem.h"
+#include "ShooterCorpseSubsystem.h"
+#include "ShooterNPCPoolSubsystem.h"
+#include "CharacterStatSubsystem.h"
+#include "ShooterAnimationBudgetSubsystem.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "GrimRailMemorySubsystem.h"
+#include "Net/UnrealNetwork.h"
+
+AShooterNPC::AShooterNPC(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName))
+{
+	// NPCs can number in the dozens, so update them less often than players and only for nearby clients
+	SetNetUpdateFrequency(20.0f);
+	SetMinNetUpdateFrequency(5.0f);
+	SetNetCullDistanceSquared(FMath::Square(10000.0f));
+
+	// leave bandwidth to player pawns first when the connection is saturated
+	NetPriority = 2.0f;
+
+	// NPCs can't be possessed by a player, so nobody ever sees the first person arms.
+	// Keep the mesh for the aim camera attached to it, but never animate it
+	GetFirstPersonMesh()->PrimaryComponentTick.bStartWithTickEnabled = false;
+	GetFirstPersonMesh()->SetVisibility(false);
+}
 
 void AShooterNPC::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// save the initial state so the pool can restore it when reusing this character
+	SpawnHP = CurrentHP;
+	DefaultMeshCollisionProfile = GetMesh()->GetCollisionProfileName();
+
+	// health is held by the character stat subsystem
+	if (UCharacterStatSubsystem* CharacterStats = GetWorld()->GetSubsystem<UCharacterStatSubsystem>())
+	{
+		HealthID = CharacterStats->RegisterHealth(SpawnHP, CurrentHP);
+	}
+
+	// animate the character mesh within the NPC animation budget, at a rate scaled by significance
+	if (UShooterAnimationBudgetSubsystem* AnimationBudget = GetWorld()->GetSubsystem<UShooterAnimationBudgetSubsystem>())
+	{
+		AnimationBudget->RegisterMesh(this, Cast<USkeletalMeshComponentBudgeted>(GetMesh()));
+	}
+
+	// the weapon is spawned by the server and replicated to clients
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	LLM_SCOPE_BYTAG(GrimRail_Weapons);
+
 	// spawn the weapon
 	FActorSpawnParameters SpawnParams;
 	SpawnParams.Owner = this;
@@ -31,18 +79,51 @@ void AShooterNPC::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	// clear the death timer
 	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// stop being managed as a corpse
+	if (UShooterCorpseSubsystem* CorpseSubsystem = GetWorld()->GetSubsystem<UShooterCorpseSubsystem>())
+	{
+		CorpseSubsystem->UnregisterCorpse(this);
+	}
+
+	// release the health value
+	if (UCharacterStatSubsystem* CharacterStats = GetWorld()->GetSubsystem<UCharacterStatSubsystem>())
+	{
+		CharacterStats->UnregisterHealth(HealthID);
+	}
+
+	HealthID = INDEX_NONE;
+
+	if (UShooterAnimationBudgetSubsystem* AnimationBudget = GetWorld()->GetSubsystem<UShooterAnimationBudgetSubsystem>())
+	{
+		AnimationBudget->UnregisterMesh(this);
+	}
+}
+
+void AShooterNPC::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AShooterNPC, bIsDead);
 }
 
 float AShooterNPC::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-	// ignore if already dead
-	if (bIsDead)
+	// damage is server authoritative. Ignore if already dead
+	if (!HasAuthority() || bIsDead)
 	{
 		return 0.0f;
 	}
 
 	// Reduce HP
-	CurrentHP -= Damage;
+	if (UCharacterStatSubsystem* CharacterStats = GetWorld()->GetSubsystem<UCharacterStatSubsystem>())
+	{
+		CurrentHP = CharacterStats->ApplyDamage(HealthID, Damage);
+	}
+	else
+	{
+		CurrentHP -= Damage;
+	}
 
 	// Have we depleted HP?
 	if (CurrentHP <= 0.0f)
@@ -53,6 +134,12 @@ float AShooterNPC::TakeDamage(float Damage, struct FDamageEvent const& DamageEve
 	return Damage;
 }
 
+bool AShooterNPC::UsesFirstPersonWeaponMesh() const
+{
+	// NPCs are never possessed by a player, nobody sees their first person weapon
+	return false;
+}
+
 void AShooterNPC::AttachWeaponMeshes(AShooterWeapon* WeaponToAttach)
 {
 	const FAttachmentTransformRules AttachmentRule(EAttachmentRule::SnapToTarget, false);
@@ -60,8 +147,8 @@ void AShooterNPC::AttachWeaponMeshes(AShooterWeapon* WeaponToAttach)
 	// attach the weapon actor
 	WeaponToAttach->AttachToActor(this, AttachmentRule);
 
-	// attach the weapon meshes
-	WeaponToAttach->GetFirstPersonMesh()->AttachToComponent(GetFirstPersonMesh(), AttachmentRule, FirstPersonWeaponSocket);
+	// attach the third person mesh only. The first person mesh is disabled for NPCs,
+	// so there's no point paying for it to follow the first person arms around
 	WeaponToAttach->GetThirdPersonMesh()->AttachToComponent(GetMesh(), AttachmentRule, FirstPersonWeaponSocket);
 }
 
@@ -87,6 +174,9 @@ FVector AShooterNPC::GetWeaponTargetLocation()
 
 	FVector AimDir, AimTarget = FVector::ZeroVector;
 
+	// draw from the NPC aim stream so seeded runs are reproducible
+	FGrimRailRandomStream& AimStream = UGrimRailRandomSubsystem::GetStream(GetWorld(), EGrimRailRandomStream::NPCAim);
+
 	// do we have an aim target?
 	if (CurrentAimTarget)
 	{
@@ -94,17 +184,17 @@ FVector AShooterNPC::GetWeaponTargetLocation()
 		AimTarget = CurrentAimTarget->GetActorLocation();
 
 		// apply a vertical offset to target head/feet
-		AimTarget.Z += FMath::RandRange(MinAimOffsetZ, MaxAimOffsetZ);
+		AimTarget.Z += AimStream.FRandRange(MinAimOffsetZ, MaxAimOffsetZ);
 
 		// get the aim direction and apply randomness in a cone
 		AimDir = (AimTarget - AimSource).GetSafeNormal();
-		AimDir = UKismetMathLibrary::RandomUnitVectorInConeInDegrees(AimDir, AimVarianceHalfAngle);
+		AimDir = AimStream.VRandCone(AimDir, FMath::DegreesToRadians(AimVarianceHalfAngle));
 
 		
 	} else {
 
 		// no aim target, so just use the camera facing
-		AimDir = UKismetMathLibrary::RandomUnitVectorInConeInDegrees(GetFirstPersonCameraComponent()->GetForwardVector(), AimVarianceHalfAngle);
+		AimDir = AimStream.VRandCone(GetFirstPersonCameraComponent()->GetForwardVector(), FMath::DegreesToRadians(AimVarianceHalfAngle));
 
 	}
 
@@ -159,33 +249,176 @@ void AShooterNPC::Die()
 	// raise the dead flag
 	bIsDead = true;
 
+	// notify the controller and any other listeners
+	OnPawnDeath.Broadcast();
+
 	// increment the team score
 	if (AShooterGameMode* GM = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode()))
 	{
 		GM->IncrementTeamScore(TeamByte);
 	}
 
-	// disable capsule collision
-	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-
 	// stop movement
 	GetCharacterMovement()->StopMovementImmediately();
 	GetCharacterMovement()->StopActiveMovement();
 
+	// ragdoll the body. Clients do the same when the dead flag replicates
+	StartRagdoll();
+}
+
+void AShooterNPC::StartRagdoll()
+{
+	// disable capsule collision
+	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	// the ragdoll is budgeted by the corpse subsystem, take the mesh out of the animation budget
+	if (UShooterAnimationBudgetSubsystem* AnimationBudget = GetWorld()->GetSubsystem<UShooterAnimationBudgetSubsystem>())
+	{
+		AnimationBudget->SetMeshBudgeted(Cast<USkeletalMeshComponentBudgeted>(GetMesh()), false);
+	}
+
 	// enable ragdoll physics on the third person mesh
 	GetMesh()->SetCollisionProfileName(RagdollCollisionProfile);
 	GetMesh()->SetSimulatePhysics(true);
 	GetMesh()->SetPhysicsBlendWeight(1.0f);
 
-	// schedule actor destruction
-	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &AShooterNPC::DeferredDestruction, DeferredDestructionTime, false);
+	// hand the ragdoll over to the corpse subsystem so it can budget physics and recycle old corpses
+	if (UShooterCorpseSubsystem* CorpseSubsystem = GetWorld()->GetSubsystem<UShooterCorpseSubsystem>())
+	{
+		CorpseSubsystem->RegisterCorpse(this, DeferredDestructionTime);
+
+	} else if (HasAuthority()) {
+
+		// schedule actor destruction
+		GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &AShooterNPC::DeferredDestruction, DeferredDestructionTime, false);
+	}
+}
+
+void AShooterNPC::StopRagdoll()
+{
+	// get the defaults to restore the components from
+	const AShooterNPC* DefaultNPC = GetClass()->GetDefaultObject<AShooterNPC>();
+
+	// restore the capsule collision
+	GetCapsuleComponent()->SetCollisionEnabled(DefaultNPC->GetCapsuleComponent()->GetCollisionEnabled());
+
+	// take the mesh out of ragdoll and put it back under the capsule
+	USkeletalMeshComponent* CharacterMesh = GetMesh();
+	CharacterMesh->SetSimulatePhysics(false);
+	CharacterMesh->SetPhysicsBlendWeight(0.0f);
+	CharacterMesh->SetCollisionProfileName(DefaultMeshCollisionProfile);
+	CharacterMesh->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	CharacterMesh->SetRelativeTransform(DefaultNPC->GetMesh()->GetRelativeTransform());
+	CharacterMesh->bNoSkeletonUpdate = false;
+	CharacterMesh->SetComponentTickEnabled(true);
+
+	// hand the mesh back to the animation budget
+	if (UShooterAnimationBudgetSubsystem* AnimationBudget = GetWorld()->GetSubsystem<UShooterAnimationBudgetSubsystem>())
+	{
+		AnimationBudget->SetMeshBudgeted(Cast<USkeletalMeshComponentBudgeted>(CharacterMesh), true);
+	}
+}
+
+void AShooterNPC::OnRep_IsDead()
+{
+	if (bIsDead)
+	{
+		StartRagdoll();
+
+	} else {
+
+		// the server reused this character from the NPC pool
+		StopRagdoll();
+	}
 }
 
 void AShooterNPC::DeferredDestruction()
 {
+	// clients wait for the server to destroy or pool the replicated character
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// pooled characters go back to the pool instead of being destroyed
+	if (bPooled)
+	{
+		if (UShooterNPCPoolSubsystem* Pool = GetWorld()->GetSubsystem<UShooterNPCPoolSubsystem>())
+		{
+			Pool->ReleaseNPC(this);
+			return;
+		}
+	}
+
 	Destroy();
 }
 
+void AShooterNPC::DeactivateForPool()
+{
+	// stop shooting and put the weapon away
+	if (Weapon)
+	{
+		StopShooting();
+		Weapon->DeactivateWeapon();
+	}
+
+	// clear any pending destruction and stop being managed as a corpse
+	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	if (UShooterCorpseSubsystem* CorpseSubsystem = GetWorld()->GetSubsystem<UShooterCorpseSubsystem>())
+	{
+		CorpseSubsystem->UnregisterCorpse(this);
+	}
+
+	// stop movement
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+
+	// stop any ragdoll simulation and mesh updates while pooled
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetComponentTickEnabled(false);
+
+	// hide and disable the actor
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+}
+
+void AShooterNPC::ReactivateFromPool(const FTransform& SpawnTransform)
+{
+	// reset the gameplay state
+	CurrentHP = SpawnHP;
+	bIsDead = false;
+	bIsShooting = false;
+	CurrentAimTarget = nullptr;
+
+	if (UCharacterStatSubsystem* CharacterStats = GetWorld()->GetSubsystem<UCharacterStatSubsystem>())
+	{
+		CharacterStats->SetHealth(HealthID, SpawnHP);
+	}
+
+	// restore the capsule and mesh
+	StopRagdoll();
+
+	// move to the spawn location
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+
+	// restore movement
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	// show and enable the actor
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+
+	// bring the weapon back with a full magazine
+	if (Weapon)
+	{
+		Weapon->RefillMagazine();
+		Weapon->ActivateWeapon();
+	}
+}
+
 void AShooterNPC::StartShooting(AActor* ActorToShoot)
 {
 	// save the aim target
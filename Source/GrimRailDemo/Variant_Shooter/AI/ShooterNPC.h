@@ -23,7 +23,7 @@ class GRIMRAILDEMO_API AShooterNPC : public AGrimRailDemoCharacter, public IShoo
 
 public:
 
-	/** Current HP for this character. It dies if it reaches zero through damage */
+	/** Current HP for this character. It dies if it reaches zero through damage. Mirrors the value held by the character stat subsystem */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Damage")
 	float CurrentHP = 100.0f;
 
@@ -33,7 +33,7 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FName RagdollCollisionProfile = FName("Ragdoll");
 
-	/** Time to wait after death before destroying this actor */
+	/** Time to keep the corpse around after death. The corpse subsystem may recycle it earlier when over budget */
 	UPROPERTY(EditAnywhere, Category="Damage")
 	float DeferredDestructionTime = 5.0f;
 
@@ -79,11 +79,24 @@ protected:
 	bool bIsShooting = false;
 
 	/** If true, this character has already died */
+	UPROPERTY(ReplicatedUsing=OnRep_IsDead)
 	bool bIsDead = false;
 
-	/** Deferred destruction on death timer */
+	/** Deferred destruction on death timer. Only used if no corpse subsystem is available */
 	FTimerHandle DeathTimer;
 
+	/** If true, this character is owned by the NPC pool and is deactivated instead of destroyed */
+	bool bPooled = false;
+
+	/** HP this character started with. Restored when reused from the pool */
+	float SpawnHP = 0.0f;
+
+	/** Health ID in the character stat subsystem */
+	int32 HealthID = INDEX_NONE;
+
+	/** Collision profile of the character mesh before ragdolling. Restored when reused from the pool */
+	FName DefaultMeshCollisionProfile;
+
 public:
 
 	/** Delegate called when this NPC dies */
@@ -91,6 +104,9 @@ public:
 
 protected:
 
+	/** Constructor */
+	AShooterNPC(const FObjectInitializer& ObjectInitializer);
+
 	/** Gameplay initialization */
 	virtual void BeginPlay() override;
 
@@ -99,6 +115,9 @@ protected:
 
 public:
 
+	/** Sets up replicated properties */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	/** Handle incoming damage */
 	virtual float TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
@@ -106,6 +125,9 @@ public:
 
 	//~Begin IShooterWeaponHolder interface
 
+	/** Returns true if the owner is ever seen in first person and needs the weapon's first person mesh */
+	virtual bool UsesFirstPersonWeaponMesh() const override;
+
 	/** Attaches a weapon's meshes to the owner */
 	virtual void AttachWeaponMeshes(AShooterWeapon* Weapon) override;
 
@@ -140,11 +162,42 @@ protected:
 	/** Called when HP is depleted and the character should die */
 	void Die();
 
-	/** Called after death to destroy the actor */
-	void DeferredDestruction();
+	/** Switches the mesh to ragdoll physics and hands it over to the corpse subsystem */
+	void StartRagdoll();
+
+	/** Takes the mesh out of ragdoll and puts it back under the capsule */
+	void StopRagdoll();
+
+	/** Starts or stops the ragdoll on clients */
+	UFUNCTION()
+	void OnRep_IsDead();
 
 public:
 
+	/** Called after death to destroy the actor. Also called by the corpse subsystem when recycling this corpse */
+	void DeferredDestruction();
+
+	/** Sets the type of weapon to spawn. Must be called before BeginPlay */
+	void SetWeaponClass(TSubclassOf<AShooterWeapon> NewWeaponClass) { WeaponClass = NewWeaponClass; }
+
+	/** Returns the type of weapon this character spawns */
+	TSubclassOf<AShooterWeapon> GetWeaponClass() const { return WeaponClass; }
+
+	/** Flags this character as owned by the NPC pool */
+	void SetPooled(bool bInPooled) { bPooled = bInPooled; }
+
+	/** Returns true if this character is owned by the NPC pool */
+	bool IsPooled() const { return bPooled; }
+
+	/** Returns true if this character has died */
+	bool IsDead() const { return bIsDead; }
+
+	/** Hides and disables this character so it can wait in the NPC pool */
+	void DeactivateForPool();
+
+	/** Restores HP, mesh, collision and weapon so this character can be reused from the NPC pool */
+	void ReactivateFromPool(const FTransform& SpawnTransform);
+
 	/** Signals this character to start shooting at the passed actor */
 	void StartShooting(AActor* ActorToShoot);
 
@@ -0,0 +1,222 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterNPCPoolSubsystem.h"
+#include "ShooterNPC.h"
+#include "ShooterAIController.h"
+#include "ShooterWeapon.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "GrimRailMemorySubsystem.h"
+#include "GrimRailDemo.h"
+
+static FAutoConsoleCommandWithWorld GShooterNPCPoolReportCommand(
+	TEXT("GrimRail.NPCPool.Report"),
+	TEXT("Logs NPC pool sizes along with spawn and reuse costs"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShooterNPCPoolSubsystem* Pool = World ? World->GetSubsystem<UShooterNPCPoolSubsystem>() : nullptr)
+		{
+			Pool->LogReport();
+		}
+	}));
+
+bool UShooterNPCPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterNPCPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// spawn the configured NPCs up front so the first waves don't pay the spawn cost
+	for (const FShooterNPCPoolPrewarm& Entry : PrewarmCounts)
+	{
+		if (Entry.Count > 0 && !Entry.NPCClass.IsNull())
+		{
+			Prewarm(Entry.NPCClass.LoadSynchronous(), Entry.WeaponClass.LoadSynchronous(), Entry.Count);
+		}
+	}
+}
+
+AShooterNPC* UShooterNPCPoolSubsystem::AcquireNPC(TSubclassOf<AShooterNPC> NPCClass, const FTransform& SpawnTransform, TSubclassOf<AShooterWeapon> WeaponClass)
+{
+	if (!NPCClass)
+	{
+		return nullptr;
+	}
+
+	const FPoolKey Key = MakeKey(NPCClass, WeaponClass);
+	const double StartTime = FPlatformTime::Seconds();
+
+	// try to reuse an inactive NPC first, skipping any that were destroyed while pooled
+	while (Buckets.FindOrAdd(Key).Inactive.Num() > 0)
+	{
+		FPoolBucket& Bucket = Buckets.FindChecked(Key);
+		AShooterNPC* NPC = Bucket.Inactive.Pop(EAllowShrinking::No).Get();
+
+		if (!IsValid(NPC))
+		{
+			continue;
+		}
+
+		NPC->ReactivateFromPool(SpawnTransform);
+
+		// restart the AI from its initial state
+		if (AShooterAIController* AIC = Cast<AShooterAIController>(NPC->GetController()))
+		{
+			AIC->ResumeFromPool();
+		}
+
+		Bucket.NumReused++;
+		Bucket.ReuseSeconds += FPlatformTime::Seconds() - StartTime;
+		Bucket.NumActive++;
+		Bucket.PeakActive = FMath::Max(Bucket.PeakActive, Bucket.NumActive);
+
+		return NPC;
+	}
+
+	// nothing to reuse, so spawn a new one
+	AShooterNPC* NPC = SpawnPooledNPC(Key, SpawnTransform);
+
+	if (NPC)
+	{
+		// the bucket may have been reallocated while spawning
+		FPoolBucket& Bucket = Buckets.FindChecked(Key);
+		Bucket.NumSpawned++;
+		Bucket.SpawnSeconds += FPlatformTime::Seconds() - StartTime;
+		Bucket.NumActive++;
+		Bucket.PeakActive = FMath::Max(Bucket.PeakActive, Bucket.NumActive);
+	}
+
+	return NPC;
+}
+
+void UShooterNPCPoolSubsystem::ReleaseNPC(AShooterNPC* NPC)
+{
+	if (!IsValid(NPC))
+	{
+		return;
+	}
+
+	// characters that weren't acquired from the pool are simply destroyed
+	if (!NPC->IsPooled())
+	{
+		UE_LOG(LogGrimRailDemo, Warning, TEXT("ShooterNPCPoolSubsystem: %s was not spawned by the pool, destroying it instead"), *GetNameSafe(NPC));
+		NPC->Destroy();
+		return;
+	}
+
+	// dead NPCs already paused their controller from the death event
+	if (!NPC->IsDead())
+	{
+		if (AShooterAIController* AIC = Cast<AShooterAIController>(NPC->GetController()))
+		{
+			AIC->PauseForPool();
+		}
+	}
+
+	NPC->DeactivateForPool();
+
+	FPoolBucket& Bucket = Buckets.FindOrAdd(MakeKey(NPC->GetClass(), NPC->GetWeaponClass()));
+	Bucket.Inactive.AddUnique(NPC);
+	Bucket.NumActive = FMath::Max(0, Bucket.NumActive - 1);
+}
+
+void UShooterNPCPoolSubsystem::Prewarm(TSubclassOf<AShooterNPC> NPCClass, TSubclassOf<AShooterWeapon> WeaponClass, int32 Count)
+{
+	if (!NPCClass)
+	{
+		return;
+	}
+
+	const FPoolKey Key = MakeKey(NPCClass, WeaponClass);
+	const int32 NumToSpawn = Count - Buckets.FindOrAdd(Key).Inactive.Num();
+
+	for (int32 i = 0; i < NumToSpawn; ++i)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		if (AShooterNPC* NPC = SpawnPooledNPC(Key, FTransform::Identity))
+		{
+			// pause the freshly started AI and park the character right away
+			if (AShooterAIController* AIC = Cast<AShooterAIController>(NPC->GetController()))
+			{
+				AIC->PauseForPool();
+			}
+
+			NPC->DeactivateForPool();
+
+			FPoolBucket& Bucket = Buckets.FindChecked(Key);
+			Bucket.Inactive.Add(NPC);
+			Bucket.NumSpawned++;
+			Bucket.SpawnSeconds += FPlatformTime::Seconds() - StartTime;
+		}
+	}
+}
+
+void UShooterNPCPoolSubsystem::LogReport() const
+{
+	UE_LOG(LogGrimRailDemo, Log, TEXT("ShooterNPCPoolSubsystem: %d pool buckets"), Buckets.Num());
+
+	for (const TPair<FPoolKey, FPoolBucket>& Pair : Buckets)
+	{
+		const FPoolBucket& Bucket = Pair.Value;
+
+		const double AvgSpawnMs = Bucket.NumSpawned > 0 ? Bucket.SpawnSeconds * 1000.0 / Bucket.NumSpawned : 0.0;
+		const double AvgReuseMs = Bucket.NumReused > 0 ? Bucket.ReuseSeconds * 1000.0 / Bucket.NumReused : 0.0;
+
+		UE_LOG(LogGrimRailDemo, Log, TEXT("  %s + %s: active %d (peak %d), inactive %d, spawned %d (avg %.3f ms), reused %d (avg %.3f ms)"),
+			*GetNameSafe(Pair.Key.NPCClass),
+			*GetNameSafe(Pair.Key.WeaponClass),
+			Bucket.NumActive,
+			Bucket.PeakActive,
+			Bucket.Inactive.Num(),
+			Bucket.NumSpawned,
+			AvgSpawnMs,
+			Bucket.NumReused,
+			AvgReuseMs);
+	}
+}
+
+UShooterNPCPoolSubsystem::FPoolKey UShooterNPCPoolSubsystem::MakeKey(TSubclassOf<AShooterNPC> NPCClass, TSubclassOf<AShooterWeapon> WeaponClass)
+{
+	FPoolKey Key;
+	Key.NPCClass = NPCClass;
+
+	// fall back to the weapon the NPC would spawn on its own
+	Key.WeaponClass = WeaponClass ? WeaponClass.Get() : (NPCClass ? NPCClass->GetDefaultObject<AShooterNPC>()->GetWeaponClass().Get() : nullptr);
+
+	return Key;
+}
+
+AShooterNPC* UShooterNPCPoolSubsystem::SpawnPooledNPC(const FPoolKey& Key, const FTransform& SpawnTransform)
+{
+	LLM_SCOPE_BYTAG(GrimRail_NPCs);
+
+	// defer the spawn so the weapon class is set before BeginPlay spawns the weapon
+	AShooterNPC* NPC = GetWorld()->SpawnActorDeferred<AShooterNPC>(Key.NPCClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+
+	if (!NPC)
+	{
+		UE_LOG(LogGrimRailDemo, Warning, TEXT("ShooterNPCPoolSubsystem: Failed to spawn %s"), *GetNameSafe(Key.NPCClass));
+		return nullptr;
+	}
+
+	NPC->SetWeaponClass(Key.WeaponClass);
+	NPC->SetPooled(true);
+	NPC->FinishSpawning(SpawnTransform);
+
+	// make sure the NPC is possessed even if it doesn't auto possess on spawn
+	if (!NPC->GetController())
+	{
+		NPC->SpawnDefaultController();
+	}
+
+	// keep the bucket around so the spawn is tracked
+	Buckets.FindOrAdd(Key);
+
+	return NPC;
+}
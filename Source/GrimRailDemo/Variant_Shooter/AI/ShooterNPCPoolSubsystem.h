@@ -0,0 +1,131 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterNPCPoolSubsystem.generated.h"
+
+class AShooterNPC;
+class AShooterWeapon;
+
+/**
+ *  Number of NPCs to spawn into the pool when the world begins play
+ */
+USTRUCT()
+struct FShooterNPCPoolPrewarm
+{
+	GENERATED_BODY()
+
+	/** NPC class to pre-warm */
+	UPROPERTY(EditAnywhere, Category="Pool")
+	TSoftClassPtr<AShooterNPC> NPCClass;
+
+	/** Weapon class the NPCs are spawned with. Uses the NPC's default weapon if unset */
+	UPROPERTY(EditAnywhere, Category="Pool")
+	TSoftClassPtr<AShooterWeapon> WeaponClass;
+
+	/** Number of NPCs to spawn */
+	UPROPERTY(EditAnywhere, Category="Pool", meta = (ClampMin = 0))
+	int32 Count = 0;
+};
+
+/**
+ *  Pools NPC, weapon and AI controller stacks for wave based shooter modes
+ *  Dead pooled NPCs are deactivated instead of destroyed, and reused with fresh HP, team tags and StateTree state
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UShooterNPCPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Identifies a bucket of interchangeable NPCs */
+	struct FPoolKey
+	{
+		UClass* NPCClass = nullptr;
+		UClass* WeaponClass = nullptr;
+
+		bool operator==(const FPoolKey& Other) const { return NPCClass == Other.NPCClass && WeaponClass == Other.WeaponClass; }
+		friend uint32 GetTypeHash(const FPoolKey& Key) { return HashCombine(GetTypeHash(Key.NPCClass), GetTypeHash(Key.WeaponClass)); }
+	};
+
+	/** Inactive NPCs and spawn-cost metrics for a single NPC and weapon class pair */
+	struct FPoolBucket
+	{
+		/** NPCs waiting to be reused */
+		TArray<TWeakObjectPtr<AShooterNPC>> Inactive;
+
+		/** Number of NPCs currently handed out */
+		int32 NumActive = 0;
+
+		/** Highest number of NPCs handed out at once */
+		int32 PeakActive = 0;
+
+		/** Number of NPCs that had to be spawned */
+		int32 NumSpawned = 0;
+
+		/** Number of NPCs that were reused from the pool */
+		int32 NumReused = 0;
+
+		/** Total time spent spawning NPCs */
+		double SpawnSeconds = 0.0;
+
+		/** Total time spent reactivating pooled NPCs */
+		double ReuseSeconds = 0.0;
+	};
+
+	/** Pool buckets by NPC and weapon class */
+	TMap<FPoolKey, FPoolBucket> Buckets;
+
+	/** NPCs to spawn into the pool when the world begins play */
+	UPROPERTY(Config, EditAnywhere, Category="Pool")
+	TArray<FShooterNPCPoolPrewarm> PrewarmCounts;
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	//~End UWorldSubsystem Interface
+
+public:
+
+	/**
+	 * Returns an active NPC, reusing a pooled one if available
+	 * @param NPCClass Type of NPC to get
+	 * @param SpawnTransform Where to place the NPC
+	 * @param WeaponClass Weapon the NPC should hold. Uses the NPC's default weapon if unset
+	 * @return The active NPC, or nullptr if it couldn't be spawned
+	 */
+	UFUNCTION(BlueprintCallable, Category="Shooter|Pool")
+	AShooterNPC* AcquireNPC(TSubclassOf<AShooterNPC> NPCClass, const FTransform& SpawnTransform, TSubclassOf<AShooterWeapon> WeaponClass = nullptr);
+
+	/**
+	 * Deactivates a pooled NPC and makes it available for reuse
+	 * @param NPC The NPC to return. Must have been acquired from this pool
+	 */
+	UFUNCTION(BlueprintCallable, Category="Shooter|Pool")
+	void ReleaseNPC(AShooterNPC* NPC);
+
+	/**
+	 * Spawns inactive NPCs ahead of time so later acquisitions don't pay the spawn cost
+	 * @param NPCClass Type of NPC to spawn
+	 * @param WeaponClass Weapon the NPCs should hold. Uses the NPC's default weapon if unset
+	 * @param Count Number of inactive NPCs the pool should hold for this class pair
+	 */
+	UFUNCTION(BlueprintCallable, Category="Shooter|Pool")
+	void Prewarm(TSubclassOf<AShooterNPC> NPCClass, TSubclassOf<AShooterWeapon> WeaponClass, int32 Count);
+
+	/** Logs pool sizes and spawn cost metrics for every bucket */
+	void LogReport() const;
+
+protected:
+
+	/** Builds the bucket key for the given classes, resolving the default weapon class */
+	static FPoolKey MakeKey(TSubclassOf<AShooterNPC> NPCClass, TSubclassOf<AShooterWeapon> WeaponClass);
+
+	/** Spawns a new pooled NPC along with its weapon and controller */
+	AShooterNPC* SpawnPooledNPC(const FPoolKey& Key, const FTransform& SpawnTransform);
+};
@@ -9,6 +9,7 @@
 #include "Perception/AIPerceptionComponent.h"
 #include "ShooterAIController.h"
 #include "StateTreeAsyncExecutionContext.h"
+#include "GrimRailRandomSubsystem.h"
 
 bool FStateTreeLineOfSightToTargetCondition::TestCondition(FStateTreeExecutionContext& Context) const
 {
@@ -160,8 +161,8 @@ EStateTreeRunStatus FStateTreeSetRandomFloatTask::EnterState(FStateTreeExecution
 		// get the instance data
 		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
-		// calculate the output value
-		InstanceData.OutValue = FMath::RandRange(InstanceData.MinValue, InstanceData.MaxValue);
+		// calculate the output value from the AI decision stream
+		InstanceData.OutValue = UGrimRailRandomSubsystem::GetStream(Context.GetWorld(), EGrimRailRandomStream::AIDecision).FRandRange(InstanceData.MinValue, InstanceData.MaxValue);
 	}
 
 	return EStateTreeRunStatus::Running;
@@ -12,6 +12,9 @@
 #include "Camera/CameraComponent.h"
 #include "TimerManager.h"
 #include "ShooterGameMode.h"
+#include "Net/UnrealNetwork.h"
+#include "CharacterStatSubsystem.h"
+#include "GrimRailMemorySubsystem.h"
 
 AShooterCharacter::AShooterCharacter()
 {
@@ -29,6 +32,12 @@ void AShooterCharacter::BeginPlay()
 	// reset HP to max
 	CurrentHP = MaxHP;
 
+	// health is held by the character stat subsystem
+	if (UCharacterStatSubsystem* CharacterStats = GetWorld()->GetSubsystem<UCharacterStatSubsystem>())
+	{
+		HealthID = CharacterStats->RegisterHealth(MaxHP, CurrentHP);
+	}
+
 	// update the HUD
 	OnDamaged.Broadcast(1.0f);
 }
@@ -39,6 +48,14 @@ void AShooterCharacter::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the respawn timer
 	GetWorld()->GetTimerManager().ClearTimer(RespawnTimer);
+
+	// release the health value
+	if (UCharacterStatSubsystem* CharacterStats = GetWorld()->GetSubsystem<UCharacterStatSubsystem>())
+	{
+		CharacterStats->UnregisterHealth(HealthID);
+	}
+
+	HealthID = INDEX_NONE;
 }
 
 void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -59,16 +76,34 @@ void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 
 }
 
+void AShooterCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AShooterCharacter, CurrentHP);
+	DOREPLIFETIME(AShooterCharacter, CurrentWeapon);
+
+	// only the owning player needs the full inventory to switch weapons
+	DOREPLIFETIME_CONDITION(AShooterCharacter, OwnedWeapons, COND_OwnerOnly);
+}
+
 float AShooterCharacter::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-	// ignore if already dead
-	if (CurrentHP <= 0.0f)
+	// damage is server authoritative. Ignore if already dead
+	if (!HasAuthority() || CurrentHP <= 0.0f)
 	{
 		return 0.0f;
 	}
 
-	// Reduce HP
-	CurrentHP -= Damage;
+	// Reduce HP, then mirror it for replication
+	if (UCharacterStatSubsystem* CharacterStats = GetWorld()->GetSubsystem<UCharacterStatSubsystem>())
+	{
+		CurrentHP = CharacterStats->ApplyDamage(HealthID, Damage);
+	}
+	else
+	{
+		CurrentHP -= Damage;
+	}
 
 	// Have we depleted HP?
 	if (CurrentHP <= 0.0f)
@@ -102,6 +137,13 @@ void AShooterCharacter::DoStopFiring()
 
 void AShooterCharacter::DoSwitchWeapon()
 {
+	// weapon switching is server authoritative
+	if (!HasAuthority())
+	{
+		ServerSwitchWeapon();
+		return;
+	}
+
 	// ensure we have at least two weapons two switch between
 	if (OwnedWeapons.Num() > 1)
 	{
@@ -130,6 +172,12 @@ void AShooterCharacter::DoSwitchWeapon()
 	}
 }
 
+bool AShooterCharacter::UsesFirstPersonWeaponMesh() const
+{
+	// any player may be possessed locally, so keep the first person mesh around
+	return true;
+}
+
 void AShooterCharacter::AttachWeaponMeshes(AShooterWeapon* Weapon)
 {
 	const FAttachmentTransformRules AttachmentRule(EAttachmentRule::SnapToTarget, false);
@@ -183,6 +231,8 @@ void AShooterCharacter::AddWeaponClass(const TSubclassOf<AShooterWeapon>& Weapon
 
 	if (!OwnedWeapon)
 	{
+		LLM_SCOPE_BYTAG(GrimRail_Weapons);
+
 		// spawn the new weapon
 		FActorSpawnParameters SpawnParams;
 		SpawnParams.Owner = this;
@@ -215,7 +265,8 @@ void AShooterCharacter::OnWeaponActivated(AShooterWeapon* Weapon)
 	// update the bullet counter
 	OnBulletCountUpdated.Broadcast(Weapon->GetMagazineSize(), Weapon->GetBulletCount());
 
-	// set the character mesh AnimInstances
+	// set the character mesh AnimInstances. Weapons sharing an anim class keep the running instance,
+	// SetAnimInstanceClass only rebuilds it when the class actually changes
 	GetFirstPersonMesh()->SetAnimInstanceClass(Weapon->GetFirstPersonAnimInstanceClass());
 	GetMesh()->SetAnimInstanceClass(Weapon->GetThirdPersonAnimInstanceClass());
 }
@@ -230,6 +281,45 @@ void AShooterCharacter::OnSemiWeaponRefire()
 	// unused
 }
 
+void AShooterCharacter::ServerSwitchWeapon_Implementation()
+{
+	DoSwitchWeapon();
+}
+
+void AShooterCharacter::OnRep_CurrentHP()
+{
+	// keep the local stat subsystem in sync with the server
+	if (UCharacterStatSubsystem* CharacterStats = GetWorld()->GetSubsystem<UCharacterStatSubsystem>())
+	{
+		CharacterStats->SetHealth(HealthID, CurrentHP);
+	}
+
+	// update the HUD
+	OnDamaged.Broadcast(FMath::Max(0.0f, CurrentHP / MaxHP));
+
+	// the server runs the rest of the death logic, clients only need the local effects
+	if (CurrentHP <= 0.0f)
+	{
+		// disable controls
+		DisableInput(nullptr);
+
+		// reset the bullet counter UI
+		OnBulletCountUpdated.Broadcast(0, 0);
+
+		// call the BP handler
+		BP_OnDeath();
+	}
+}
+
+void AShooterCharacter::OnRep_CurrentWeapon()
+{
+	// update the HUD and anim instances for the new weapon
+	if (CurrentWeapon)
+	{
+		OnWeaponActivated(CurrentWeapon);
+	}
+}
+
 AShooterWeapon* AShooterCharacter::FindWeaponOfType(TSubclassOf<AShooterWeapon> WeaponClass) const
 {
 	// check each owned weapon
@@ -55,17 +55,23 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Health")
 	float MaxHP = 500.0f;
 
-	/** Current HP remaining to this character */
+	/** Current HP remaining to this character. Replicated mirror of the value held by the character stat subsystem */
+	UPROPERTY(ReplicatedUsing=OnRep_CurrentHP)
 	float CurrentHP = 0.0f;
 
+	/** Health ID in the character stat subsystem */
+	int32 HealthID = INDEX_NONE;
+
 	/** Team ID for this character*/
 	UPROPERTY(EditAnywhere, Category="Team")
 	uint8 TeamByte = 0;
 
 	/** List of weapons picked up by the character */
+	UPROPERTY(Replicated)
 	TArray<AShooterWeapon*> OwnedWeapons;
 
 	/** Weapon currently equipped and ready to shoot with */
+	UPROPERTY(ReplicatedUsing=OnRep_CurrentWeapon)
 	TObjectPtr<AShooterWeapon> CurrentWeapon;
 
 	UPROPERTY(EditAnywhere, Category ="Destruction", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
@@ -99,6 +105,9 @@ protected:
 
 public:
 
+	/** Sets up replicated properties */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	/** Handle incoming damage */
 	virtual float TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
@@ -120,6 +129,9 @@ public:
 
 	//~Begin IShooterWeaponHolder interface
 
+	/** Returns true if the owner is ever seen in first person and needs the weapon's first person mesh */
+	virtual bool UsesFirstPersonWeaponMesh() const override;
+
 	/** Attaches a weapon's meshes to the owner */
 	virtual void AttachWeaponMeshes(AShooterWeapon* Weapon) override;
 
@@ -151,6 +163,18 @@ public:
 
 protected:
 
+	/** Switches to the next owned weapon on the server */
+	UFUNCTION(Server, Reliable)
+	void ServerSwitchWeapon();
+
+	/** Updates the HUD and plays death effects on clients when HP changes */
+	UFUNCTION()
+	void OnRep_CurrentHP();
+
+	/** Sets up the newly equipped weapon on clients */
+	UFUNCTION()
+	void OnRep_CurrentWeapon();
+
 	/** Returns true if the character already owns a weapon of the given class */
 	AShooterWeapon* FindWeaponOfType(TSubclassOf<AShooterWeapon> WeaponClass) const;
 
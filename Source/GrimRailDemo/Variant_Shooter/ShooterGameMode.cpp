@@ -2,32 +2,19 @@
 
 
 #include "Variant_Shooter/ShooterGameMode.h"
-#include "ShooterUI.h"
-#include "Kismet/GameplayStatics.h"
-#include "Engine/World.h"
+#include "ShooterGameState.h"
 
-void AShooterGameMode::BeginPlay()
+AShooterGameMode::AShooterGameMode()
 {
-	Super::BeginPlay();
-
-	// create the UI
-	ShooterUI = CreateWidget<UShooterUI>(UGameplayStatics::GetPlayerController(GetWorld(), 0), ShooterUIClass);
-	ShooterUI->AddToViewport(0);
+	// use the shooter game state so team scores replicate
+	GameStateClass = AShooterGameState::StaticClass();
 }
 
 void AShooterGameMode::IncrementTeamScore(uint8 TeamByte)
 {
-	// retrieve the team score if any
-	int32 Score = 0;
-	if (int32* FoundScore = TeamScores.Find(TeamByte))
+	// the game state owns the scores and replicates them to clients
+	if (AShooterGameState* ShooterGameState = GetGameState<AShooterGameState>())
 	{
-		Score = *FoundScore;
+		ShooterGameState->IncrementTeamScore(TeamByte);
 	}
-
-	// increment the score for the given team
-	++Score;
-	TeamScores.Add(TeamByte, Score);
-
-	// update the UI
-	ShooterUI->BP_UpdateScore(TeamByte, Score);
 }
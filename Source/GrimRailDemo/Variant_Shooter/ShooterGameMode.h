@@ -10,8 +10,8 @@ class UShooterUI;
 
 /**
  *  Simple GameMode for a first person shooter game
- *  Manages game UI
- *  Keeps track of team scores
+ *  Provides the scoreboard UI class to local players
+ *  Keeps track of team scores through the ShooterGameState
  */
 UCLASS(abstract)
 class GRIMRAILDEMO_API AShooterGameMode : public AGameModeBase
@@ -20,23 +20,18 @@ class GRIMRAILDEMO_API AShooterGameMode : public AGameModeBase
 	
 protected:
 
-	/** Type of UI widget to spawn */
+	/** Type of UI widget to spawn. Local player controllers read this from the GameMode CDO so it also works on clients */
 	UPROPERTY(EditAnywhere, Category="Shooter")
 	TSubclassOf<UShooterUI> ShooterUIClass;
 
-	/** Pointer to the UI widget */
-	TObjectPtr<UShooterUI> ShooterUI;
-
-	/** Map of scores by team ID */
-	TMap<uint8, int32> TeamScores;
-
-protected:
-
-	/** Gameplay initialization */
-	virtual void BeginPlay() override;
-
 public:
 
+	/** Constructor */
+	AShooterGameMode();
+
 	/** Increases the score for the given team */
 	void IncrementTeamScore(uint8 TeamByte);
+
+	/** Returns the type of scoreboard UI widget to spawn */
+	TSubclassOf<UShooterUI> GetShooterUIClass() const { return ShooterUIClass; }
 };
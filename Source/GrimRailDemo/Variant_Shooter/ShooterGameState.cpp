@@ -0,0 +1,60 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/ShooterGameState.h"
+#include "Net/UnrealNetwork.h"
+
+void AShooterGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AShooterGameState, TeamScores);
+}
+
+void AShooterGameState::IncrementTeamScore(uint8 TeamByte)
+{
+	// find the team entry, adding it if this is the team's first score
+	FShooterTeamScore* TeamScore = TeamScores.FindByPredicate([TeamByte](const FShooterTeamScore& Entry)
+	{
+		return Entry.TeamByte == TeamByte;
+	});
+
+	if (!TeamScore)
+	{
+		TeamScore = &TeamScores.AddDefaulted_GetRef();
+		TeamScore->TeamByte = TeamByte;
+	}
+
+	// increment the score
+	++TeamScore->Score;
+
+	// rep notifies don't run on the server, so notify local listeners directly
+	OnTeamScoreChanged.Broadcast(TeamByte, TeamScore->Score);
+}
+
+int32 AShooterGameState::GetTeamScore(uint8 TeamByte) const
+{
+	const FShooterTeamScore* TeamScore = TeamScores.FindByPredicate([TeamByte](const FShooterTeamScore& Entry)
+	{
+		return Entry.TeamByte == TeamByte;
+	});
+
+	return TeamScore ? TeamScore->Score : 0;
+}
+
+void AShooterGameState::OnRep_TeamScores(const TArray<FShooterTeamScore>& OldTeamScores)
+{
+	// only notify the teams whose score actually changed
+	for (const FShooterTeamScore& TeamScore : TeamScores)
+	{
+		const FShooterTeamScore* OldScore = OldTeamScores.FindByPredicate([&TeamScore](const FShooterTeamScore& Entry)
+		{
+			return Entry.TeamByte == TeamScore.TeamByte;
+		});
+
+		if (!OldScore || OldScore->Score != TeamScore.Score)
+		{
+			OnTeamScoreChanged.Broadcast(TeamScore.TeamByte, TeamScore.Score);
+		}
+	}
+}
@@ -0,0 +1,67 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameStateBase.h"
+#include "ShooterGameState.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FTeamScoreChangedDelegate, uint8, TeamByte, int32, Score);
+
+/**
+ *  Score for a single team
+ */
+USTRUCT()
+struct FShooterTeamScore
+{
+	GENERATED_BODY()
+
+	/** Team ID */
+	UPROPERTY()
+	uint8 TeamByte = 0;
+
+	/** Current score */
+	UPROPERTY()
+	int32 Score = 0;
+};
+
+/**
+ *  GameState for a first person shooter game
+ *  Replicates team scores to all clients
+ */
+UCLASS()
+class GRIMRAILDEMO_API AShooterGameState : public AGameStateBase
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Scores by team. Only teams that scored at least once are listed */
+	UPROPERTY(ReplicatedUsing=OnRep_TeamScores)
+	TArray<FShooterTeamScore> TeamScores;
+
+public:
+
+	/** Delegate called when a team's score changes, on both the server and clients */
+	FTeamScoreChangedDelegate OnTeamScoreChanged;
+
+public:
+
+	/** Sets up replicated properties */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Increases the score for the given team. Server only */
+	void IncrementTeamScore(uint8 TeamByte);
+
+	/** Returns the score for the given team */
+	int32 GetTeamScore(uint8 TeamByte) const;
+
+	/** Returns the scores for all teams that scored so far */
+	const TArray<FShooterTeamScore>& GetTeamScores() const { return TeamScores; }
+
+protected:
+
+	/** Notifies listeners of the team scores that changed */
+	UFUNCTION()
+	void OnRep_TeamScores(const TArray<FShooterTeamScore>& OldTeamScores);
+};
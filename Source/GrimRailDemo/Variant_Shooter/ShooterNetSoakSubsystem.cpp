@@ -0,0 +1,146 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/ShooterNetSoakSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Parse.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformMisc.h"
+#include "GrimRailDemo.h"
+
+bool UShooterNetSoakSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && FParse::Param(FCommandLine::Get(), TEXT("GrimRailSoak"));
+}
+
+void UShooterNetSoakSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// optional run time for unattended soaks
+	FParse::Value(FCommandLine::Get(), TEXT("GrimRailSoakDuration="), SoakDuration);
+
+	// measure the game thread work per frame. Frame delta alone is useless on a server capped by its tick rate
+	BeginFrameHandle = FCoreDelegates::OnBeginFrame.AddUObject(this, &UShooterNetSoakSubsystem::OnBeginFrame);
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UShooterNetSoakSubsystem::OnEndFrame);
+
+	UE_LOG(LogGrimRailDemo, Display, TEXT("ShooterNetSoak: Started, reporting every %.0fs%s"), ReportInterval, SoakDuration > 0.0f ? *FString::Printf(TEXT(" for %.0fs"), SoakDuration) : TEXT(""));
+}
+
+void UShooterNetSoakSubsystem::Deinitialize()
+{
+	FCoreDelegates::OnBeginFrame.Remove(BeginFrameHandle);
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+	ReportSummary();
+
+	Super::Deinitialize();
+}
+
+void UShooterNetSoakSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	ElapsedTime += DeltaTime;
+	TimeSinceReport += DeltaTime;
+
+	// integrate the per second bandwidth stats into totals
+	if (const UNetDriver* NetDriver = GetWorld()->GetNetDriver())
+	{
+		TotalOutBytes += NetDriver->OutBytesPerSecond * DeltaTime;
+		TotalInBytes += NetDriver->InBytesPerSecond * DeltaTime;
+		PeakConnections = FMath::Max(PeakConnections, NetDriver->ClientConnections.Num());
+	}
+
+	if (TimeSinceReport >= ReportInterval)
+	{
+		Report();
+	}
+
+	// quit once the soak has run its course
+	if (SoakDuration > 0.0f && ElapsedTime >= SoakDuration && !bSummaryReported)
+	{
+		ReportSummary();
+		FPlatformMisc::RequestExitWithStatus(false, 0);
+	}
+}
+
+TStatId UShooterNetSoakSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterNetSoakSubsystem, STATGROUP_Tickables);
+}
+
+bool UShooterNetSoakSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterNetSoakSubsystem::OnBeginFrame()
+{
+	FrameStartTime = FPlatformTime::Seconds();
+}
+
+void UShooterNetSoakSubsystem::OnEndFrame()
+{
+	if (FrameStartTime <= 0.0)
+	{
+		return;
+	}
+
+	const double FrameSeconds = FPlatformTime::Seconds() - FrameStartTime;
+
+	WindowFrameSeconds += FrameSeconds;
+	WindowMaxFrameSeconds = FMath::Max(WindowMaxFrameSeconds, FrameSeconds);
+	++WindowFrames;
+
+	TotalFrameSeconds += FrameSeconds;
+	TotalMaxFrameSeconds = FMath::Max(TotalMaxFrameSeconds, FrameSeconds);
+	++TotalFrames;
+}
+
+void UShooterNetSoakSubsystem::Report()
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	const int32 NumConnections = NetDriver ? NetDriver->ClientConnections.Num() : 0;
+	const float OutKBps = NetDriver ? NetDriver->OutBytesPerSecond / 1024.0f : 0.0f;
+	const float InKBps = NetDriver ? NetDriver->InBytesPerSecond / 1024.0f : 0.0f;
+
+	UE_LOG(LogGrimRailDemo, Display, TEXT("ShooterNetSoak: [%s %.0fs] %d connections, frame avg %.2f ms max %.2f ms, out %.1f KB/s (%.1f KB/s per client), in %.1f KB/s"),
+		GetWorld()->GetNetMode() == NM_Client ? TEXT("client") : TEXT("server"),
+		ElapsedTime,
+		NumConnections,
+		WindowFrames > 0 ? WindowFrameSeconds * 1000.0 / WindowFrames : 0.0,
+		WindowMaxFrameSeconds * 1000.0,
+		OutKBps,
+		NumConnections > 0 ? OutKBps / NumConnections : 0.0f,
+		InKBps);
+
+	// reset the report window
+	TimeSinceReport = 0.0f;
+	WindowFrameSeconds = 0.0;
+	WindowMaxFrameSeconds = 0.0;
+	WindowFrames = 0;
+}
+
+void UShooterNetSoakSubsystem::ReportSummary()
+{
+	if (bSummaryReported || TotalFrames == 0)
+	{
+		return;
+	}
+
+	bSummaryReported = true;
+
+	const double Seconds = FMath::Max(static_cast<double>(ElapsedTime), UE_DOUBLE_SMALL_NUMBER);
+
+	UE_LOG(LogGrimRailDemo, Display, TEXT("ShooterNetSoak: Summary over %.0fs, peak %d connections, frame avg %.2f ms max %.2f ms, out avg %.1f KB/s, in avg %.1f KB/s"),
+		ElapsedTime,
+		PeakConnections,
+		TotalFrameSeconds * 1000.0 / TotalFrames,
+		TotalMaxFrameSeconds * 1000.0,
+		TotalOutBytes / 1024.0 / Seconds,
+		TotalInBytes / 1024.0 / Seconds);
+}
@@ -0,0 +1,88 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterNetSoakSubsystem.generated.h"
+
+/**
+ *  Network soak test reporter for the shooter variant
+ *  Only created when the game runs with -GrimRailSoak, e.g. a dedicated server plus a few
+ *  -nullrhi clients connected over loopback. Periodically logs bandwidth and game thread frame time,
+ *  and quits with a summary after -GrimRailSoakDuration=<seconds> if given
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UShooterNetSoakSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Time between periodic reports */
+	UPROPERTY(Config, EditAnywhere, Category="Soak", meta = (ClampMin = 1, Units = "s"))
+	float ReportInterval = 5.0f;
+
+	/** Time to run before quitting. Zero runs until closed */
+	float SoakDuration = 0.0f;
+
+	/** Time since the soak started */
+	float ElapsedTime = 0.0f;
+
+	/** Time accumulated since the last report */
+	float TimeSinceReport = 0.0f;
+
+	/** Time the game thread started working on the current frame, after any tick rate idle */
+	double FrameStartTime = 0.0;
+
+	/** Frame time stats for the current report window */
+	double WindowFrameSeconds = 0.0;
+	double WindowMaxFrameSeconds = 0.0;
+	int32 WindowFrames = 0;
+
+	/** Frame time and bandwidth stats for the whole soak */
+	double TotalFrameSeconds = 0.0;
+	double TotalMaxFrameSeconds = 0.0;
+	int64 TotalFrames = 0;
+	double TotalOutBytes = 0.0;
+	double TotalInBytes = 0.0;
+	int32 PeakConnections = 0;
+
+	/** True once the summary was logged */
+	bool bSummaryReported = false;
+
+	/** Frame delegate handles */
+	FDelegateHandle BeginFrameHandle;
+	FDelegateHandle EndFrameHandle;
+
+public:
+
+	//~Begin USubsystem Interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem Interface
+
+	//~Begin UTickableWorldSubsystem Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End UTickableWorldSubsystem Interface
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem Interface
+
+	/** Marks the start of the game thread work for this frame */
+	void OnBeginFrame();
+
+	/** Accumulates the game thread work time for this frame */
+	void OnEndFrame();
+
+	/** Logs the stats for the current report window and resets it */
+	void Report();
+
+	/** Logs the stats for the whole soak */
+	void ReportSummary();
+};
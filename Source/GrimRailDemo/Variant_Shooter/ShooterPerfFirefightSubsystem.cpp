@@ -0,0 +1,97 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/ShooterPerfFirefightSubsystem.h"
+#include "GrimRailPerfCaptureSubsystem.h"
+#include "ShooterNPC.h"
+#include "ShooterNPCPoolSubsystem.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+
+bool UShooterPerfFirefightSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && UGrimRailPerfCaptureSubsystem::IsCapturing();
+}
+
+bool UShooterPerfFirefightSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterPerfFirefightSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TimeSinceRetarget += DeltaTime;
+
+	if (TimeSinceRetarget >= RetargetInterval)
+	{
+		TimeSinceRetarget = 0.0f;
+		UpdateFirefight();
+	}
+}
+
+TStatId UShooterPerfFirefightSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterPerfFirefightSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterPerfFirefightSubsystem::UpdateFirefight()
+{
+	// the first time around, everyone placed in the map joins the fight
+	if (!FighterClass)
+	{
+		for (TActorIterator<AShooterNPC> It(GetWorld()); It; ++It)
+		{
+			if (!It->IsDead())
+			{
+				Fighters.Add(*It);
+			}
+		}
+
+		// not a shooter map
+		if (Fighters.Num() == 0)
+		{
+			return;
+		}
+
+		FighterClass = Fighters[0]->GetClass();
+		FightCenter = Fighters[0]->GetActorLocation();
+	}
+
+	// forget the fallen
+	Fighters.RemoveAll([](const TWeakObjectPtr<AShooterNPC>& Fighter)
+	{
+		return !Fighter.IsValid() || Fighter->IsDead() || Fighter->IsHidden();
+	});
+
+	// top the fight up from the pool
+	if (UShooterNPCPoolSubsystem* Pool = GetWorld()->GetSubsystem<UShooterNPCPoolSubsystem>())
+	{
+		while (Fighters.Num() < FirefightSize)
+		{
+			const FVector2D Offset = FVector2D(Random.GetUnitVector()).GetSafeNormal() * Random.FRandRange(0.0f, SpawnRadius);
+			const FTransform SpawnTransform(FRotator(0.0f, Random.FRandRange(0.0f, 360.0f), 0.0f), FightCenter + FVector(Offset, 0.0f));
+
+			AShooterNPC* Fighter = Pool->AcquireNPC(FighterClass, SpawnTransform);
+
+			if (!Fighter)
+			{
+				break;
+			}
+
+			Fighters.Add(Fighter);
+		}
+	}
+
+	// everyone shoots the next one in the ring
+	if (Fighters.Num() < 2)
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < Fighters.Num(); ++Index)
+	{
+		Fighters[Index]->StartShooting(Fighters[(Index + 1) % Fighters.Num()].Get());
+	}
+}
@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Math/RandomStream.h"
+#include "ShooterPerfFirefightSubsystem.generated.h"
+
+class AShooterNPC;
+
+/**
+ *  Scripted NPC firefight for performance captures of the shooter map
+ *  Only created when the game runs with -GrimRailPerfCapture. Gathers the NPCs placed in the map, tops them up
+ *  from the NPC pool around the first one and has them shoot each other in a ring, so projectiles, deaths,
+ *  corpses and pool reuse all show up in the capture. Respawns fighters as they die
+ */
+UCLASS(config=Game)
+class GRIMRAILDEMO_API UShooterPerfFirefightSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Number of NPCs kept fighting */
+	UPROPERTY(Config, EditAnywhere, Category="Perf Capture", meta = (ClampMin = 2))
+	int32 FirefightSize = 16;
+
+	/** Distance from the first NPC that extra fighters are spawned within */
+	UPROPERTY(Config, EditAnywhere, Category="Perf Capture", meta = (ClampMin = 0, Units = "cm"))
+	float SpawnRadius = 1500.0f;
+
+	/** Time between topping up the fighters and handing out new targets */
+	UPROPERTY(Config, EditAnywhere, Category="Perf Capture", meta = (ClampMin = 0.1, Units = "s"))
+	float RetargetInterval = 2.0f;
+
+	/** Type of NPC spawned as extra fighters, taken from the first NPC found in the map */
+	TSubclassOf<AShooterNPC> FighterClass;
+
+	/** Where extra fighters are spawned around */
+	FVector FightCenter = FVector::ZeroVector;
+
+	/** NPCs currently fighting */
+	TArray<TWeakObjectPtr<AShooterNPC>> Fighters;
+
+	/** Fixed seed so every capture spawns the same fight */
+	FRandomStream Random = FRandomStream(0x66697265);
+
+	/** Time accumulated since the last retarget */
+	float TimeSinceRetarget = 0.0f;
+
+public:
+
+	//~Begin USubsystem Interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	//~End USubsystem Interface
+
+	//~Begin UTickableWorldSubsystem Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End UTickableWorldSubsystem Interface
+
+protected:
+
+	//~Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem Interface
+
+	/** Finds the placed NPCs the first time around, replaces dead fighters and hands out targets */
+	void UpdateFirefight();
+};
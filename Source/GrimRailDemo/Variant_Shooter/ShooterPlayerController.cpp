@@ -9,6 +9,11 @@
 #include "GameFramework/PlayerStart.h"
 #include "ShooterCharacter.h"
 #include "ShooterBulletCounterUI.h"
+#include "ShooterUI.h"
+#include "ShooterGameMode.h"
+#include "ShooterGameState.h"
+#include "GrimRailHUDModel.h"
+#include "TimerManager.h"
 #include "GrimRailDemo.h"
 #include "Widgets/Input/SVirtualJoystick.h"
 
@@ -48,7 +53,9 @@ void AShooterPlayerController::BeginPlay()
 			UE_LOG(LogGrimRailDemo, Error, TEXT("Could not spawn bullet counter widget."));
 
 		}
-		
+
+		// create the scoreboard
+		SetupScoreUI();
 	}
 }
 
@@ -90,19 +97,87 @@ void AShooterPlayerController::OnPossess(APawn* InPawn)
 		// add the player tag
 		ShooterCharacter->Tags.Add(PlayerPawnTag);
 
-		// subscribe to the pawn's delegates
-		ShooterCharacter->OnBulletCountUpdated.AddDynamic(this, &AShooterPlayerController::OnBulletCountUpdated);
-		ShooterCharacter->OnDamaged.AddDynamic(this, &AShooterPlayerController::OnPawnDamaged);
+		// remote players bind their HUD when the pawn replicates instead
+		if (IsLocalController())
+		{
+			BindPawnHUD(ShooterCharacter);
+		}
+	}
+}
 
-		// force update the life bar
-		ShooterCharacter->OnDamaged.Broadcast(1.0f);
+void AShooterPlayerController::OnRep_Pawn()
+{
+	Super::OnRep_Pawn();
+
+	if (AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(GetPawn()))
+	{
+		BindPawnHUD(ShooterCharacter);
+
+	} else {
+
+		// the pawn was destroyed, so reset the bullet counter HUD
+		GetHUDModel()->SetAmmo(0, 0);
+	}
+}
+
+void AShooterPlayerController::BindPawnHUD(AShooterCharacter* ShooterCharacter)
+{
+	// route the pawn's HUD delegates through the HUD model
+	UGrimRailHUDModel* Model = GetHUDModel();
+	ShooterCharacter->OnBulletCountUpdated.AddUniqueDynamic(Model, &UGrimRailHUDModel::SetAmmo);
+	ShooterCharacter->OnDamaged.AddUniqueDynamic(Model, &UGrimRailHUDModel::SetLifePercent);
+
+	// force update the life bar
+	ShooterCharacter->OnDamaged.Broadcast(1.0f);
+	Model->MarkAllDirty();
+}
+
+void AShooterPlayerController::SetupScoreUI()
+{
+	// the game state may not have replicated yet on clients, so try again next frame
+	AShooterGameState* ShooterGameState = GetWorld()->GetGameState<AShooterGameState>();
+
+	if (!ShooterGameState)
+	{
+		GetWorldTimerManager().SetTimerForNextTick(this, &AShooterPlayerController::SetupScoreUI);
+		return;
+	}
+
+	// read the UI class from the GameMode CDO, since the GameMode itself only exists on the server
+	const AShooterGameMode* DefaultGameMode = ShooterGameState->GetDefaultGameMode<AShooterGameMode>();
+
+	if (!DefaultGameMode || !DefaultGameMode->GetShooterUIClass())
+	{
+		UE_LOG(LogGrimRailDemo, Error, TEXT("Could not find the shooter UI class."));
+		return;
+	}
+
+	// create the UI
+	ShooterUI = CreateWidget<UShooterUI>(this, DefaultGameMode->GetShooterUIClass());
+	ShooterUI->AddToPlayerScreen(0);
+
+	// show the scores made so far and listen for changes
+	for (const FShooterTeamScore& TeamScore : ShooterGameState->GetTeamScores())
+	{
+		ShooterUI->BP_UpdateScore(TeamScore.TeamByte, TeamScore.Score);
+	}
+
+	ShooterGameState->OnTeamScoreChanged.AddDynamic(this, &AShooterPlayerController::OnTeamScoreChanged);
+}
+
+void AShooterPlayerController::OnTeamScoreChanged(uint8 TeamByte, int32 Score)
+{
+	// update the UI
+	if (ShooterUI)
+	{
+		ShooterUI->BP_UpdateScore(TeamByte, Score);
 	}
 }
 
 void AShooterPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 {
 	// reset the bullet counter HUD
-	BulletCounterUI->BP_UpdateBulletCounter(0, 0);
+	GetHUDModel()->SetAmmo(0, 0);
 
 	// find the player start
 	TArray<AActor*> ActorList;
@@ -124,6 +199,21 @@ void AShooterPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 	}
 }
 
+UGrimRailHUDModel* AShooterPlayerController::GetHUDModel()
+{
+	// create the model on first use, possession may happen before BeginPlay
+	if (!HUDModel)
+	{
+		HUDModel = NewObject<UGrimRailHUDModel>(this);
+
+		// push the flushed values to the UI
+		HUDModel->OnAmmoChanged.AddDynamic(this, &AShooterPlayerController::OnBulletCountUpdated);
+		HUDModel->OnLifePercentChanged.AddDynamic(this, &AShooterPlayerController::OnPawnDamaged);
+	}
+
+	return HUDModel;
+}
+
 void AShooterPlayerController::OnBulletCountUpdated(int32 MagazineSize, int32 Bullets)
 {
 	// update the UI
@@ -9,11 +9,14 @@
 class UInputMappingContext;
 class AShooterCharacter;
 class UShooterBulletCounterUI;
+class UShooterUI;
+class UGrimRailHUDModel;
 
 /**
  *  Simple PlayerController for a first person shooter game
  *  Manages input mappings
  *  Respawns the player pawn when it's destroyed
+ *  Creates the HUD and scoreboard for local players
  */
 UCLASS(abstract)
 class GRIMRAILDEMO_API AShooterPlayerController : public APlayerController
@@ -52,6 +55,13 @@ protected:
 	/** Pointer to the bullet counter UI widget */
 	TObjectPtr<UShooterBulletCounterUI> BulletCounterUI;
 
+	/** Pointer to the scoreboard UI widget */
+	TObjectPtr<UShooterUI> ShooterUI;
+
+	/** Coalesces ammo and damage updates from the pawn so the UI is refreshed at most once per frame */
+	UPROPERTY(Transient)
+	TObjectPtr<UGrimRailHUDModel> HUDModel;
+
 protected:
 
 	/** Gameplay Initialization */
@@ -63,15 +73,31 @@ protected:
 	/** Pawn initialization */
 	virtual void OnPossess(APawn* InPawn) override;
 
+	/** Binds the HUD on clients once the possessed pawn replicates */
+	virtual void OnRep_Pawn() override;
+
+	/** Routes the passed character's HUD delegates to the HUD model */
+	void BindPawnHUD(AShooterCharacter* ShooterCharacter);
+
+	/** Creates the scoreboard UI once the game state is available */
+	void SetupScoreUI();
+
+	/** Called when a team score changes on the game state */
+	UFUNCTION()
+	void OnTeamScoreChanged(uint8 TeamByte, int32 Score);
+
 	/** Called if the possessed pawn is destroyed */
 	UFUNCTION()
 	void OnPawnDestroyed(AActor* DestroyedActor);
 
-	/** Called when the bullet count on the possessed pawn is updated */
+	/** Returns the HUD model, creating it if needed */
+	UGrimRailHUDModel* GetHUDModel();
+
+	/** Called when the HUD model flushes a new bullet count */
 	UFUNCTION()
 	void OnBulletCountUpdated(int32 MagazineSize, int32 Bullets);
 
-	/** Called when the possessed pawn is damaged */
+	/** Called when the HUD model flushes a new life total */
 	UFUNCTION()
 	void OnPawnDamaged(float LifePercent);
 };
@@ -8,7 +8,9 @@
 #include "ShooterWeaponHolder.h"
 #include "ShooterWeapon.h"
 #include "Engine/World.h"
+#include "Engine/AssetManager.h"
 #include "TimerManager.h"
+#include "GrimRailSignificanceSubsystem.h"
 
 AShooterPickup::AShooterPickup()
 {
@@ -36,16 +38,50 @@ AShooterPickup::AShooterPickup()
 	Mesh->SetupAttachment(SphereCollision);
 
 	Mesh->SetCollisionProfileName(FName("NoCollision"));
+
+	// replicate so the hidden and collision state stays in sync with the server
+	bReplicates = true;
 }
 
 void AShooterPickup::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
 
-	if (FWeaponTableRow* WeaponData = WeaponType.GetRow<FWeaponTableRow>(FString()))
+	FWeaponTableRow* WeaponData = WeaponType.GetRow<FWeaponTableRow>(FString());
+
+	if (!WeaponData)
+	{
+		return;
+	}
+
+	// already loaded, e.g. saved with the level or preloaded at startup
+	if (UStaticMesh* LoadedMesh = WeaponData->StaticMesh.Get())
+	{
+		Mesh->SetStaticMesh(LoadedMesh);
+		return;
+	}
+
+	// the editor needs the mesh right away. In game, don't hitch on it
+	if (!GetWorld() || !GetWorld()->IsGameWorld())
 	{
-		// set the mesh
 		Mesh->SetStaticMesh(WeaponData->StaticMesh.LoadSynchronous());
+		return;
+	}
+
+	if (!WeaponData->StaticMesh.IsNull())
+	{
+		MeshLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(WeaponData->StaticMesh.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &AShooterPickup::OnMeshLoaded));
+	}
+}
+
+void AShooterPickup::OnMeshLoaded()
+{
+	// an older request may finish after a newer one was made
+	if (MeshLoadHandle.IsValid() && MeshLoadHandle->HasLoadCompleted())
+	{
+		// set the mesh
+		Mesh->SetStaticMesh(Cast<UStaticMesh>(MeshLoadHandle->GetLoadedAsset()));
+		MeshLoadHandle.Reset();
 	}
 }
 
@@ -58,6 +94,13 @@ void AShooterPickup::BeginPlay()
 		// copy the weapon class
 		WeaponClass = WeaponData->WeaponToSpawn;
 	}
+
+	// only tick while shown and near a player
+	if (UGrimRailSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UGrimRailSignificanceSubsystem>())
+	{
+		Significance->RegisterActor(this, TEXT("ShooterPickup"), true);
+		Significance->SetHasWork(this, true);
+	}
 }
 
 void AShooterPickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -66,10 +109,28 @@ void AShooterPickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	// clear the respawn timer
 	GetWorld()->GetTimerManager().ClearTimer(RespawnTimer);
+
+	// stop waiting on the mesh
+	if (MeshLoadHandle.IsValid())
+	{
+		MeshLoadHandle->CancelHandle();
+		MeshLoadHandle.Reset();
+	}
+
+	if (UGrimRailSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UGrimRailSignificanceSubsystem>())
+	{
+		Significance->UnregisterActor(this);
+	}
 }
 
 void AShooterPickup::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	// weapons are only granted by the server
+	if (!HasAuthority())
+	{
+		return;
+	}
+
 	// have we collided against a weapon holder?
 	if (IShooterWeaponHolder* WeaponHolder = Cast<IShooterWeaponHolder>(OtherActor))
 	{
@@ -81,8 +142,8 @@ void AShooterPickup::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor*
 		// disable collision
 		SetActorEnableCollision(false);
 
-		// disable ticking
-		SetActorTickEnabled(false);
+		// disable ticking while hidden
+		SetTickWork(false);
 
 		// schedule the respawn
 		GetWorld()->GetTimerManager().SetTimer(RespawnTimer, this, &AShooterPickup::RespawnPickup, RespawnTime, false);
@@ -104,5 +165,18 @@ void AShooterPickup::FinishRespawn()
 	SetActorEnableCollision(true);
 
 	// enable tick
-	SetActorTickEnabled(true);
+	SetTickWork(true);
+}
+
+void AShooterPickup::SetTickWork(bool bHasWork)
+{
+	// let the significance subsystem decide whether we're close enough to tick
+	if (UGrimRailSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UGrimRailSignificanceSubsystem>())
+	{
+		Significance->SetHasWork(this, bHasWork);
+
+	} else {
+
+		SetActorTickEnabled(bHasWork);
+	}
 }
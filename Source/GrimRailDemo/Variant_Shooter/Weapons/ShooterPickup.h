@@ -6,6 +6,7 @@
 #include "GameFramework/Actor.h"
 #include "Engine/DataTable.h"
 #include "Engine/StaticMesh.h"
+#include "Engine/StreamableManager.h"
 #include "ShooterPickup.generated.h"
 
 class USphereComponent;
@@ -61,6 +62,9 @@ protected:
 	/** Timer to respawn the pickup */
 	FTimerHandle RespawnTimer;
 
+	/** Pending load of the pickup mesh */
+	TSharedPtr<FStreamableHandle> MeshLoadHandle;
+
 public:	
 	
 	/** Constructor */
@@ -71,6 +75,9 @@ protected:
 	/** Native construction script */
 	virtual void OnConstruction(const FTransform& Transform) override;
 
+	/** Sets the pickup mesh once its async load is done */
+	void OnMeshLoaded();
+
 	/** Gameplay Initialization*/
 	virtual void BeginPlay() override;
 
@@ -93,4 +100,7 @@ protected:
 	/** Enables this pickup after respawning */
 	UFUNCTION(BlueprintCallable, Category="Pickup")
 	void FinishRespawn();
+
+	/** Turns ticking on or off, through the significance subsystem if there is one */
+	void SetTickWork(bool bHasWork);
 };
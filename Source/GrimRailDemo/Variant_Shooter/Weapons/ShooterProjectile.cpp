@@ -34,6 +34,9 @@ AShooterProjectile::AShooterProjectile()
 
 	// set the default damage type
 	HitDamageType = UDamageType::StaticClass();
+
+	// projectiles are replicated through the weapon's fire events, so they never need an actor channel
+	bReplicates = false;
 }
 
 void AShooterProjectile::BeginPlay()
@@ -65,20 +68,24 @@ void AShooterProjectile::NotifyHit(class UPrimitiveComponent* MyComp, AActor* Ot
 	// disable collision on the projectile
 	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
-	// make AI perception noise
-	MakeNoise(NoiseLoudness, GetInstigator(), GetActorLocation(), NoiseRange, NoiseTag);
-
-	if (bExplodeOnHit)
+	// cosmetic projectiles leave noise, damage and impulses to the server's projectile
+	if (!bCosmetic)
 	{
-		
-		// apply explosion damage centered on the projectile
-		ExplosionCheck(GetActorLocation());
+		// make AI perception noise
+		MakeNoise(NoiseLoudness, GetInstigator(), GetActorLocation(), NoiseRange, NoiseTag);
 
-	} else {
+		if (bExplodeOnHit)
+		{
 
-		// single hit projectile. Process the collided actor
-		ProcessHit(Other, OtherComp, Hit.ImpactPoint, -Hit.ImpactNormal);
+			// apply explosion damage centered on the projectile
+			ExplosionCheck(GetActorLocation());
 
+		} else {
+
+			// single hit projectile. Process the collided actor
+			ProcessHit(Other, OtherComp, Hit.ImpactPoint, -Hit.ImpactNormal);
+
+		}
 	}
 
 	// pass control to BP for any extra effects
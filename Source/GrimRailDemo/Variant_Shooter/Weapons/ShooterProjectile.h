@@ -13,6 +13,8 @@ class UPrimitiveComponent;
 
 /**
  *  Simple projectile class for a first person shooter game
+ *  Projectiles are never replicated. Weapons send compact fire events instead,
+ *  and clients spawn cosmetic copies that only play hit effects
  */
 UCLASS(abstract)
 class GRIMRAILDEMO_API AShooterProjectile : public AActor
@@ -68,6 +70,9 @@ protected:
 	/** If true, this projectile has already hit another surface */
 	bool bHit = false;
 
+	/** If true, this projectile only plays effects and never applies noise, damage or impulses */
+	bool bCosmetic = false;
+
 	/** How long to wait after a hit before destroying this projectile */
 	UPROPERTY(EditAnywhere, Category="Projectile|Destruction", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
 	float DeferredDestructionTime = 5.0f;
@@ -80,6 +85,9 @@ public:
 	/** Constructor */
 	AShooterProjectile();
 
+	/** Flags this projectile as cosmetic. Must be called before BeginPlay */
+	void SetCosmetic(bool bInCosmetic) { bCosmetic = bInCosmetic; }
+
 protected:
 	
 	/** Gameplay initialization */
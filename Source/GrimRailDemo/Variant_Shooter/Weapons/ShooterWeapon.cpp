@@ -11,6 +11,8 @@
 #include "Animation/AnimInstance.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "GameFramework/Pawn.h"
+#include "GrimRailRandomSubsystem.h"
+#include "GrimRailMemorySubsystem.h"
 
 AShooterWeapon::AShooterWeapon()
 {
@@ -27,6 +29,10 @@ AShooterWeapon::AShooterWeapon()
 	FirstPersonMesh->SetFirstPersonPrimitiveType(EFirstPersonPrimitiveType::FirstPerson);
 	FirstPersonMesh->bOnlyOwnerSee = true;
 
+	// only animate the weapon while it's on screen, and at a lower rate when it's small or far away
+	FirstPersonMesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	FirstPersonMesh->bEnableUpdateRateOptimizations = true;
+
 	// create the third person mesh
 	ThirdPersonMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("Third Person Mesh"));
 	ThirdPersonMesh->SetupAttachment(RootComponent);
@@ -34,6 +40,13 @@ AShooterWeapon::AShooterWeapon()
 	ThirdPersonMesh->SetCollisionProfileName(FName("NoCollision"));
 	ThirdPersonMesh->SetFirstPersonPrimitiveType(EFirstPersonPrimitiveType::WorldSpaceRepresentation);
 	ThirdPersonMesh->bOwnerNoSee = true;
+
+	ThirdPersonMesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	ThirdPersonMesh->bEnableUpdateRateOptimizations = true;
+
+	// replicate along with the owner so shots can be sent through this actor
+	bReplicates = true;
+	bNetUseOwnerRelevancy = true;
 }
 
 void AShooterWeapon::BeginPlay()
@@ -50,6 +63,15 @@ void AShooterWeapon::BeginPlay()
 	// fill the first ammo clip
 	CurrentBullets = MagazineSize;
 
+	// owners nobody sees in first person don't need the first person mesh at all.
+	// Keep the component so Blueprints can still reference it, but take it out of the tick and the scene
+	if (!WeaponOwner->UsesFirstPersonWeaponMesh())
+	{
+		FirstPersonMesh->SetComponentTickEnabled(false);
+		FirstPersonMesh->SetVisibility(false);
+		FirstPersonMesh->bNoSkeletonUpdate = true;
+	}
+
 	// attach the meshes to the owner
 	WeaponOwner->AttachWeaponMeshes(this);
 }
@@ -123,6 +145,11 @@ void AShooterWeapon::StopFiring()
 	GetWorld()->GetTimerManager().ClearTimer(RefireTimer);
 }
 
+void AShooterWeapon::RefillMagazine()
+{
+	CurrentBullets = MagazineSize;
+}
+
 void AShooterWeapon::Fire()
 {
 	// ensure the player still wants to fire. They may have let go of the trigger
@@ -163,15 +190,25 @@ void AShooterWeapon::FireProjectile(const FVector& TargetLocation)
 {
 	// get the projectile transform
 	FTransform ProjectileTransform = CalculateProjectileSpawnTransform(TargetLocation);
-	
-	// spawn the projectile
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-	SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::OverrideRootScale;
-	SpawnParams.Owner = GetOwner();
-	SpawnParams.Instigator = PawnOwner;
 
-	AShooterProjectile* Projectile = GetWorld()->SpawnActor<AShooterProjectile>(ProjectileClass, ProjectileTransform, SpawnParams);
+	// pack the shot so it can be sent without replicating the projectile
+	FShooterFireEvent FireEvent;
+	FireEvent.Origin = ProjectileTransform.GetLocation();
+	FireEvent.Direction = ProjectileTransform.GetRotation().GetForwardVector();
+
+	if (HasAuthority())
+	{
+		// spawn the projectile that deals damage and replay the shot on remote clients
+		SpawnProjectile(ProjectileTransform, false);
+		MulticastFire(FireEvent);
+
+	} else {
+
+		// predict the shot with a cosmetic projectile and let the server validate it
+		SpawnProjectile(ProjectileTransform, true);
+		ServerFire(FireEvent);
+
+	}
 
 	// play the firing montage
 	WeaponOwner->PlayFiringMontage(FiringMontage);
@@ -179,6 +216,26 @@ void AShooterWeapon::FireProjectile(const FVector& TargetLocation)
 	// add recoil
 	WeaponOwner->AddWeaponRecoil(FiringRecoil);
 
+	// consume bullets
+	ConsumeBullet();
+}
+
+void AShooterWeapon::SpawnProjectile(const FTransform& ProjectileTransform, bool bCosmetic)
+{
+	LLM_SCOPE_BYTAG(GrimRail_Projectiles);
+
+	// defer the spawn so the projectile knows whether it's cosmetic before it begins play
+	AShooterProjectile* Projectile = GetWorld()->SpawnActorDeferred<AShooterProjectile>(ProjectileClass, ProjectileTransform, GetOwner(), PawnOwner, ESpawnActorCollisionHandlingMethod::AlwaysSpawn, ESpawnActorScaleMethod::OverrideRootScale);
+
+	if (Projectile)
+	{
+		Projectile->SetCosmetic(bCosmetic);
+		Projectile->FinishSpawning(ProjectileTransform);
+	}
+}
+
+void AShooterWeapon::ConsumeBullet()
+{
 	// consume bullets
 	--CurrentBullets;
 
@@ -192,21 +249,91 @@ void AShooterWeapon::FireProjectile(const FVector& TargetLocation)
 	WeaponOwner->UpdateWeaponHUD(CurrentBullets, MagazineSize);
 }
 
+void AShooterWeapon::ServerFire_Implementation(const FShooterFireEvent& FireEvent)
+{
+	// drop shots that fail validation. The client only loses its cosmetic projectile
+	if (!IsValidServerShot(FireEvent))
+	{
+		return;
+	}
+
+	TimeOfLastServerShot = GetWorld()->GetTimeSeconds();
+
+	// spawn the projectile that deals damage. Hits are resolved by the server's projectile only
+	SpawnProjectile(FTransform(FireEvent.Direction.Rotation(), FireEvent.Origin, FVector::OneVector), false);
+
+	// replay the shot on the other clients
+	MulticastFire(FireEvent);
+
+	// make noise so the AI perception system can hear the shot
+	MakeNoise(ShotLoudness, PawnOwner, PawnOwner->GetActorLocation(), ShotNoiseRange, ShotNoiseTag);
+
+	// keep the server's bullet count in step with the client
+	ConsumeBullet();
+}
+
+void AShooterWeapon::MulticastFire_Implementation(const FShooterFireEvent& FireEvent)
+{
+	// the server and the predicting client already spawned their projectiles
+	if (HasAuthority() || !WeaponOwner || (PawnOwner && PawnOwner->IsLocallyControlled()))
+	{
+		return;
+	}
+
+	// replay the shot with a cosmetic projectile
+	SpawnProjectile(FTransform(FireEvent.Direction.Rotation(), FireEvent.Origin, FVector::OneVector), true);
+
+	// play the firing montage
+	WeaponOwner->PlayFiringMontage(FiringMontage);
+}
+
+bool AShooterWeapon::IsValidServerShot(const FShooterFireEvent& FireEvent) const
+{
+	// the weapon must be equipped. Inactive weapons, including those of dead owners, are hidden
+	if (!PawnOwner || IsHidden())
+	{
+		return false;
+	}
+
+	// enforce the refire rate
+	if (GetWorld()->GetTimeSeconds() - TimeOfLastServerShot < RefireRate * ServerRefireTolerance)
+	{
+		return false;
+	}
+
+	// the shot must start close to where the server thinks the owner is looking from
+	if (FVector::DistSquared(FireEvent.Origin, PawnOwner->GetPawnViewLocation()) > FMath::Square(MaxShotOriginError))
+	{
+		return false;
+	}
+
+	return !FireEvent.Direction.IsNearlyZero();
+}
+
 FTransform AShooterWeapon::CalculateProjectileSpawnTransform(const FVector& TargetLocation) const
 {
 	// find the muzzle location
-	const FVector MuzzleLoc = FirstPersonMesh->GetSocketLocation(MuzzleSocketName);
+	const FVector MuzzleLoc = GetMuzzleMesh()->GetSocketLocation(MuzzleSocketName);
 
 	// calculate the spawn location ahead of the muzzle
 	const FVector SpawnLoc = MuzzleLoc + ((TargetLocation - MuzzleLoc).GetSafeNormal() * MuzzleOffset);
 
+	// draw the spread from the weapon spread stream so seeded runs are reproducible
+	const FVector SpreadDir = UGrimRailRandomSubsystem::GetStream(GetWorld(), EGrimRailRandomStream::WeaponSpread).GetUnitVector();
+
 	// find the aim rotation vector while applying some variance to the target 
-	const FRotator AimRot = UKismetMathLibrary::FindLookAtRotation(SpawnLoc, TargetLocation + (UKismetMathLibrary::RandomUnitVector() * AimVariance));
+	const FRotator AimRot = UKismetMathLibrary::FindLookAtRotation(SpawnLoc, TargetLocation + (SpreadDir * AimVariance));
 
 	// return the built transform
 	return FTransform(AimRot, SpawnLoc, FVector::OneVector);
 }
 
+USkeletalMeshComponent* AShooterWeapon::GetMuzzleMesh() const
+{
+	// the first person mesh isn't posed for owners that don't use it
+	return (WeaponOwner && !WeaponOwner->UsesFirstPersonWeaponMesh()) ? ThirdPersonMesh : FirstPersonMesh;
+}
+
 const TSubclassOf<UAnimInstance>& AShooterWeapon::GetFirstPersonAnimInstanceClass() const
 {
 	return FirstPersonAnimInstanceClass;
@@ -6,6 +6,7 @@
 #include "GameFramework/Actor.h"
 #include "ShooterWeaponHolder.h"
 #include "Animation/AnimInstance.h"
+#include "Engine/NetSerialization.h"
 #include "ShooterWeapon.generated.h"
 
 class IShooterWeaponHolder;
@@ -14,11 +15,30 @@ class USkeletalMeshComponent;
 class UAnimMontage;
 class UAnimInstance;
 
+/**
+ *  Compact description of a single shot
+ *  Replicated in place of the projectile actor, which never gets its own actor channel
+ */
+USTRUCT()
+struct FShooterFireEvent
+{
+	GENERATED_BODY()
+
+	/** Projectile spawn location, rounded to 0.1 cm */
+	UPROPERTY()
+	FVector_NetQuantize10 Origin;
+
+	/** Projectile direction, packed to 16 bits per axis */
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction;
+};
+
 /**
  *  Base class for a simple first person shooter weapon
  *  Provides both first person and third person perspective meshes
  *  Handles ammo and firing logic
  *  Interacts with the weapon owner through the ShooterWeaponHolder interface
+ *  Owning clients predict their shots, the server validates them and replays them on the other clients
  */
 UCLASS(abstract)
 class GRIMRAILDEMO_API AShooterWeapon : public AActor
@@ -109,6 +129,17 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Perception")
 	FName ShotNoiseTag = FName("Shot");
 
+	/** Fraction of the refire rate that must pass between client shots for the server to accept them. Leaves room for network jitter */
+	UPROPERTY(EditAnywhere, Category="Network", meta = (ClampMin = 0, ClampMax = 1))
+	float ServerRefireTolerance = 0.8f;
+
+	/** Max distance between a client shot's origin and the owner's view location on the server */
+	UPROPERTY(EditAnywhere, Category="Network", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
+	float MaxShotOriginError = 200.0f;
+
+	/** Game time of the last client shot accepted by the server */
+	float TimeOfLastServerShot = TNumericLimits<float>::Lowest();
+
 public:	
 
 	/** Constructor */
@@ -142,6 +173,9 @@ public:
 	/** Stop firing this weapon */
 	void StopFiring();
 
+	/** Refills the current magazine */
+	void RefillMagazine();
+
 protected:
 
 	/** Fire the weapon */
@@ -156,6 +190,26 @@ protected:
 	/** Calculates the spawn transform for projectiles shot by this weapon */
 	FTransform CalculateProjectileSpawnTransform(const FVector& TargetLocation) const;
 
+	/** Returns the mesh projectiles are shot from, the first person mesh unless the owner doesn't use it */
+	USkeletalMeshComponent* GetMuzzleMesh() const;
+
+	/** Spawns a projectile. Cosmetic projectiles only play effects and never deal damage */
+	void SpawnProjectile(const FTransform& ProjectileTransform, bool bCosmetic);
+
+	/** Consumes a bullet, reloads the magazine if it's empty and updates the HUD */
+	void ConsumeBullet();
+
+	/** Sends a predicted shot to the server for validation */
+	UFUNCTION(Server, Reliable)
+	void ServerFire(const FShooterFireEvent& FireEvent);
+
+	/** Replays a shot on remote clients */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastFire(const FShooterFireEvent& FireEvent);
+
+	/** Returns true if the server should accept a shot sent by the owning client */
+	bool IsValidServerShot(const FShooterFireEvent& FireEvent) const;
+
 public:
 
 	/** Returns the first person mesh */
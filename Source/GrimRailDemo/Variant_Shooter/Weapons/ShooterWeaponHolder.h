@@ -26,6 +26,9 @@ class GRIMRAILDEMO_API IShooterWeaponHolder
 
 public:
 
+	/** Returns true if the owner is ever seen in first person and needs the weapon's first person mesh */
+	virtual bool UsesFirstPersonWeaponMesh() const = 0;
+
 	/** Attaches a weapon's meshes to the owner */
 	virtual void AttachWeaponMeshes(AShooterWeapon* Weapon) = 0;
 